@@ -17,36 +17,62 @@
 
 using namespace unreal_fluid::addons::physics;
 
+void PhysicsBody::setInertiaTensor(const mat3 &tensor) {
+  inertiaTensor = tensor;
+  inverseInertiaTensor = isStatic ? mat3::zero() : tensor.inversed();
+}
+
+mat3 PhysicsBody::getWorldInverseInertia() const {
+  return orientation * inverseInertiaTensor * orientation.transposed();
+}
+
 void PhysicsBody::applyForce(const vec3 &force, const vec3 &point) {
-  angularAcceleration += vec3::cross(point - position, force);
+  angularAcceleration += getWorldInverseInertia() * vec3::cross(point - position, force);
   acceleration += force * inverseMass;
 }
 
 void PhysicsBody::applyImpulse(const vec3 &impulse, const vec3 &point) {
-  angularVelocity += vec3::cross(point - position, impulse);
+  angularVelocity += getWorldInverseInertia() * vec3::cross(point - position, impulse);
   velocity += impulse * inverseMass;
 }
 
 void PhysicsBody::applyTorque(const vec3 &torque) {
-  angularAcceleration += torque;
+  angularAcceleration += getWorldInverseInertia() * torque;
 }
 
 void PhysicsBody::applyAngularImpulse(const vec3 &angularImpulse) {
-  angularVelocity += angularImpulse;
+  angularVelocity += getWorldInverseInertia() * angularImpulse;
 }
 
 void PhysicsBody::update(double dt) {
+  integrateVelocity(dt);
+  integratePosition(dt);
+}
+
+void PhysicsBody::integrateVelocity(double dt) {
   if (isStatic) {
     return;
   }
 
   velocity += acceleration * dt;
-  position += velocity * dt;
   acceleration = {0.0f, 0.0f, 0.0f};
 
   angularVelocity += angularAcceleration * dt;
-  rotation += angularVelocity * dt;
   angularAcceleration = {0.0f, 0.0f, 0.0f};
 }
 
+void PhysicsBody::integratePosition(double dt) {
+  if (isStatic) {
+    return;
+  }
+
+  position += velocity * dt;
+  rotation += angularVelocity * dt;
+
+  double speed = std::sqrt(angularVelocity.len2());
+  if (speed > 0) {
+    orientation = (mat3::rotation(speed * dt, angularVelocity / speed) * orientation).orthonormalized();
+  }
+}
+
 // end of PhysicsBody.cxx
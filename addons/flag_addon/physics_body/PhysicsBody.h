@@ -27,15 +27,15 @@ namespace unreal_fluid::addons::physics {
     vec3 angularVelocity{0.0f, 0.0f, 0.0f};
     vec3 angularAcceleration{0.0f, 0.0f, 0.0f};
 
+    mat3 orientation = mat3::identity(); // rotation from body to world space
+
     double mass = 1.0f;
     double inverseMass = 1.0f;
 
     bool isStatic = false;
 
-//    mat4 inertiaTensor{1.0f, 0.0f, 0.0f, 0.0f,
-//                       0.0f, 1.0f, 0.0f, 0.0f,
-//                       0.0f, 0.0f, 1.0f, 0.0f,
-//                       0.0f, 0.0f, 0.0f, 0.0f};
+    mat3 inertiaTensor = mat3::identity();        // in body space
+    mat3 inverseInertiaTensor = mat3::identity(); // in body space, zero for static bodies
 
     std::vector<vec3> vertices;
 
@@ -46,7 +46,14 @@ namespace unreal_fluid::addons::physics {
     /// @param mass Mass
     /// @attention If mass is -1 then the body is static
     PhysicsBody(vec3 point, double mass = 1) : position(point), mass(mass),
-                                               inverseMass(1.0f / mass), isStatic(mass == -1) {}
+                                               inverseMass(mass == -1 ? 0.0 : 1.0 / mass), isStatic(mass == -1) {}
+
+    /// @brief Sets inertia tensor of the body
+    /// @param tensor Inertia tensor in body space
+    void setInertiaTensor(const mat3 &tensor);
+
+    /// @brief Returns inverse inertia tensor rotated to world space
+    [[nodiscard]] mat3 getWorldInverseInertia() const;
 
     /// @brief Applies force to the body
     /// @param force Force
@@ -70,6 +77,14 @@ namespace unreal_fluid::addons::physics {
     /// @brief Updates position and rotation of the body
     /// @param dt Time interval
     void update(double dt);
+
+    /// @brief Adds accumulated accelerations to velocities, first half of update()
+    /// @param dt Time interval
+    void integrateVelocity(double dt);
+
+    /// @brief Moves and rotates the body with its velocities, second half of update()
+    /// @param dt Time interval
+    void integratePosition(double dt);
   };
 } // unreal_fluid::addons::physics
 
@@ -0,0 +1,104 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : FluidDamBreakBenchmark.cxx
+ * PURPOSE   : breaks a dam of SPH and PBF fluid in a box, measures step time and density error
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "../src/core/physics/Simulator.h"
+#include "../src/core/physics/fluid/pbf/PbfFluidContainer.h"
+#include "../src/core/physics/fluid/sph/SphFluidContainer.h"
+
+using namespace unreal_fluid;
+
+/// @brief logs mean and largest density of fluid relative to rest density, the fastest particle and
+/// particles which are lost: not finite or outside of the box
+template<typename Container>
+static void logState(const char *name, int frame, Container *container, const vec3 &boxMin, const vec3 &boxMax) {
+  const double restDensity = 1000;
+  const std::vector<double> &densities = container->getDensities();
+  physics::fluid::ParticleStorage &particles = container->getParticles();
+
+  double sum = 0, largest = 0;
+  for (double density: densities) {
+    sum += density;
+    largest = std::max(largest, density);
+  }
+
+  double fastest = 0;
+  size_t lost = 0;
+  vec3 origin = particles.getOrigin();
+  for (size_t particle = 0; particle < particles.size(); ++particle) {
+    vec3 position = vec3(particles.positions[particle]) + origin;
+    double speed = vec3(particles.velocities[particle]).len();
+    bool inside = position.x >= boxMin.x && position.y >= boxMin.y && position.z >= boxMin.z &&
+                  position.x <= boxMax.x && position.y <= boxMax.y && position.z <= boxMax.z;
+    if (!inside || !std::isfinite(speed)) lost++;
+    else fastest = std::max(fastest, speed);
+  }
+
+  Logger::logInfo(name, "frame:", frame, "mean density:", sum / double(densities.size()) / restDensity,
+                  "max density:", largest / restDensity, "max speed:", fastest, "lost particles:", lost);
+}
+
+/// @brief breaks a dam in the left part of a box and returns average time of one frame in seconds
+template<typename Container>
+static double run(const char *name, Container *container, int frames, double dt, unsigned threads) {
+  const vec3 boxMin(-0.5, -1, -0.25), boxMax(0.5, 1, 0.25);
+
+  container->setThreadsCount(threads);
+  container->setBounds(boxMin, boxMax);
+  container->fillBox({-0.5, -1, -0.25}, {-0.1, -0.4, 0.25});
+
+  physics::Simulator simulator;
+  simulator.addPhysicalObject(container);
+  Logger::logInfo(name, "particles:", container->getParticles().size());
+
+  double time = 0;
+  for (int frame = 1; frame <= frames; ++frame) {
+    utils::Timer timer;
+    simulator.simulate(dt);
+    time += timer.getElapsedTime();
+
+    if (frame % 20 == 0 || frame == frames) logState(name, frame, container, boxMin, boxMax);
+  }
+
+  return time / frames;
+}
+
+/// usage: fluid_dam_break_benchmark [particle radius] [frames] [threads] [dt]
+/// @details dt is 0.02 by default, the fixed step of the scene, PBF takes it without substeps
+int main(int argc, char **argv) {
+  double radius = argc > 1 ? std::atof(argv[1]) : 0.02;
+  int frames = argc > 2 ? std::atoi(argv[2]) : 120;
+  unsigned threads = argc > 3 ? unsigned(std::atoi(argv[3])) : 0;
+  double dt = argc > 4 ? std::atof(argv[4]) : 0.02;
+
+  Logger::logInfo("Dam break benchmark:", frames, "frames of", dt, "s");
+
+  auto *sph = new physics::fluid::SphFluidContainer({radius, 0});
+  double sphTime = run("SPH", sph, frames, dt, threads);
+  Logger::logInfo("SPH frame time (ms):", sphTime * 1000, "lag (s):", sph->getLagTime());
+
+  auto *pbf = new physics::fluid::PbfFluidContainer({radius, 0});
+  double pbfTime = run("PBF", pbf, frames, dt, threads);
+  Logger::logInfo("PBF frame time (ms):", pbfTime * 1000);
+
+  delete sph;
+  delete pbf;
+
+  return 0;
+}
+
+// end of FluidDamBreakBenchmark.cxx
@@ -0,0 +1,83 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : FluidScalingBenchmark.cxx
+ * PURPOSE   : measures speedup of fluid simulation from 1 to N threads, build with
+ *             UNREAL_FLUID_PHYSICS_FLOAT to measure single precision storage
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <cstdlib>
+
+#include "../src/core/physics/Simulator.h"
+#include "../src/core/physics/fluid/simple_fluid/SimpleFluidContainer.h"
+
+using namespace unreal_fluid;
+
+/// @brief fills cube of particles above the floor
+static void fillCube(physics::fluid::SimpleFluidContainer *container, int side, double radius) {
+  for (int x = 0; x < side; ++x)
+    for (int y = 0; y < side; ++y)
+      for (int z = 0; z < side; ++z) {
+        vec3 jitter = vec3(x * 7 % 5, y * 3 % 5, z * 11 % 5) * (radius * 0.05);
+        vec3 position = vec3(x - side / 2, y, z - side / 2) * (radius * 1.9) + jitter;
+        container->addParticle(position + vec3(0, -1 + radius, 0), {0, 0, 0}, radius, 1);
+      }
+}
+
+/// @brief runs simulation and returns average time of one step in seconds
+static double measure(unsigned threadsCount, int side, int steps) {
+  physics::Simulator simulator;
+  auto container = new physics::fluid::SimpleFluidContainer({});
+
+  container->setThreadsCount(threadsCount);
+  fillCube(container, side, 0.02);
+  simulator.addPhysicalObject(container);
+
+  /* warm up, lets grid and pool reach their working size */
+  simulator.simulate(0.02);
+
+  utils::Timer timer;
+  for (int step = 0; step < steps; ++step)
+    simulator.simulate(0.02);
+  double time = timer.getElapsedTime() / steps;
+
+  auto &neighbours = container->getNeighbours();
+  Logger::logInfo("neighbour lists built:", neighbours.getBuildsCount(), "reused:", neighbours.getReusesCount());
+
+  auto &particles = container->getParticles();
+  Logger::logInfo("particle storage (MB):", double(particles.getMemoryUsage()) / (1 << 20),
+                  "bytes per particle:", double(particles.getMemoryUsage()) / double(particles.size()),
+                  "particles:", particles.size(), "peak:", particles.getPeakSize());
+
+  delete container;
+  return time;
+}
+
+/// usage: fluid_scaling_benchmark [cube side] [steps] [max threads]
+int main(int argc, char **argv) {
+  int side = argc > 1 ? std::atoi(argv[1]) : 50;
+  int steps = argc > 2 ? std::atoi(argv[2]) : 20;
+  unsigned maxThreads = argc > 3 ? unsigned(std::atoi(argv[3])) : utils::ThreadPool::getHardwareThreadsCount();
+
+  Logger::logInfo("Fluid scaling benchmark:", side * side * side, "particles,", steps, "steps,",
+                  sizeof(physics::real) == sizeof(float) ? "single" : "double", "precision");
+
+  double singleThreadTime = 0;
+  for (unsigned threads = 1; threads <= maxThreads; threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2) {
+    double time = measure(threads, side, steps);
+    if (threads == 1) singleThreadTime = time;
+
+    Logger::logInfo("threads:", threads, "step time (ms):", time * 1000, "speedup:", singleThreadTime / time);
+  }
+
+  return 0;
+}
+
+// end of FluidScalingBenchmark.cxx
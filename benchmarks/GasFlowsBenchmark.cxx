@@ -0,0 +1,49 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : GasFlowsBenchmark.cxx
+ * PURPOSE   : steps a large 2D container of gas moved by pressure flows
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <cstdlib>
+
+#include "../src/core/physics/Simulator.h"
+#include "../src/core/physics/gas/GasContainer2D.h"
+
+using namespace unreal_fluid;
+
+/// usage: gas_flows_benchmark [side] [steps] [threads]
+int main(int argc, char **argv) {
+  int side = argc > 1 ? std::atoi(argv[1]) : 4096;
+  int steps = argc > 2 ? std::atoi(argv[2]) : 10;
+  unsigned threads = argc > 3 ? unsigned(std::atoi(argv[3])) : 0;
+  const double dt = 0.5;
+
+  /* gas in every other cell on average */
+  srand(1);
+  auto *container = new physics::gas::GasContainer2d(side, side, side * side / 2);
+  container->setThreadsCount(threads);
+
+  physics::Simulator simulator;
+  simulator.addPhysicalObject(container);
+
+  Logger::logInfo("Gas flows benchmark:", side, "x", side);
+
+  utils::Timer timer;
+  for (int step = 0; step < steps; ++step)
+    simulator.simulate(dt);
+  double stepping = timer.getElapsedTime();
+
+  double cells = double(side) * side;
+  Logger::logInfo("step (ms):", stepping * 1000 / steps, "time per cell (ns):", stepping * 1e9 / (steps * cells));
+  return 0;
+}
+
+// end of GasFlowsBenchmark.cxx
@@ -0,0 +1,91 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : GasPressureBenchmark.cxx
+ * PURPOSE   : solves the pressure equation of growing grids with every solver
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <cstdlib>
+#include <memory>
+#include <random>
+
+#include "../src/core/physics/gas/solver/JacobiSolver.h"
+#include "../src/core/physics/gas/solver/MultigridSolver.h"
+#include "../src/core/physics/gas/solver/PcgSolver.h"
+#include "../src/core/physics/gas/solver/RedBlackGaussSeidelSolver.h"
+#include "../src/utils/logger/Logger.h"
+
+using namespace unreal_fluid;
+using namespace unreal_fluid::physics::gas;
+
+/// usage: gas_pressure_benchmark [largest side] [max iterations] [tolerance] [threads] [slow solvers on large grids, 0 or 1]
+int main(int argc, char **argv) {
+  int largest = argc > 1 ? std::atoi(argv[1]) : 512;
+  PoissonSolverParameters parameters;
+  parameters.maxIterations = argc > 2 ? std::atoi(argv[2]) : 5000;
+  parameters.tolerance = argc > 3 ? std::atof(argv[3]) : 1e-4;
+  utils::ThreadPool pool(argc > 4 ? unsigned(std::atoi(argv[4])) : 0);
+  bool slowOnLargeGrids = argc > 5 && std::atoi(argv[5]) != 0;
+
+  /* Jacobi and Gauss-Seidel run out of iterations above this side, taking minutes without converging */
+  const int slowSolversLargest = 512;
+
+  struct Entry {
+    std::unique_ptr<IPoissonSolver> solver;
+    bool slow;
+  };
+  std::vector<Entry> solvers;
+  solvers.push_back({std::make_unique<JacobiSolver>(parameters), true});
+  solvers.push_back({std::make_unique<RedBlackGaussSeidelSolver>(parameters), true});
+  solvers.push_back({std::make_unique<PcgSolver>(parameters), false});
+  solvers.push_back({std::make_unique<MultigridSolver>(parameters), false});
+
+  for (int side = 64; side <= largest; side *= 2) {
+    PoissonGrid grid(side, side);
+
+    /* divergence of random face velocities with closed walls, it sums to zero as a real one does */
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> velocity(-1, 1);
+    std::vector<double> velocityX(grid.size(), 0), velocityY(grid.size(), 0), rhs(grid.size(), 0);
+    for (int row = 0; row < side; ++row)
+      for (int column = 0; column < side; ++column) {
+        if (column > 0) velocityX[grid.index(row, column)] = velocity(random);
+        if (row > 0) velocityY[grid.index(row, column)] = velocity(random);
+      }
+    for (int row = 0; row < side; ++row)
+      for (int column = 0; column < side; ++column) {
+        size_t cell = grid.index(row, column);
+        rhs[cell] = velocityX[cell + 1] - velocityX[cell] + velocityY[cell + grid.getStride()] - velocityY[cell];
+      }
+
+    Logger::logInfo("Grid", side, "x", side);
+    for (auto &[solver, slow] : solvers) {
+      if (slow && side > slowSolversLargest && !slowOnLargeGrids) {
+        Logger::logInfo("  ", solver->getName(), "skipped, pass 1 as the fifth argument to run it");
+        continue;
+      }
+
+      /* the first solve of a size builds levels or factors, the second one is measured */
+      for (int run = 0; run < 2; ++run) {
+        std::vector<double> pressure(grid.size(), 0);
+        solver->resetStatistics();
+        solver->solve(grid, pressure, rhs, pool);
+      }
+
+      auto &statistics = solver->getStatistics();
+      Logger::logInfo("  ", solver->getName(), "iterations:", statistics.lastIterations,
+                      "residual:", statistics.lastResidual, "time (ms):", statistics.lastTime * 1000,
+                      "time per cell (ns):", statistics.lastTime * 1e9 / (double(side) * side));
+    }
+  }
+  return 0;
+}
+
+// end of GasPressureBenchmark.cxx
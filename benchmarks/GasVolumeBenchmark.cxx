@@ -0,0 +1,81 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : GasVolumeBenchmark.cxx
+ * PURPOSE   : steps a plume of hot gas in a 3D container and copies it to texture buffers
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <cstdlib>
+#include <memory>
+
+#include "../src/core/physics/Simulator.h"
+#include "../src/core/physics/gas/GasContainer3D.h"
+#include "../src/core/physics/gas/solver/MultigridSolver.h"
+
+using namespace unreal_fluid;
+
+/// usage: gas_volume_benchmark [side] [steps] [threads] [pressure tolerance]
+int main(int argc, char **argv) {
+  int side = argc > 1 ? std::atoi(argv[1]) : 128;
+  int steps = argc > 2 ? std::atoi(argv[2]) : 20;
+  unsigned threads = argc > 3 ? unsigned(std::atoi(argv[3])) : 0;
+  double tolerance = argc > 4 ? std::atof(argv[4]) : physics::gas::PoissonSolverParameters{}.tolerance;
+  const double dt = 0.5;
+  const double interactiveRate = 30; // frames per second
+
+  auto *container = new physics::gas::GasContainer3d(side, side, side);
+  container->setThreadsCount(threads);
+  container->setPressureSolver(std::make_unique<physics::gas::MultigridSolver>(physics::gas::PoissonSolverParameters{200, tolerance}));
+
+  physics::Simulator simulator;
+  simulator.addPhysicalObject(container);
+
+  Logger::logInfo("Gas volume benchmark:", side, "x", side, "x", side);
+
+  /* the first step allocates scratch fields and levels of the pressure solver, it is not measured */
+  std::vector<float> colors, amounts;
+  double stepping = 0, copying = 0;
+  for (int step = 0; step <= steps; ++step) {
+    /* hot source at the bottom centre keeps the plume going */
+    for (int layer = side * 7 / 16; layer < side * 9 / 16; ++layer)
+      for (int column = side * 7 / 16; column < side * 9 / 16; ++column)
+        container->setGas(side / 8, column, layer, 50, {1, 0.6f, 0.3f}, 400);
+
+    utils::Timer timer;
+    simulator.simulate(dt);
+    double simulation = timer.getElapsedTime();
+
+    timer.reset();
+    container->copyVolume(colors, amounts, 1 / 100.0f);
+    double copy = timer.getElapsedTime();
+
+    if (step > 0) {
+      stepping += simulation;
+      copying += copy;
+    } else {
+      container->getPressureSolver().resetStatistics();
+    }
+  }
+
+  auto &statistics = container->getPressureSolver().getStatistics();
+  double cells = double(side) * side * side;
+  Logger::logInfo("step (ms):", stepping * 1000 / steps, "time per cell (ns):", stepping * 1e9 / (steps * cells),
+                  "copy to textures (ms):", copying * 1000 / steps);
+  Logger::logInfo("pressure (ms):", statistics.time * 1000 / statistics.solves, "iterations:",
+                  double(statistics.iterations) / statistics.solves, "share of step:", statistics.time / stepping);
+
+  /* a frame is one step and one copy */
+  double frameRate = steps / (stepping + copying);
+  Logger::logInfo("threads:", utils::ThreadPool::getHardwareThreadsCount(), "hardware,", threads, "requested,",
+                  "frames per second:", frameRate, frameRate >= interactiveRate ? "(interactive)" : "(below interactive rate)");
+  return 0;
+}
+
+// end of GasVolumeBenchmark.cxx
@@ -0,0 +1,96 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : MeshSdfBenchmark.cxx
+ * PURPOSE   : bakes distance grid of a tree mesh and pours fluid on it with triangles and with the grid
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <cstdlib>
+
+#include "../src/core/physics/Simulator.h"
+#include "../src/core/physics/boundary/MeshSdfBaker.h"
+#include "../src/core/physics/fluid/simple_fluid/SimpleFluidContainer.h"
+
+using namespace unreal_fluid;
+
+/// @brief fills cube of particles above the tree
+static void fillCube(physics::fluid::SimpleFluidContainer *container, int side, double radius) {
+  for (int x = 0; x < side; ++x)
+    for (int y = 0; y < side; ++y)
+      for (int z = 0; z < side; ++z) {
+        vec3 position = vec3(x - side / 2, y, z - side / 2) * (radius * 1.9);
+        container->addParticle(position + vec3(0, 0.1, 0), {0, 0, 0}, radius, 1);
+      }
+}
+
+/// @brief pours fluid on the mesh and returns average time of one step in seconds
+static double measure(physics::solid::SolidMesh &mesh, int side, int steps) {
+  physics::Simulator simulator;
+  auto container = new physics::fluid::SimpleFluidContainer({});
+  container->setThreadsCount(1);
+  fillCube(container, side, 0.02);
+  simulator.addPhysicalObject(container);
+  simulator.addPhysicalObject(&mesh);
+
+  /* fluid falls on the tree during the first steps, they are not measured */
+  for (int step = 0; step < 20; ++step)
+    simulator.simulate(0.01);
+  simulator.getBroadPhase().resetStatistics();
+
+  utils::Timer timer;
+  for (int step = 0; step < steps; ++step)
+    simulator.simulate(0.01);
+  double time = timer.getElapsedTime() / steps;
+
+  Logger::logInfo(mesh.getSdf() != nullptr ? "distance grid" : "triangles", "step time (ms):", time * 1000,
+                  "contacts per step:", double(simulator.getBroadPhase().getStatistics().contacts) / steps);
+
+  delete container;
+  return time;
+}
+
+/// usage: mesh_sdf_benchmark [cube side] [steps] [cell size] [cache directory]
+int main(int argc, char **argv) {
+  int side = argc > 1 ? std::atoi(argv[1]) : 20;
+  int steps = argc > 2 ? std::atoi(argv[2]) : 20;
+  double cellSize = argc > 3 ? std::atof(argv[3]) : 0.01;
+  const char *cacheDirectory = argc > 4 ? argv[4] : "cache/sdf";
+  const int bandCells = 4;
+
+  /* the tree is about one unit high and stands on the floor */
+  physics::solid::SolidMesh mesh("objects/lowpolytree.obj", {0, -0.62, 0}, 0.2);
+  Logger::logInfo("Mesh distance grid benchmark:", mesh.getTriangles().size(), "triangles,", side * side * side, "particles");
+
+  utils::ThreadPool pool;
+  for (unsigned threads = 1; threads <= utils::ThreadPool::getHardwareThreadsCount(); threads *= 2) {
+    pool.setThreadsCount(threads);
+
+    utils::Timer timer;
+    auto grid = physics::boundary::MeshSdfBaker::bake(mesh, cellSize, bandCells, pool);
+    Logger::logInfo("threads:", threads, "bake time (ms):", timer.getElapsedTime() * 1000, "nodes:",
+                    grid->getSizeX(), "x", grid->getSizeY(), "x", grid->getSizeZ());
+  }
+
+  /* the first load bakes the grid if the cache does not hold it yet, the second one reads it */
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    utils::Timer timer;
+    auto grid = physics::boundary::MeshSdfBaker::load(mesh, cellSize, bandCells, cacheDirectory, pool);
+    Logger::logInfo("load time (ms):", timer.getElapsedTime() * 1000);
+  }
+
+  double triangles = measure(mesh, side, steps);
+  mesh.setSdf(physics::boundary::MeshSdfBaker::load(mesh, cellSize, bandCells, cacheDirectory, pool));
+  double grid = measure(mesh, side, steps);
+  Logger::logInfo("speedup of distance grid:", triangles / grid);
+
+  return 0;
+}
+
+// end of MeshSdfBenchmark.cxx
@@ -0,0 +1,77 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : RigidDebrisBenchmark.cxx
+ * PURPOSE   : drops debris into a box and measures steps while it settles
+ *             and after it falls asleep
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <random>
+
+#include "../src/core/physics/Simulator.h"
+#include "../src/core/physics/boundary/AnalyticSdf.h"
+#include "../src/core/physics/rigid/RigidBodyWorld.h"
+
+using namespace unreal_fluid;
+
+/// usage: rigid_debris_benchmark [bodies] [threads] [seconds]
+int main(int argc, char **argv) {
+  int count = argc > 1 ? std::atoi(argv[1]) : 300;
+  unsigned threads = argc > 2 ? unsigned(std::atoi(argv[2])) : 0;
+  double seconds = argc > 3 ? std::atof(argv[3]) : 20;
+  const double dt = 1.0 / 120;
+
+  physics::rigid::RigidBodyWorld world;
+  world.setThreadsCount(threads);
+  world.getWalls().addContainer(std::make_unique<physics::boundary::SdfBox>(vec3(-1, 0, -1), vec3(1, 5, 1)));
+
+  /* half boxes and half balls, spinning and scattered over the height of the container */
+  std::mt19937 random(1);
+  std::uniform_real_distribution<double> side(-0.8, 0.8), height(0.2, 4);
+  for (int i = 0; i < count; ++i) {
+    vec3 position(side(random), height(random), side(random));
+    size_t body = i % 2 ? world.addBody(physics::rigid::RigidBody(position, 0.05 + 0.03 * std::abs(side(random)), 1))
+                        : world.addBody(physics::rigid::RigidBody(position, vec3(0.06, 0.04, 0.05), 1));
+    world.getBody(body).angularVelocity = vec3(side(random), side(random), side(random)) * 3;
+  }
+
+  physics::Simulator simulator;
+  simulator.addPhysicalObject(&world);
+
+  Logger::logInfo("Rigid debris benchmark:", count, "bodies");
+
+  int steps = int(seconds / dt);
+  double settled = -1;
+  utils::Timer timer;
+  for (int step = 0; step < steps; ++step) {
+    simulator.simulate(dt);
+
+    auto &statistics = world.getStatistics();
+    if (step % 240 == 0)
+      Logger::logInfo("time (s):", step * dt, "awake:", statistics.awakeBodies, "contacts:", statistics.contacts,
+                      "islands:", statistics.islands);
+    if (statistics.awakeBodies == 0 && settled < 0) settled = step * dt;
+  }
+  double settling = timer.getElapsedTime() / steps;
+
+  timer.reset();
+  for (int step = 0; step < steps; ++step)
+    simulator.simulate(dt);
+  double resting = timer.getElapsedTime() / steps;
+
+  Logger::logInfo("asleep after (s):", settled, "step while settling (ms):", settling * 1000,
+                  "step at rest (ms):", resting * 1000);
+  return 0;
+}
+
+// end of RigidDebrisBenchmark.cxx
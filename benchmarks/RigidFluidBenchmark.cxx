@@ -0,0 +1,74 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : RigidFluidBenchmark.cxx
+ * PURPOSE   : breaks a dam of fluid on a light box and a heavy ball, measures step time and how far they are pushed
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <cstdlib>
+#include <memory>
+
+#include "../src/core/physics/Simulator.h"
+#include "../src/core/physics/boundary/AnalyticSdf.h"
+#include "../src/core/physics/fluid/simple_fluid/SimpleFluidContainer.h"
+#include "../src/core/physics/rigid/RigidBodyWorld.h"
+
+using namespace unreal_fluid;
+
+/// usage: rigid_fluid_benchmark [dam side] [threads] [seconds]
+int main(int argc, char **argv) {
+  int side = argc > 1 ? std::atoi(argv[1]) : 20;
+  unsigned threads = argc > 2 ? unsigned(std::atoi(argv[2])) : 0;
+  double seconds = argc > 3 ? std::atof(argv[3]) : 3;
+  const double dt = 1.0 / 120;
+  const double radius = 0.02;
+
+  /* the fluid and the bodies share a box, the dam stands at its left wall */
+  vec3 boxMin(-0.6, -1, -0.2), boxMax(0.6, 1, 0.2);
+
+  auto fluid = std::make_unique<physics::fluid::SimpleFluidContainer>(physics::fluid::FluidDescriptor{radius, 1});
+  fluid->setThreadsCount(threads);
+  fluid->getWalls().addContainer(std::make_unique<physics::boundary::SdfBox>(boxMin, boxMax));
+  for (int x = 0; x < side / 2; ++x)
+    for (int y = 0; y < 2 * side; ++y)
+      for (int z = 0; z < side / 2; ++z)
+        fluid->addParticle(boxMin + vec3(x + 0.5, y + 0.5, z + 0.5) * (radius * 2), {0, 0, 0}, radius, 1);
+
+  /* the wave reaches the light box first, the heavy ball takes what the box and the fluid pass on */
+  physics::rigid::RigidBodyWorld world;
+  world.setThreadsCount(threads);
+  world.getWalls().addContainer(std::make_unique<physics::boundary::SdfBox>(boxMin, boxMax));
+  size_t box = world.addBody(physics::rigid::RigidBody(vec3(0.1, -0.95, 0), vec3(0.05, 0.05, 0.05), 2));
+  size_t ball = world.addBody(physics::rigid::RigidBody(vec3(0.35, -0.94, 0), 0.06, 60));
+
+  physics::Simulator simulator;
+  simulator.addPhysicalObject(fluid.get());
+  simulator.addPhysicalObject(&world);
+
+  Logger::logInfo("Rigid fluid benchmark:", fluid->getParticles().size(), "particles");
+
+  int steps = int(seconds / dt);
+  vec3 boxStart = world.getBody(box).position, ballStart = world.getBody(ball).position;
+  utils::Timer timer;
+  for (int step = 1; step <= steps; ++step) {
+    simulator.simulate(dt);
+
+    if (step % 60 == 0)
+      Logger::logInfo("time (s):", step * dt, "box at:", world.getBody(box).position.x, "ball at:", world.getBody(ball).position.x,
+                      "contacts per step:", double(simulator.getBroadPhase().getStatistics().contacts) / step);
+  }
+  double time = timer.getElapsedTime() / steps;
+
+  Logger::logInfo("step time (ms):", time * 1000, "box pushed by:", (world.getBody(box).position - boxStart).len(),
+                  "ball pushed by:", (world.getBody(ball).position - ballStart).len());
+  return 0;
+}
+
+// end of RigidFluidBenchmark.cxx
@@ -0,0 +1,89 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : SolidBroadPhaseBenchmark.cxx
+ * PURPOSE   : measures fluid-solid interaction with growing amount of obstacles,
+ *             with and without broad phase
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "../src/core/physics/Simulator.h"
+#include "../src/core/physics/fluid/simple_fluid/SimpleFluidContainer.h"
+#include "../src/core/physics/solid/sphere/SolidSphere.h"
+
+using namespace unreal_fluid;
+
+/// @brief fills cube of particles above the floor
+static void fillCube(physics::fluid::SimpleFluidContainer *container, int side, double radius) {
+  for (int x = 0; x < side; ++x)
+    for (int y = 0; y < side; ++y)
+      for (int z = 0; z < side; ++z) {
+        vec3 position = vec3(x - side / 2, y, z - side / 2) * (radius * 1.9);
+        container->addParticle(position + vec3(0, -1 + radius, 0), {0, 0, 0}, radius, 1);
+      }
+}
+
+/// @brief runs simulation and returns average time of one step in seconds
+static double measure(int side, int obstacles, int steps, bool broadPhase) {
+  physics::Simulator simulator;
+  auto container = new physics::fluid::SimpleFluidContainer({});
+  container->setThreadsCount(1);
+  fillCube(container, side, 0.02);
+  simulator.addPhysicalObject(container);
+
+  /* square field of small spheres on the floor, wider than the fluid */
+  std::vector<std::unique_ptr<physics::solid::SolidSphere>> spheres;
+  int row = int(std::ceil(std::sqrt(double(obstacles))));
+  for (int i = 0; i < obstacles; ++i) {
+    vec3 position = vec3(i % row - row / 2, 0, i / row - row / 2) * 0.1 + vec3(0, -1, 0);
+    spheres.push_back(std::make_unique<physics::solid::SolidSphere>(position, 0.03));
+    simulator.addPhysicalObject(spheres.back().get());
+  }
+
+  simulator.getBroadPhase().setEnabled(broadPhase);
+  simulator.simulate(0.01);
+  simulator.getBroadPhase().resetStatistics();
+
+  utils::Timer timer;
+  for (int step = 0; step < steps; ++step)
+    simulator.simulate(0.01);
+  double time = timer.getElapsedTime() / steps;
+
+  auto &statistics = simulator.getBroadPhase().getStatistics();
+  Logger::logInfo(broadPhase ? "broad phase" : "all particles", "obstacles:", obstacles, "step time (ms):", time * 1000,
+                  "candidates per obstacle:", double(statistics.candidates) / double(std::max<size_t>(statistics.queries, 1)),
+                  "contacts per obstacle:", double(statistics.contacts) / double(std::max<size_t>(statistics.queries, 1)));
+
+  delete container;
+  return time;
+}
+
+/// usage: solid_broad_phase_benchmark [cube side] [steps] [max obstacles]
+int main(int argc, char **argv) {
+  int side = argc > 1 ? std::atoi(argv[1]) : 30;
+  int steps = argc > 2 ? std::atoi(argv[2]) : 20;
+  int maxObstacles = argc > 3 ? std::atoi(argv[3]) : 400;
+
+  Logger::logInfo("Solid broad phase benchmark:", side * side * side, "particles,", steps, "steps");
+
+  for (int obstacles = 1; obstacles <= maxObstacles; obstacles *= 4) {
+    double brute = measure(side, obstacles, steps, false);
+    double grid = measure(side, obstacles, steps, true);
+    Logger::logInfo("obstacles:", obstacles, "speedup:", brute / grid);
+  }
+
+  return 0;
+}
+
+// end of SolidBroadPhaseBenchmark.cxx
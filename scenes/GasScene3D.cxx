@@ -0,0 +1,45 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : ultimate_py_project
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : GasScene3D.cxx
+ * PURPOSE   : scene for 3d gas simulation rendered through a volume texture
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "../src/core/Core.h"
+#include "../src/core/components/AbstractObject.h"
+#include "../src/core/components/scene/Scene.h"
+#include "../src/core/physics/gas/GasContainer3D.h"
+
+using namespace unreal_fluid;
+
+class GasScene3D : public Scene {
+public:
+  static constexpr int side = 64;
+
+  physics::gas::GasContainer3d *gas;
+
+  explicit GasScene3D(const compositor::SceneCompositor *compositor) : Scene(compositor) {
+    gas = new physics::gas::GasContainer3d(side, side, side);
+    objects.push_back(new AbstractObject(gas));
+    compositor->getSimulator()->addPhysicalObject(gas);
+
+    compositor->getRenderer()->camera.setPositionHard({0, 0, 2.5});
+    compositor->getRenderer()->camera.setDirection({0, 0, -1});
+  }
+
+  void update() override {
+    /* hot source at the bottom centre keeps the plume going */
+    for (int layer = side * 7 / 16; layer < side * 9 / 16; ++layer)
+      for (int column = side * 7 / 16; column < side * 9 / 16; ++column)
+        gas->setGas(side / 8, column, layer, 50, {1, 0.6f, 0.3f}, 400);
+
+    Scene::update();
+  }
+};
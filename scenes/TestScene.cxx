@@ -15,6 +15,7 @@
 #include "../src/core/Core.h"
 #include "../src/core/components/AbstractObject.h"
 #include "../src/core/components/scene/Scene.h"
+#include "../src/core/physics/fluid/emitter/PointEmitter.h"
 
 using namespace unreal_fluid;
 
@@ -27,6 +28,8 @@ public:
     objects.push_back(new AbstractObject(sphere));
    
     auto simpleFluid = new physics::fluid::SimpleFluidContainer({});
+    simpleFluid->addEmitter(std::make_unique<physics::fluid::PointEmitter>(
+            physics::fluid::EmitterDescriptor{500, 0.02, 1}, vec3(0.0005, 1, 0.0005)));
     objects.push_back(new AbstractObject(simpleFluid));
 
     for (auto &abstractObject: objects) {
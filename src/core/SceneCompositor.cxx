@@ -16,6 +16,7 @@
 
 #include "components/scene/Scene.h"
 #include "../scenes/GasScene2D.cxx"
+#include "../scenes/GasScene3D.cxx"
 #include "../scenes/SceneLoader.cxx"
 
 using namespace unreal_fluid::compositor;
@@ -41,6 +42,7 @@ void SceneCompositor::init() {
 
   loadScene<SceneLoader>();
 //  loadScene<GasScene2D>();
+//  loadScene<GasScene3D>();
 
   Logger::logInfo("SceneCompositor initialized!");
 }
@@ -14,6 +14,8 @@
 
 #include "AbstractObject.h"
 #include "../physics/gas/GasContainer2D.h"
+#include "../physics/gas/GasContainer3D.h"
+#include "../physics/rigid/RigidBodyWorld.h"
 #include "../physics/solid/mesh/SolidMesh.h"
 #include "../render/components/mesh/presets/Cube.h"
 #include "../src/core/render/components/material/MaterialPresets.h"
@@ -29,16 +31,10 @@ AbstractObject::AbstractObject(physics::fluid::FluidDescriptor descriptor) : phy
 
 AbstractObject::AbstractObject(physics::IPhysicalObject *physicalObject) : physicalObject(physicalObject) {}
 
-void parseGasContainer2d(physics::IPhysicalObject *container2D, std::vector<render::RenderObject *> &renderObjects) {
-  void *data = container2D->getData();
-  auto &cells = *static_cast<std::vector<std::vector<physics::gas::GasCell>> *>(data);
-
-  size_t height = cells.size();
-  if (height == 0)
-    return;
-
-  size_t width = cells.front().size();
-  if (width == 0)
+void parseGasContainer2d(const physics::gas::GasContainer2d &container2D, std::vector<render::RenderObject *> &renderObjects) {
+  auto height = size_t(container2D.getHeight());
+  auto width = size_t(container2D.getWidth());
+  if (height == 0 || width == 0)
     return;
 
   static std::vector<float> colors(0 * 0 * 3);
@@ -64,14 +60,14 @@ void parseGasContainer2d(physics::IPhysicalObject *container2D, std::vector<rend
   for (size_t y = 0; y < height; ++y) {
     size_t yOffset = y * width;
     for (size_t x = 0; x < width; ++x) {
-      const auto &cell = cells[y][x];
+      vec3f color = container2D.getColor(int(y), int(x));
       size_t arrayPosition = (yOffset + x) * 3;
 
-      colors[arrayPosition + 0] = cell.color.x;
-      colors[arrayPosition + 1] = cell.color.y;
-      colors[arrayPosition + 2] = cell.color.z;
+      colors[arrayPosition + 0] = color.x;
+      colors[arrayPosition + 1] = color.y;
+      colors[arrayPosition + 2] = color.z;
 
-      amountOfGas[yOffset + x] = cell.amountOfGas / 100.0;
+      amountOfGas[yOffset + x] = container2D.getAmount(int(y), int(x)) / 100.0;
     }
   }
 
@@ -79,34 +75,77 @@ void parseGasContainer2d(physics::IPhysicalObject *container2D, std::vector<rend
   renderObjects[0]->textures[1]->write(amountOfGas.data());
 }
 
+void parseGasContainer3d(physics::gas::GasContainer3d &container3D, std::vector<render::RenderObject *> &renderObjects) {
+  int height = container3D.getHeight();
+  int width = container3D.getWidth();
+  int depth = container3D.getDepth();
+
+  static std::vector<float> colors;
+  static std::vector<float> amountOfGas;
+
+  if (renderObjects.empty()) {
+    /* the shader marches through the unit cube, the model matrix gives it proportions of the container */
+    auto cube = render::mesh::Cube({1, 1, 1});
+    auto renderObject = new render::RenderObject;
+    float side = float(std::max({height, width, depth}));
+
+    renderObject->material = render::material::Debug();
+    renderObject->bakedMesh = std::make_unique<render::mesh::BakedMesh>(&cube);
+    renderObject->modelMatrix = mat4::scale(vec3f(float(width), float(height), float(depth)) * (1.5f / side));
+    renderObject->textures[0] = new unreal_fluid::render::Texture(width, height, depth,
+                                                                  (std::size_t)3, sizeof(float)); // color
+    renderObject->textures[1] = new unreal_fluid::render::Texture(width, height, depth,
+                                                                  (std::size_t)1, sizeof(float)); // amountOfGas
+    renderObject->shaderProgram = render::DefaultShaderManager::GetGasVolumeProgram();
+
+    renderObjects.push_back(renderObject);
+  }
+
+  container3D.copyVolume(colors, amountOfGas, 1 / 100.0f);
+
+  renderObjects[0]->textures[0]->write(colors.data());
+  renderObjects[0]->textures[1]->write(amountOfGas.data());
+}
+
 void AbstractObject::parse() {
   auto type = physicalObject->getType();
-  void *data = physicalObject->getData();
 
   switch (type) {
     using namespace physics;
-    case IPhysicalObject::Type::SIMPLE_FLUID_CONTAINER: {
-      auto &particles = *static_cast<std::vector<fluid::Particle *> *>(data);
-
-      for (size_t pos = 0; pos < particles.size(); ++pos) {
+    case IPhysicalObject::Type::SIMPLE_FLUID_CONTAINER:
+    case IPhysicalObject::Type::SPH_FLUID_CONTAINER:
+    case IPhysicalObject::Type::PBF_FLUID_CONTAINER: {
+      auto &particles = static_cast<fluid::IFluidContainer *>(physicalObject)->getParticles();
+
+      /* render objects follow particle ids, slots change when the container reorders particles */
+      for (uint32_t id = 0; id < particles.getIdsCount(); ++id) {
+        size_t pos = particles.getSlot(id);
+
+        /* ids of killed particles are reused later, until then their spheres are collapsed */
+        if (pos == fluid::ParticleStorage::noSlot) {
+          if (id < renderObjects.size()) renderObjects[id]->modelMatrix = mat4::scale({0, 0, 0});
+          continue;
+        }
 
-        if (pos >= renderObjects.size()) {
+        /* killed ids below this one may have no render object yet, they get collapsed ones */
+        while (id >= renderObjects.size()) {
           auto renderObject = new render::RenderObject;
 
           renderObject->material = render::material::Gold();
-          auto r = particles[pos]->radius;
+          auto r = particles.radii[pos];
           auto mesh = render::mesh::Sphere(float(r), unsigned(500 * r), unsigned(500 * r));
           renderObject->bakedMesh = std::make_unique<render::mesh::BakedMesh>(&mesh);
+          renderObject->modelMatrix = mat4::scale({0, 0, 0});
           renderObjects.push_back(renderObject);
         }
 
-        renderObjects[pos]
-                ->modelMatrix = mat4::translation(particles[pos]->position);
+        renderObjects[id]
+                ->modelMatrix = mat4::translation(particles.getPosition(pos));
       }
       break;
     }
     case IPhysicalObject::Type::SOLID_SPHERE: {
-      auto solidSphere = *static_cast<solid::SolidSphere *>(data);
+      auto &solidSphere = static_cast<solid::SolidSphere &>(*physicalObject);
 
       if (renderObjects.empty()) {
 
@@ -125,7 +164,7 @@ void AbstractObject::parse() {
     }
     case IPhysicalObject::Type::SOLID_MESH: {
 
-      auto &triangles = *static_cast<std::vector<solid::Triangle> *>(data);
+      auto &triangles = static_cast<solid::SolidMesh &>(*physicalObject).getTriangles();
 
       for (size_t pos = renderObjects.size(); pos < triangles.size(); ++pos) {
         const auto &triangle = triangles[pos];
@@ -147,7 +186,45 @@ void AbstractObject::parse() {
       break;
     }
     case IPhysicalObject::Type::GAS_CONTAINER_2D: {
-      parseGasContainer2d(physicalObject, renderObjects);
+      parseGasContainer2d(static_cast<gas::GasContainer2d &>(*physicalObject), renderObjects);
+      break;
+    }
+    case IPhysicalObject::Type::GAS_CONTAINER_3D: {
+      parseGasContainer3d(static_cast<gas::GasContainer3d &>(*physicalObject), renderObjects);
+      break;
+    }
+    case IPhysicalObject::Type::RIGID_BODY_WORLD: {
+      auto &bodies = static_cast<rigid::RigidBodyWorld &>(*physicalObject).getBodies();
+
+      for (size_t pos = renderObjects.size(); pos < bodies.size(); ++pos) {
+        const auto &body = bodies[pos];
+        auto renderObject = new render::RenderObject;
+
+        if (body.isStatic)
+          renderObject->material = render::material::Silver();
+        else
+          renderObject->material = render::material::Bronze();
+
+        if (body.shape == rigid::RigidBody::Shape::SPHERE) {
+          auto r = body.radius;
+          auto mesh = render::mesh::Sphere(float(r), unsigned(500 * r), unsigned(500 * r));
+          renderObject->bakedMesh = std::make_unique<render::mesh::BakedMesh>(&mesh);
+        } else {
+          auto mesh = render::mesh::Cube(vec3f(body.halfExtents * 2));
+          renderObject->bakedMesh = std::make_unique<render::mesh::BakedMesh>(&mesh);
+        }
+        renderObjects.push_back(renderObject);
+      }
+
+      /* model matrices multiply row vectors, so the rotation goes in transposed */
+      for (size_t pos = 0; pos < bodies.size(); ++pos) {
+        const mat3 &r = bodies[pos].orientation;
+        mat4 rotation(r(0, 0), r(1, 0), r(2, 0), 0,
+                      r(0, 1), r(1, 1), r(2, 1), 0,
+                      r(0, 2), r(1, 2), r(2, 2), 0,
+                      0, 0, 0, 1);
+        renderObjects[pos]->modelMatrix = rotation.withTranslation(bodies[pos].position);
+      }
       break;
     }
     case IPhysicalObject::Type::DEFAULT: {
@@ -259,6 +259,23 @@ ShaderProgram *DefaultShaderManager::GetGasProgram() {
   return program;
 }
 
+ShaderProgram *DefaultShaderManager::GetGasVolumeProgram() {
+  static ShaderProgram *program = nullptr;
+
+  if (program != nullptr)
+    return program;
+
+  program = _instance.LoadProgram("gas_volume/");
+
+  if (program == nullptr)
+    Logger::logFatal("DefaultShaderManager : Gas volume program is not loaded!",
+                     "It can cause a segmentation fault, so the program will be closed!");
+
+  Logger::logInfo("DefaultShaderManager : Gas volume program is loaded!");
+
+  return program;
+}
+
 void DefaultShaderManager::ReloadShaders() {
   static_cast<ShaderManager &>(_instance).ReloadShaders();
 }
@@ -90,6 +90,10 @@ namespace unreal_fluid::render {
     /// @return Default gas program
     static ShaderProgram * GetGasProgram();
 
+    /// Get default gas volume program
+    /// @return Default gas volume program
+    static ShaderProgram * GetGasVolumeProgram();
+
     /// Reload all shaders
     static void ReloadShaders();
   };
@@ -0,0 +1,40 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : BroadPhase.cxx
+ * PURPOSE   : particles which may touch solids
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "BroadPhase.h"
+
+using namespace unreal_fluid::physics;
+
+void BroadPhase::update(const fluid::ParticleStorage &particles) {
+  if (enabled) grid.update(particles);
+}
+
+const std::vector<uint32_t> &BroadPhase::query(const fluid::ParticleStorage &particles, const solid::Aabb &box) {
+  candidates.clear();
+
+  if (!enabled) {
+    for (uint32_t particle = 0; particle < particles.size(); ++particle)
+      candidates.push_back(particle);
+  } else if (!box.empty()) {
+    /* grid is built over positions relative to the origin of storage */
+    const vec3 &origin = particles.getOrigin();
+    grid.forEachParticleInBox(box.min - origin, box.max - origin, [&](uint32_t particle) { candidates.push_back(particle); });
+  }
+
+  statistics.queries++;
+  statistics.candidates += candidates.size();
+  return candidates;
+}
+
+// end of BroadPhase.cxx
@@ -0,0 +1,110 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : BroadPhase.h
+ * PURPOSE   : particles which may touch solids
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "fluid/SpatialGrid.h"
+#include "solid/Aabb.h"
+
+namespace unreal_fluid::physics {
+  /// @brief Finds particles of a fluid near solids.
+  /// @details Particles are put into a spatial grid once per step, then every solid looks up
+  /// the cells its bounding box overlaps. Cost of a solid depends on particles around it,
+  /// not on all particles, so scenes with many small obstacles scale with their contacts.
+  /// When disabled every particle is reported for every solid, as without a broad phase.
+  class BroadPhase {
+  public:
+    /// @brief particles reported to solids and particles which actually touched them since reset
+    struct Statistics {
+      size_t queries = 0;
+      size_t candidates = 0;
+      size_t contacts = 0;
+    };
+
+  private:
+    fluid::SpatialGrid grid;
+    std::vector<uint32_t> candidates;
+    Statistics statistics;
+    bool enabled = true;
+
+  public:
+    BroadPhase() = default;
+    ~BroadPhase() = default;
+
+    /// @brief turns the grid on or off, off is useful to compare with testing every particle
+    void setEnabled(bool isEnabled) { enabled = isEnabled; }
+
+    /// @brief distributes particles over the grid, must be called after particles moved
+    void update(const fluid::ParticleStorage &particles);
+
+    /// @brief returns slots of particles which may touch the box
+    /// @details result is valid until the next query
+    /// @param box box in world coordinates
+    const std::vector<uint32_t> &query(const fluid::ParticleStorage &particles, const solid::Aabb &box);
+
+    /// @brief calls callback(indices, count, reach) for particles which may touch the box, grouped by grid cells
+    /// @details Particles of one cell are reported at once with the world box they can reach, so a solid
+    /// made of many primitives looks up primitives once per cell instead of once per particle.
+    /// Big particles are reported one by one, a disabled broad phase reports all particles in one group.
+    /// @param box box in world coordinates
+    template<typename Callback>
+    void forEachBatch(const fluid::ParticleStorage &particles, const solid::Aabb &box, Callback &&callback) {
+      statistics.queries++;
+      if (box.empty()) return;
+
+      if (!enabled) {
+        candidates.clear();
+        for (uint32_t particle = 0; particle < particles.size(); ++particle)
+          candidates.push_back(particle);
+
+        statistics.candidates += candidates.size();
+        if (!candidates.empty()) callback(candidates.data(), candidates.size(), box);
+        return;
+      }
+
+      const vec3 &origin = particles.getOrigin();
+      const std::vector<uint32_t> &sorted = grid.getSortedIndices();
+      double cellSize = grid.getCellSize();
+      vec3 margin = vec3(1, 1, 1) * (cellSize / 2);
+
+      grid.forEachCellInBox(box.min - origin, box.max - origin, [&](const fluid::SpatialGrid::Cell &cell) {
+        vec3 corner = origin + vec3(cell.x, cell.y, cell.z) * cellSize;
+        solid::Aabb reach(corner - margin, corner + vec3(1, 1, 1) * cellSize + margin);
+
+        statistics.candidates += cell.end - cell.begin;
+        callback(sorted.data() + cell.begin, size_t(cell.end - cell.begin), reach);
+      });
+
+      grid.forEachBigParticleInBox(box.min - origin, box.max - origin, [&](uint32_t particle) {
+        vec3 extent = vec3(1, 1, 1) * double(particles.radii[particle]);
+        solid::Aabb reach(particles.getPosition(particle) - extent, particles.getPosition(particle) + extent);
+
+        statistics.candidates++;
+        callback(&particle, size_t(1), reach);
+      });
+    }
+
+    /// @brief counts particles which touched the solid of the last query
+    void addContacts(size_t count) { statistics.contacts += count; }
+
+    [[nodiscard]] const Statistics &getStatistics() const { return statistics; }
+
+    void resetStatistics() { statistics = {}; }
+  };
+} // namespace unreal_fluid::physics
+
+// end of BroadPhase.h
@@ -0,0 +1,45 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : CollisionDispatcher.cxx
+ * PURPOSE   : table of collision handlers keyed by types of objects
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "CollisionDispatcher.h"
+
+using namespace unreal_fluid::physics;
+
+const CollisionDispatcher::Handler *CollisionDispatcher::find(Type first, Type second) {
+  auto handler = handlers.find({first, second});
+  if (handler != handlers.end()) return &handler->second;
+
+  if (reported.insert({first, second}).second)
+    Logger::logWarning("No collision handler for", getTypeName(first), "and", getTypeName(second), "- they do not interact");
+
+  return nullptr;
+}
+
+const char *CollisionDispatcher::getTypeName(Type type) {
+  switch (type) {
+    case Type::DEFAULT: return "DEFAULT";
+    case Type::SOLID_SPHERE: return "SOLID_SPHERE";
+    case Type::SOLID_MESH: return "SOLID_MESH";
+    case Type::SOLID_QUBE: return "SOLID_QUBE";
+    case Type::SIMPLE_FLUID_CONTAINER: return "SIMPLE_FLUID_CONTAINER";
+    case Type::SPH_FLUID_CONTAINER: return "SPH_FLUID_CONTAINER";
+    case Type::PBF_FLUID_CONTAINER: return "PBF_FLUID_CONTAINER";
+    case Type::GAS_CONTAINER_2D: return "GAS_CONTAINER_2D";
+    case Type::GAS_CONTAINER_3D: return "GAS_CONTAINER_3D";
+    case Type::RIGID_BODY_WORLD: return "RIGID_BODY_WORLD";
+  }
+  return "UNKNOWN";
+}
+
+// end of CollisionDispatcher.cxx
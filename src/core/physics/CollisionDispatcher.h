@@ -0,0 +1,62 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : CollisionDispatcher.h
+ * PURPOSE   : table of collision handlers keyed by types of objects
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+
+#include "IPhysicalObject.h"
+
+namespace unreal_fluid::physics {
+  /// @brief Collision handlers for pairs of object types.
+  /// @details A handler is registered with classes of both objects and receives them already cast,
+  /// so it works with whole typed containers and may batch internally. Handlers are looked up once
+  /// per pair of objects when objects are added to the scene, not every step.
+  /// Pairs of types without a handler are reported once.
+  class CollisionDispatcher {
+  public:
+    using Type = IPhysicalObject::Type;
+    using Handler = std::function<void(IPhysicalObject &, IPhysicalObject &)>;
+
+  private:
+    std::map<std::pair<Type, Type>, Handler> handlers;
+    std::set<std::pair<Type, Type>> reported;
+
+  public:
+    CollisionDispatcher() = default;
+    ~CollisionDispatcher() = default;
+
+    /// @brief registers handler of objects of given types, replaces a previous one
+    /// @param handler called as handler(First &, Second &)
+    template<typename First, typename Second, typename Callback>
+    void add(Type first, Type second, Callback handler) {
+      handlers[{first, second}] = [handler = std::move(handler)](IPhysicalObject &a, IPhysicalObject &b) {
+        handler(static_cast<First &>(a), static_cast<Second &>(b));
+      };
+    }
+
+    /// @brief returns handler of given types, the pointer stays valid while the dispatcher lives
+    /// @details missing handlers are logged the first time they are asked for
+    /// @return nullptr if there is no handler
+    const Handler *find(Type first, Type second);
+
+    /// @brief returns name of the type for messages
+    static const char *getTypeName(Type type);
+  };
+} // namespace unreal_fluid::physics
+
+// end of CollisionDispatcher.h
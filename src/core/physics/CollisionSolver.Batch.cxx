@@ -0,0 +1,332 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : CollisionSolver.Batch.cxx
+ * PURPOSE   : Batched particle collision kernels
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "CollisionSolver.h"
+#include "../../utils/cpu/CpuFeatures.h"
+
+#ifdef UNREAL_FLUID_X86_64
+#include <immintrin.h>
+#endif
+
+using namespace unreal_fluid::physics;
+
+namespace {
+  using unreal_fluid::utils::CpuFeatures;
+  using fluid::ParticleStorage;
+
+  static_assert(sizeof(vec3r) == 3 * sizeof(real), "kernels read vec3r columns as plain arrays of reals");
+
+  void solveScalar(ParticleStorage &particles, const uint32_t *first, const uint32_t *second, size_t count, double k) {
+    for (size_t pair = 0; pair < count; ++pair)
+      CollisionSolver::particleWithParticleCollision(particles, first[pair], second[pair], k);
+  }
+
+  /// @brief applies results of one vector group to touching lanes
+  /// @details lanes are applied one by one, so pairs sharing a particle inside a group add up
+  template<int lanes>
+  void applyLanes(ParticleStorage &particles, const uint32_t *first, const uint32_t *second, unsigned mask,
+                  const real (&normal)[3][lanes], const real (&push)[2][lanes], const real (&momentum)[2][lanes]) {
+    auto *positions = reinterpret_cast<real *>(particles.positions.data());
+    auto *velocities = reinterpret_cast<real *>(particles.velocities.data());
+
+    for (int lane = 0; lane < lanes; ++lane) {
+      if ((mask & (1u << lane)) == 0) continue;
+
+      size_t p1 = size_t(first[lane]) * 3, p2 = size_t(second[lane]) * 3;
+      for (int axis = 0; axis < 3; ++axis) {
+        positions[p1 + axis] += normal[axis][lane] * push[0][lane];
+        positions[p2 + axis] -= normal[axis][lane] * push[1][lane];
+        velocities[p1 + axis] -= normal[axis][lane] * momentum[0][lane];
+        velocities[p2 + axis] += normal[axis][lane] * momentum[1][lane];
+      }
+    }
+  }
+
+#if defined(UNREAL_FLUID_X86_64) && defined(UNREAL_FLUID_PHYSICS_FLOAT)
+  /* single precision kernels resolve twice as many pairs per instruction and gather by 32-bit indices */
+
+  UNREAL_FLUID_TARGET_AVX2
+  void solveAvx2(ParticleStorage &particles, const uint32_t *first, const uint32_t *second, size_t count, double k) {
+    const auto *positions = reinterpret_cast<const float *>(particles.positions.data());
+    const auto *velocities = reinterpret_cast<const float *>(particles.velocities.data());
+    const float *radii = particles.radii.data();
+    const float *masses = particles.masses.data();
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1);
+    const __m256 restitution = _mm256_set1_ps(float(1 + k));
+
+    size_t pair = 0;
+    for (; pair + 8 <= count; pair += 8) {
+      __m256i index1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first + pair));
+      __m256i index2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(second + pair));
+      __m256i offset1 = _mm256_add_epi32(_mm256_slli_epi32(index1, 1), index1);
+      __m256i offset2 = _mm256_add_epi32(_mm256_slli_epi32(index2, 1), index2);
+
+      __m256 dx = _mm256_sub_ps(_mm256_i32gather_ps(positions, offset1, 4), _mm256_i32gather_ps(positions, offset2, 4));
+      __m256 dy = _mm256_sub_ps(_mm256_i32gather_ps(positions + 1, offset1, 4), _mm256_i32gather_ps(positions + 1, offset2, 4));
+      __m256 dz = _mm256_sub_ps(_mm256_i32gather_ps(positions + 2, offset1, 4), _mm256_i32gather_ps(positions + 2, offset2, 4));
+      __m256 radius = _mm256_add_ps(_mm256_i32gather_ps(radii, index1, 4), _mm256_i32gather_ps(radii, index2, 4));
+
+      __m256 len2 = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+      __m256 touching = _mm256_and_ps(_mm256_cmp_ps(len2, _mm256_mul_ps(radius, radius), _CMP_LE_OQ),
+                                      _mm256_cmp_ps(len2, zero, _CMP_GT_OQ));
+      auto mask = unsigned(_mm256_movemask_ps(touching));
+      if (mask == 0) continue;
+
+      __m256 mass1 = _mm256_i32gather_ps(masses, index1, 4);
+      __m256 mass2 = _mm256_i32gather_ps(masses, index2, 4);
+      __m256 len = _mm256_sqrt_ps(_mm256_blendv_ps(one, len2, touching));
+      __m256 inverseLen = _mm256_div_ps(one, len);
+      __m256 inverseMass = _mm256_div_ps(one, _mm256_add_ps(mass1, mass2));
+
+      __m256 nx = _mm256_mul_ps(dx, inverseLen);
+      __m256 ny = _mm256_mul_ps(dy, inverseLen);
+      __m256 nz = _mm256_mul_ps(dz, inverseLen);
+
+      __m256 dvx = _mm256_sub_ps(_mm256_i32gather_ps(velocities, offset1, 4), _mm256_i32gather_ps(velocities, offset2, 4));
+      __m256 dvy = _mm256_sub_ps(_mm256_i32gather_ps(velocities + 1, offset1, 4), _mm256_i32gather_ps(velocities + 1, offset2, 4));
+      __m256 dvz = _mm256_sub_ps(_mm256_i32gather_ps(velocities + 2, offset1, 4), _mm256_i32gather_ps(velocities + 2, offset2, 4));
+      __m256 relative = _mm256_fmadd_ps(dvx, nx, _mm256_fmadd_ps(dvy, ny, _mm256_mul_ps(dvz, nz)));
+
+      __m256 push = _mm256_mul_ps(_mm256_sub_ps(radius, len), inverseMass);
+      __m256 momentum = _mm256_mul_ps(_mm256_mul_ps(restitution, relative), inverseMass);
+
+      alignas(32) float normal[3][8], pushes[2][8], momenta[2][8];
+      _mm256_store_ps(normal[0], nx);
+      _mm256_store_ps(normal[1], ny);
+      _mm256_store_ps(normal[2], nz);
+      _mm256_store_ps(pushes[0], _mm256_mul_ps(push, mass2));
+      _mm256_store_ps(pushes[1], _mm256_mul_ps(push, mass1));
+      _mm256_store_ps(momenta[0], _mm256_mul_ps(momentum, mass2));
+      _mm256_store_ps(momenta[1], _mm256_mul_ps(momentum, mass1));
+
+      applyLanes<8>(particles, first + pair, second + pair, mask, normal, pushes, momenta);
+    }
+
+    solveScalar(particles, first + pair, second + pair, count - pair, k);
+  }
+
+  UNREAL_FLUID_TARGET_AVX512
+  void solveAvx512(ParticleStorage &particles, const uint32_t *first, const uint32_t *second, size_t count, double k) {
+    const auto *positions = reinterpret_cast<const float *>(particles.positions.data());
+    const auto *velocities = reinterpret_cast<const float *>(particles.velocities.data());
+    const float *radii = particles.radii.data();
+    const float *masses = particles.masses.data();
+
+    /* unmasked forms start from an undefined register, which GCC reports as maybe uninitialized */
+    const __mmask16 all = 0xffff;
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 one = _mm512_set1_ps(1);
+    const __m512 restitution = _mm512_set1_ps(float(1 + k));
+
+    size_t pair = 0;
+    for (; pair + 16 <= count; pair += 16) {
+      __m512i index1 = _mm512_loadu_si512(first + pair);
+      __m512i index2 = _mm512_loadu_si512(second + pair);
+      __m512i offset1 = _mm512_add_epi32(_mm512_add_epi32(index1, index1), index1);
+      __m512i offset2 = _mm512_add_epi32(_mm512_add_epi32(index2, index2), index2);
+
+      __m512 dx = _mm512_sub_ps(_mm512_mask_i32gather_ps(zero, all, offset1, positions, 4), _mm512_mask_i32gather_ps(zero, all, offset2, positions, 4));
+      __m512 dy = _mm512_sub_ps(_mm512_mask_i32gather_ps(zero, all, offset1, positions + 1, 4), _mm512_mask_i32gather_ps(zero, all, offset2, positions + 1, 4));
+      __m512 dz = _mm512_sub_ps(_mm512_mask_i32gather_ps(zero, all, offset1, positions + 2, 4), _mm512_mask_i32gather_ps(zero, all, offset2, positions + 2, 4));
+      __m512 radius = _mm512_add_ps(_mm512_mask_i32gather_ps(zero, all, index1, radii, 4), _mm512_mask_i32gather_ps(zero, all, index2, radii, 4));
+
+      __m512 len2 = _mm512_fmadd_ps(dx, dx, _mm512_fmadd_ps(dy, dy, _mm512_mul_ps(dz, dz)));
+      __mmask16 touching = _mm512_cmp_ps_mask(len2, _mm512_mul_ps(radius, radius), _CMP_LE_OQ) &
+                           _mm512_cmp_ps_mask(len2, zero, _CMP_GT_OQ);
+      if (touching == 0) continue;
+
+      __m512 mass1 = _mm512_mask_i32gather_ps(one, touching, index1, masses, 4);
+      __m512 mass2 = _mm512_mask_i32gather_ps(one, touching, index2, masses, 4);
+      __m512 len = _mm512_mask_sqrt_ps(one, touching, len2);
+      __m512 inverseLen = _mm512_div_ps(one, len);
+      __m512 inverseMass = _mm512_div_ps(one, _mm512_add_ps(mass1, mass2));
+
+      __m512 nx = _mm512_mul_ps(dx, inverseLen);
+      __m512 ny = _mm512_mul_ps(dy, inverseLen);
+      __m512 nz = _mm512_mul_ps(dz, inverseLen);
+
+      __m512 dvx = _mm512_sub_ps(_mm512_mask_i32gather_ps(zero, touching, offset1, velocities, 4), _mm512_mask_i32gather_ps(zero, touching, offset2, velocities, 4));
+      __m512 dvy = _mm512_sub_ps(_mm512_mask_i32gather_ps(zero, touching, offset1, velocities + 1, 4), _mm512_mask_i32gather_ps(zero, touching, offset2, velocities + 1, 4));
+      __m512 dvz = _mm512_sub_ps(_mm512_mask_i32gather_ps(zero, touching, offset1, velocities + 2, 4), _mm512_mask_i32gather_ps(zero, touching, offset2, velocities + 2, 4));
+      __m512 relative = _mm512_fmadd_ps(dvx, nx, _mm512_fmadd_ps(dvy, ny, _mm512_mul_ps(dvz, nz)));
+
+      __m512 push = _mm512_mul_ps(_mm512_sub_ps(radius, len), inverseMass);
+      __m512 momentum = _mm512_mul_ps(_mm512_mul_ps(restitution, relative), inverseMass);
+
+      alignas(64) float normal[3][16], pushes[2][16], momenta[2][16];
+      _mm512_store_ps(normal[0], nx);
+      _mm512_store_ps(normal[1], ny);
+      _mm512_store_ps(normal[2], nz);
+      _mm512_store_ps(pushes[0], _mm512_mul_ps(push, mass2));
+      _mm512_store_ps(pushes[1], _mm512_mul_ps(push, mass1));
+      _mm512_store_ps(momenta[0], _mm512_mul_ps(momentum, mass2));
+      _mm512_store_ps(momenta[1], _mm512_mul_ps(momentum, mass1));
+
+      applyLanes<16>(particles, first + pair, second + pair, touching, normal, pushes, momenta);
+    }
+
+    solveScalar(particles, first + pair, second + pair, count - pair, k);
+  }
+#elif defined(UNREAL_FLUID_X86_64)
+  UNREAL_FLUID_TARGET_AVX2
+  void solveAvx2(ParticleStorage &particles, const uint32_t *first, const uint32_t *second, size_t count, double k) {
+    const auto *positions = reinterpret_cast<const double *>(particles.positions.data());
+    const auto *velocities = reinterpret_cast<const double *>(particles.velocities.data());
+    const double *radii = particles.radii.data();
+    const double *masses = particles.masses.data();
+
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1);
+    const __m256d restitution = _mm256_set1_pd(1 + k);
+
+    size_t pair = 0;
+    for (; pair + 4 <= count; pair += 4) {
+      __m256i index1 = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(first + pair)));
+      __m256i index2 = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(second + pair)));
+      __m256i offset1 = _mm256_add_epi64(_mm256_slli_epi64(index1, 1), index1);
+      __m256i offset2 = _mm256_add_epi64(_mm256_slli_epi64(index2, 1), index2);
+
+      __m256d dx = _mm256_sub_pd(_mm256_i64gather_pd(positions, offset1, 8), _mm256_i64gather_pd(positions, offset2, 8));
+      __m256d dy = _mm256_sub_pd(_mm256_i64gather_pd(positions + 1, offset1, 8), _mm256_i64gather_pd(positions + 1, offset2, 8));
+      __m256d dz = _mm256_sub_pd(_mm256_i64gather_pd(positions + 2, offset1, 8), _mm256_i64gather_pd(positions + 2, offset2, 8));
+      __m256d radius = _mm256_add_pd(_mm256_i64gather_pd(radii, index1, 8), _mm256_i64gather_pd(radii, index2, 8));
+
+      __m256d len2 = _mm256_fmadd_pd(dx, dx, _mm256_fmadd_pd(dy, dy, _mm256_mul_pd(dz, dz)));
+      __m256d touching = _mm256_and_pd(_mm256_cmp_pd(len2, _mm256_mul_pd(radius, radius), _CMP_LE_OQ),
+                                       _mm256_cmp_pd(len2, zero, _CMP_GT_OQ));
+      auto mask = unsigned(_mm256_movemask_pd(touching));
+      if (mask == 0) continue;
+
+      __m256d mass1 = _mm256_i64gather_pd(masses, index1, 8);
+      __m256d mass2 = _mm256_i64gather_pd(masses, index2, 8);
+      __m256d len = _mm256_sqrt_pd(_mm256_blendv_pd(one, len2, touching));
+      __m256d inverseLen = _mm256_div_pd(one, len);
+      __m256d inverseMass = _mm256_div_pd(one, _mm256_add_pd(mass1, mass2));
+
+      __m256d nx = _mm256_mul_pd(dx, inverseLen);
+      __m256d ny = _mm256_mul_pd(dy, inverseLen);
+      __m256d nz = _mm256_mul_pd(dz, inverseLen);
+
+      __m256d dvx = _mm256_sub_pd(_mm256_i64gather_pd(velocities, offset1, 8), _mm256_i64gather_pd(velocities, offset2, 8));
+      __m256d dvy = _mm256_sub_pd(_mm256_i64gather_pd(velocities + 1, offset1, 8), _mm256_i64gather_pd(velocities + 1, offset2, 8));
+      __m256d dvz = _mm256_sub_pd(_mm256_i64gather_pd(velocities + 2, offset1, 8), _mm256_i64gather_pd(velocities + 2, offset2, 8));
+      __m256d relative = _mm256_fmadd_pd(dvx, nx, _mm256_fmadd_pd(dvy, ny, _mm256_mul_pd(dvz, nz)));
+
+      __m256d push = _mm256_mul_pd(_mm256_sub_pd(radius, len), inverseMass);
+      __m256d momentum = _mm256_mul_pd(_mm256_mul_pd(restitution, relative), inverseMass);
+
+      alignas(32) double normal[3][4], pushes[2][4], momenta[2][4];
+      _mm256_store_pd(normal[0], nx);
+      _mm256_store_pd(normal[1], ny);
+      _mm256_store_pd(normal[2], nz);
+      _mm256_store_pd(pushes[0], _mm256_mul_pd(push, mass2));
+      _mm256_store_pd(pushes[1], _mm256_mul_pd(push, mass1));
+      _mm256_store_pd(momenta[0], _mm256_mul_pd(momentum, mass2));
+      _mm256_store_pd(momenta[1], _mm256_mul_pd(momentum, mass1));
+
+      applyLanes<4>(particles, first + pair, second + pair, mask, normal, pushes, momenta);
+    }
+
+    solveScalar(particles, first + pair, second + pair, count - pair, k);
+  }
+
+  UNREAL_FLUID_TARGET_AVX512
+  void solveAvx512(ParticleStorage &particles, const uint32_t *first, const uint32_t *second, size_t count, double k) {
+    const auto *positions = reinterpret_cast<const double *>(particles.positions.data());
+    const auto *velocities = reinterpret_cast<const double *>(particles.velocities.data());
+    const double *radii = particles.radii.data();
+    const double *masses = particles.masses.data();
+
+    /* unmasked forms start from an undefined register, which GCC reports as maybe uninitialized */
+    const __mmask8 all = 0xff;
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1);
+    const __m512d restitution = _mm512_set1_pd(1 + k);
+
+    size_t pair = 0;
+    for (; pair + 8 <= count; pair += 8) {
+      __m512i index1 = _mm512_maskz_cvtepu32_epi64(all, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first + pair)));
+      __m512i index2 = _mm512_maskz_cvtepu32_epi64(all, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(second + pair)));
+      __m512i offset1 = _mm512_add_epi64(_mm512_add_epi64(index1, index1), index1);
+      __m512i offset2 = _mm512_add_epi64(_mm512_add_epi64(index2, index2), index2);
+
+      __m512d dx = _mm512_sub_pd(_mm512_mask_i64gather_pd(zero, all, offset1, positions, 8), _mm512_mask_i64gather_pd(zero, all, offset2, positions, 8));
+      __m512d dy = _mm512_sub_pd(_mm512_mask_i64gather_pd(zero, all, offset1, positions + 1, 8), _mm512_mask_i64gather_pd(zero, all, offset2, positions + 1, 8));
+      __m512d dz = _mm512_sub_pd(_mm512_mask_i64gather_pd(zero, all, offset1, positions + 2, 8), _mm512_mask_i64gather_pd(zero, all, offset2, positions + 2, 8));
+      __m512d radius = _mm512_add_pd(_mm512_mask_i64gather_pd(zero, all, index1, radii, 8), _mm512_mask_i64gather_pd(zero, all, index2, radii, 8));
+
+      __m512d len2 = _mm512_fmadd_pd(dx, dx, _mm512_fmadd_pd(dy, dy, _mm512_mul_pd(dz, dz)));
+      __mmask8 touching = _mm512_cmp_pd_mask(len2, _mm512_mul_pd(radius, radius), _CMP_LE_OQ) &
+                          _mm512_cmp_pd_mask(len2, zero, _CMP_GT_OQ);
+      if (touching == 0) continue;
+
+      __m512d mass1 = _mm512_mask_i64gather_pd(one, touching, index1, masses, 8);
+      __m512d mass2 = _mm512_mask_i64gather_pd(one, touching, index2, masses, 8);
+      __m512d len = _mm512_mask_sqrt_pd(one, touching, len2);
+      __m512d inverseLen = _mm512_div_pd(one, len);
+      __m512d inverseMass = _mm512_div_pd(one, _mm512_add_pd(mass1, mass2));
+
+      __m512d nx = _mm512_mul_pd(dx, inverseLen);
+      __m512d ny = _mm512_mul_pd(dy, inverseLen);
+      __m512d nz = _mm512_mul_pd(dz, inverseLen);
+
+      __m512d dvx = _mm512_sub_pd(_mm512_mask_i64gather_pd(zero, touching, offset1, velocities, 8), _mm512_mask_i64gather_pd(zero, touching, offset2, velocities, 8));
+      __m512d dvy = _mm512_sub_pd(_mm512_mask_i64gather_pd(zero, touching, offset1, velocities + 1, 8), _mm512_mask_i64gather_pd(zero, touching, offset2, velocities + 1, 8));
+      __m512d dvz = _mm512_sub_pd(_mm512_mask_i64gather_pd(zero, touching, offset1, velocities + 2, 8), _mm512_mask_i64gather_pd(zero, touching, offset2, velocities + 2, 8));
+      __m512d relative = _mm512_fmadd_pd(dvx, nx, _mm512_fmadd_pd(dvy, ny, _mm512_mul_pd(dvz, nz)));
+
+      __m512d push = _mm512_mul_pd(_mm512_sub_pd(radius, len), inverseMass);
+      __m512d momentum = _mm512_mul_pd(_mm512_mul_pd(restitution, relative), inverseMass);
+
+      alignas(64) double normal[3][8], pushes[2][8], momenta[2][8];
+      _mm512_store_pd(normal[0], nx);
+      _mm512_store_pd(normal[1], ny);
+      _mm512_store_pd(normal[2], nz);
+      _mm512_store_pd(pushes[0], _mm512_mul_pd(push, mass2));
+      _mm512_store_pd(pushes[1], _mm512_mul_pd(push, mass1));
+      _mm512_store_pd(momenta[0], _mm512_mul_pd(momentum, mass2));
+      _mm512_store_pd(momenta[1], _mm512_mul_pd(momentum, mass1));
+
+      applyLanes<8>(particles, first + pair, second + pair, touching, normal, pushes, momenta);
+    }
+
+    solveScalar(particles, first + pair, second + pair, count - pair, k);
+  }
+#endif
+} // namespace
+
+void CollisionSolver::particlesWithParticlesCollision(fluid::ParticleStorage &particles, const fluid::PairList &pairs, double k) {
+  particlesWithParticlesCollision(particles, pairs.first.data(), pairs.second.data(), pairs.size(), k);
+}
+
+void CollisionSolver::particlesWithParticlesCollision(fluid::ParticleStorage &particles, const uint32_t *first, const uint32_t *second,
+                                                      size_t count, double k) {
+  switch (CpuFeatures::getInstructionSet()) {
+#ifdef UNREAL_FLUID_X86_64
+    case CpuFeatures::InstructionSet::AVX512:
+      solveAvx512(particles, first, second, count, k);
+      break;
+    case CpuFeatures::InstructionSet::AVX2:
+      solveAvx2(particles, first, second, count, k);
+      break;
+#endif
+    default:
+      solveScalar(particles, first, second, count, k);
+      break;
+  }
+}
+
+// end of CollisionSolver.Batch.cxx
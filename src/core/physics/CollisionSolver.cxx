@@ -14,10 +14,59 @@
 
 #include "CollisionSolver.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace unreal_fluid::physics;
 
-void CollisionSolver::particleWithParticleCollision(fluid::Particle *p1, fluid::Particle *p2, double k) {
-  vec3 diff = p1->position - p2->position;
+namespace {
+  /// @brief pushes particles out of a rigid body and sums momentum they give to it
+  /// @param penetration function penetration(point, radius, normal) returning depth of the particle in the body,
+  /// not positive if they do not touch, and setting normal out of the body
+  template<typename Penetration>
+  size_t collideWithBody(fluid::ParticleStorage &particles, const uint32_t *indices, size_t count,
+                         const rigid::RigidBody &body, double k, rigid::RigidBody::Impulse &impulse, Penetration &&penetration) {
+    const vec3 &origin = particles.getOrigin();
+
+    size_t contacts = 0;
+    for (size_t i = 0; i < count; ++i) {
+      uint32_t p = indices[i];
+      vec3r &position = particles.positions[p];
+      vec3r &velocity = particles.velocities[p];
+
+      vec3 point = origin + vec3(position);
+      vec3 normal;
+      double depth = penetration(point, double(particles.radii[p]), normal);
+      if (depth <= 0) continue;
+
+      position += normal * depth;
+      contacts++;
+
+      vec3 arm = point - body.position;
+      double normalSpeed = normal.dot(vec3(velocity) - body.getPointVelocity(point));
+      if (normalSpeed >= 0) continue;
+
+      vec3 change = normal * (-(1 + k) * normalSpeed);
+      velocity += change;
+
+      vec3 hit = change * double(particles.masses[p]);
+      impulse.linear -= hit;
+      impulse.angular -= arm.cross(hit);
+      impulse.mass += particles.masses[p];
+    }
+    return contacts;
+  }
+} // namespace
+
+void CollisionSolver::particleWithParticleCollision(fluid::ParticleStorage &particles, size_t p1, size_t p2, double k) {
+  vec3r &position1 = particles.positions[p1];
+  vec3r &position2 = particles.positions[p2];
+  vec3r &velocity1 = particles.velocities[p1];
+  vec3r &velocity2 = particles.velocities[p2];
+  double mass1 = particles.masses[p1];
+  double mass2 = particles.masses[p2];
+
+  vec3 diff = position1 - position2;
 
   if (diff.len2() == 0) return;
 
@@ -25,41 +74,196 @@ void CollisionSolver::particleWithParticleCollision(fluid::Particle *p1, fluid::
   vec3 direction = diff / diffLen;
 
   double pushValue =
-          (p1->radius + p2->radius - diffLen) /
-          (p1->mass + p2->mass);
+          (particles.radii[p1] + particles.radii[p2] - diffLen) /
+          (mass1 + mass2);
 
   if (pushValue < 0) return;
 
   vec3 pushVector = direction * pushValue;
 
-  p1->position += pushVector * p2->mass;
-  p2->position -= pushVector * p1->mass;
+  position1 += pushVector * mass2;
+  position2 -= pushVector * mass1;
 
   double momentumValue =
           (1 + k) *
-          (p1->velocity.dot(direction) - p2->velocity.dot(direction)) /
-          (p1->mass + p2->mass);
+          (direction.dot(velocity1) - direction.dot(velocity2)) /
+          (mass1 + mass2);
   vec3 momentum = direction * momentumValue;
 
-  p1->velocity -= momentum * p2->mass;
-  p2->velocity += momentum * p1->mass;
+  velocity1 -= momentum * mass2;
+  velocity2 += momentum * mass1;
 }
 
-void CollisionSolver::particleWithSphereCollision(fluid::Particle *p, solid::SolidSphere *s, double k) {
-  vec3 diff = s->position - p->position;
+bool CollisionSolver::particleWithSphereCollision(fluid::ParticleStorage &particles, size_t p, solid::SolidSphere *s, double k) {
+  vec3r &position = particles.positions[p];
+  vec3r &velocity = particles.velocities[p];
+  double reach = particles.radii[p] + s->radius;
 
-  if (diff.len2() == 0) return;
+  /* particle relative to the sphere at the start and the end of the sphere step */
+  vec3 point = particles.getOrigin() + vec3(position);
+  vec3 start = point - s->getPreviousPosition();
+  vec3 end = point - s->position;
+  vec3 path = end - start;
 
-  double diffLen = diff.len();
+  /* first moment the relative path comes closer than reach */
+  double a = path.len2(), b = start.dot(path), c = start.len2() - reach * reach;
+  double t = 0;
+  if (c > 0) {
+    if (a == 0 || b >= 0) return false;
 
-  if (diffLen > p->radius + s->radius) return;
+    double discriminant = b * b - a * c;
+    if (discriminant < 0) return false;
 
+    t = (-b - std::sqrt(discriminant)) / a;
+    if (t > 1) return false;
+  }
+
+  vec3 contact = start + path * t;
+  double contactLen2 = contact.len2();
+  if (contactLen2 == 0) return false;
+
+  vec3 normal = contact / std::sqrt(contactLen2);
+
+  /* the rest of the path slides along the surface, what is still inside is pushed out */
+  vec3 rest = path * (1 - t);
+  double inward = rest.dot(normal);
+  if (inward < 0) rest -= normal * inward;
+
+  vec3 offset = contact + rest;
+  double offsetLen2 = offset.len2();
+  if (offsetLen2 < reach * reach && offsetLen2 > 0) {
+    normal = offset / std::sqrt(offsetLen2);
+    offset = normal * reach;
+  }
+
+  position += offset - end;
+
+  double normalSpeed = normal.dot(vec3(velocity) - s->velocity);
+  if (normalSpeed < 0) velocity -= normal * (1 + k) * normalSpeed;
+  return true;
+}
+
+void CollisionSolver::particlesWithSphereCollision(fluid::ParticleStorage &particles, solid::SolidSphere *s, double k) {
+  for (size_t p = 0; p < particles.size(); ++p)
+    particleWithSphereCollision(particles, p, s, k);
+}
+
+size_t CollisionSolver::particlesWithSphereCollision(fluid::ParticleStorage &particles, const uint32_t *indices, size_t count,
+                                                     solid::SolidSphere *s, double k) {
+  size_t contacts = 0;
+  for (size_t i = 0; i < count; ++i)
+    contacts += particleWithSphereCollision(particles, indices[i], s, k);
+  return contacts;
+}
+
+bool CollisionSolver::particleWithTriangleCollision(fluid::ParticleStorage &particles, size_t p, const solid::Triangle &t, double k) {
+  vec3r &position = particles.positions[p];
+  vec3r &velocity = particles.velocities[p];
+  double radius = particles.radii[p];
+
+  vec3 point = particles.getOrigin() + vec3(position);
+  vec3 diff = point - t.closestPoint(point);
+
+  double diffLen2 = diff.len2();
+  if (diffLen2 == 0 || diffLen2 > radius * radius) return false;
+
+  double diffLen = std::sqrt(diffLen2);
   diff /= diffLen;
 
-  double pushValue = s->radius + p->radius - diffLen;
+  position += diff * (radius - diffLen);
+
+  double normalSpeed = diff.dot(velocity);
+  if (normalSpeed < 0) velocity -= diff * (1 + k) * normalSpeed;
+  return true;
+}
+
+size_t CollisionSolver::particlesWithTrianglesCollision(fluid::ParticleStorage &particles, const uint32_t *indices, size_t count,
+                                                       const std::vector<solid::Triangle> &triangles,
+                                                       const uint32_t *nearTriangles, size_t nearCount, double k) {
+  size_t contacts = 0;
+  for (size_t i = 0; i < count; ++i) {
+    bool touched = false;
+    for (size_t j = 0; j < nearCount; ++j)
+      touched |= particleWithTriangleCollision(particles, indices[i], triangles[nearTriangles[j]], k);
+    contacts += touched;
+  }
+  return contacts;
+}
+
+size_t CollisionSolver::particlesWithSdfCollision(fluid::ParticleStorage &particles, const uint32_t *indices, size_t count,
+                                                 const boundary::SdfGrid &sdf, double k) {
+  const vec3 &origin = particles.getOrigin();
+
+  size_t contacts = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t p = indices[i];
+    vec3r &position = particles.positions[p];
+    vec3r &velocity = particles.velocities[p];
+    double radius = particles.radii[p];
+
+    vec3 gradient;
+    double distance = sdf.interpolate(origin + vec3(position), &gradient);
+    if (distance >= radius) continue;
+
+    double gradientLen2 = gradient.len2();
+    if (gradientLen2 == 0) continue;
+    vec3 normal = gradient / std::sqrt(gradientLen2);
+
+    position += normal * (radius - distance);
+
+    double normalSpeed = normal.dot(velocity);
+    if (normalSpeed < 0) velocity -= normal * (1 + k) * normalSpeed;
+    contacts++;
+  }
+  return contacts;
+}
+
+size_t CollisionSolver::particlesWithRigidBodyCollision(fluid::ParticleStorage &particles, const uint32_t *indices, size_t count,
+                                                        const rigid::RigidBody &body, double k, rigid::RigidBody::Impulse &impulse) {
+  if (body.shape == rigid::RigidBody::Shape::SPHERE) {
+    return collideWithBody(particles, indices, count, body, k, impulse,
+                           [&](const vec3 &point, double radius, vec3 &normal) {
+                             vec3 diff = point - body.position;
+                             double reach = body.radius + radius;
+
+                             double diffLen2 = diff.len2();
+                             if (diffLen2 == 0 || diffLen2 >= reach * reach) return 0.0;
+
+                             double diffLen = std::sqrt(diffLen2);
+                             normal = diff / diffLen;
+                             return reach - diffLen;
+                           });
+  }
+
+  const vec3 &h = body.halfExtents;
+  return collideWithBody(particles, indices, count, body, k, impulse,
+                         [&](const vec3 &point, double radius, vec3 &normal) {
+                           vec3 local = body.toLocal(point);
+                           vec3 closest(std::clamp(local.x, -h.x, h.x), std::clamp(local.y, -h.y, h.y), std::clamp(local.z, -h.z, h.z));
+                           vec3 diff = local - closest;
+
+                           double diffLen2 = diff.len2();
+                           if (diffLen2 >= radius * radius) return 0.0;
+
+                           if (diffLen2 > 0) {
+                             double diffLen = std::sqrt(diffLen2);
+                             normal = body.orientation * (diff / diffLen);
+                             return radius - diffLen;
+                           }
 
-  p->position -= diff * pushValue;
-  p->velocity -= diff * (1 + k) * p->velocity.dot(diff);
+                           /* centre inside the box leaves through the closest face */
+                           vec3 inside(h.x - std::abs(local.x), h.y - std::abs(local.y), h.z - std::abs(local.z));
+                           if (inside.x <= inside.y && inside.x <= inside.z) {
+                             normal = body.orientation.column(0) * (local.x < 0 ? -1 : 1);
+                             return radius + inside.x;
+                           }
+                           if (inside.y <= inside.z) {
+                             normal = body.orientation.column(1) * (local.y < 0 ? -1 : 1);
+                             return radius + inside.y;
+                           }
+                           normal = body.orientation.column(2) * (local.z < 0 ? -1 : 1);
+                           return radius + inside.z;
+                         });
 }
 
 // end of CollisionSolver.cxx
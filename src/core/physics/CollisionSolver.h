@@ -14,19 +14,76 @@
 
 #pragma once
 
-#include "fluid/Particle.h"
+#include "boundary/SdfGrid.h"
+#include "fluid/PairList.h"
+#include "fluid/ParticleStorage.h"
+#include "rigid/RigidBody.h"
+#include "solid/mesh/Triangle.h"
 #include "solid/sphere/SolidSphere.h"
 
 namespace unreal_fluid::physics {
   class CollisionSolver {
   public:
     /// @brief collides two particles
-    /// @details takes two particles p1, p2 and uses k - coefficient of restitution - to collide them
-    static void particleWithParticleCollision(fluid::Particle *p1, fluid::Particle *p2, double k);
+    /// @details takes particles with indices p1, p2 from storage and uses k - coefficient of restitution - to collide them
+    static void particleWithParticleCollision(fluid::ParticleStorage &particles, size_t p1, size_t p2, double k);
+
+    /// @brief collides every pair of the list
+    /// @details Uses AVX2 or AVX-512 kernels when CPU supports them. Vector kernels resolve a group
+    /// of 4 or 8 pairs, 8 or 16 in single precision build, from the state before the group and then add up the results, other
+    /// pairs are resolved one by one in list order. Implemented in CollisionSolver.Batch.cxx.
+    static void particlesWithParticlesCollision(fluid::ParticleStorage &particles, const fluid::PairList &pairs, double k);
+
+    /// @brief collides count pairs given by two columns of indices
+    /// @details same as above for a part of a bigger list
+    static void particlesWithParticlesCollision(fluid::ParticleStorage &particles, const uint32_t *first, const uint32_t *second,
+                                                size_t count, double k);
 
     /// @brief collides particle with sphere
-    /// @details takes particle p, static sphere s and uses k - coefficient of restitution - to collide them
-    static void particleWithSphereCollision(fluid::Particle *p, solid::SolidSphere *s, double k);
+    /// @details takes particle with index p from storage, sphere s and uses k - coefficient of restitution - to collide them.
+    /// The sphere is swept from its previous position to the current one against the particle at its current position,
+    /// the particle is stopped at the first contact and slides along the surface for the rest of the sphere step,
+    /// so a fast sphere pushes particles in its way instead of passing through them. Velocity is reflected relative
+    /// to the velocity of the sphere.
+    /// @return true if they touched
+    static bool particleWithSphereCollision(fluid::ParticleStorage &particles, size_t p, solid::SolidSphere *s, double k);
+
+    /// @brief collides all particles with sphere
+    /// @details runs particleWithSphereCollision in one pass over the particle columns
+    static void particlesWithSphereCollision(fluid::ParticleStorage &particles, solid::SolidSphere *s, double k);
+
+    /// @brief collides count particles given by their indices with sphere
+    /// @return amount of particles which touched the sphere
+    static size_t particlesWithSphereCollision(fluid::ParticleStorage &particles, const uint32_t *indices, size_t count,
+                                               solid::SolidSphere *s, double k);
+
+    /// @brief collides particle with static triangle
+    /// @details particle is pushed away from the closest point of the triangle, both sides of it are solid
+    /// @return true if they touched
+    static bool particleWithTriangleCollision(fluid::ParticleStorage &particles, size_t p, const solid::Triangle &t, double k);
+
+    /// @brief collides every given particle with every given triangle
+    /// @details particles and triangles are meant to be close to each other, e.g. particles of one grid cell
+    /// and triangles near the cell
+    /// @return amount of particles which touched any triangle
+    static size_t particlesWithTrianglesCollision(fluid::ParticleStorage &particles, const uint32_t *indices, size_t count,
+                                                  const std::vector<solid::Triangle> &triangles,
+                                                  const uint32_t *nearTriangles, size_t nearCount, double k);
+
+    /// @brief collides count particles given by their indices with solid described by a distance grid
+    /// @details one trilinear sample gives both distance and normal of a particle
+    /// @return amount of particles which touched the solid
+    static size_t particlesWithSdfCollision(fluid::ParticleStorage &particles, const uint32_t *indices, size_t count,
+                                            const boundary::SdfGrid &sdf, double k);
+
+    /// @brief collides count particles given by their indices with rigid body and sums impulses they give to it
+    /// @details Particles are pushed out of the sphere or box and their velocity is reflected relative to the velocity
+    /// of the body point they touch, as from a solid. The body is left as it is: the impulses and the mass of particles
+    /// which gave them are added to impulse, so a caller sums them over a batch and applies them once.
+    /// The shape is chosen once per call, not per particle.
+    /// @return amount of particles which touched the body
+    static size_t particlesWithRigidBodyCollision(fluid::ParticleStorage &particles, const uint32_t *indices, size_t count,
+                                                  const rigid::RigidBody &body, double k, rigid::RigidBody::Impulse &impulse);
   };
 
 } // namespace unreal_fluid::physics::fluid
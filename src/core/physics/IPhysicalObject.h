@@ -34,19 +34,23 @@ namespace unreal_fluid::physics {
 
       /* fluid objects */
       SIMPLE_FLUID_CONTAINER,
+      SPH_FLUID_CONTAINER,
+      PBF_FLUID_CONTAINER,
 
       /* gas objects */
       GAS_CONTAINER_2D,
+      GAS_CONTAINER_3D,
+
+      /* rigid bodies */
+      RIGID_BODY_WORLD,
     };
 
     virtual ~IPhysicalObject() = default;
 
     /// @brief returns type of an accessor
+    /// @details objects are cast to the class of their type, see CollisionDispatcher
     virtual Type getType() = 0;
 
-    /// @brief returns data stored in a physical container
-    virtual void *getData() = 0;
-
   private:
     virtual void simulate(double dt) = 0;
   };
@@ -6,7 +6,7 @@
 /* PROJECT   : ultimate_py_project
  * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
  * FILE NAME : PhysicsDefinitions.h
- * PURPOSE   : physical constants
+ * PURPOSE   : physical constants and precision of physics types
  *
  * No part of this file may be changed and used without agreement of
  * authors of this project.
@@ -18,6 +18,17 @@
 
 namespace unreal_fluid::physics {
   const vec3 G = {0.0, -9.81, 0.0};
+
+  /// @brief scalar type of particle columns and collision kernels
+  /// @details Build with UNREAL_FLUID_PHYSICS_FLOAT defined to store particles in single precision,
+  /// interfaces of containers still take and return double vectors.
+#ifdef UNREAL_FLUID_PHYSICS_FLOAT
+  using real = float;
+#else
+  using real = double;
+#endif
+
+  using vec3r = math::Vector3<real>;
 }
 
 // end of PhysicsDefinitions.h
@@ -13,36 +13,111 @@
 
 #include "Simulator.h"
 #include "CollisionSolver.h"
+#include "fluid/IFluidContainer.h"
+#include "rigid/RigidBodyWorld.h"
+#include "solid/mesh/SolidMesh.h"
 
 using namespace unreal_fluid::physics;
 
+Simulator::Simulator() {
+  using Type = IPhysicalObject::Type;
+
+  for (Type fluidType: {Type::SIMPLE_FLUID_CONTAINER, Type::SPH_FLUID_CONTAINER, Type::PBF_FLUID_CONTAINER}) {
+    dispatcher.add<fluid::IFluidContainer, solid::SolidSphere>(fluidType, Type::SOLID_SPHERE, [this](fluid::IFluidContainer &fluid, solid::SolidSphere &sphere) {
+      collide(fluid, sphere);
+    });
+    dispatcher.add<fluid::IFluidContainer, solid::SolidMesh>(fluidType, Type::SOLID_MESH, [this](fluid::IFluidContainer &fluid, solid::SolidMesh &mesh) {
+      collide(fluid, mesh);
+    });
+    dispatcher.add<fluid::IFluidContainer, rigid::RigidBodyWorld>(fluidType, Type::RIGID_BODY_WORLD, [this](fluid::IFluidContainer &fluid, rigid::RigidBodyWorld &world) {
+      collide(fluid, world);
+    });
+  }
+}
+
 void Simulator::addPhysicalObject(IPhysicalObject *physicalObject) {
-  if (physicalObject->getType() == IPhysicalObject::Type::SIMPLE_FLUID_CONTAINER ||
-      physicalObject->getType() == IPhysicalObject::Type::GAS_CONTAINER_2D)
+  bool dynamic = isFluid(physicalObject) || physicalObject->getType() == IPhysicalObject::Type::GAS_CONTAINER_2D ||
+                 physicalObject->getType() == IPhysicalObject::Type::GAS_CONTAINER_3D ||
+                 physicalObject->getType() == IPhysicalObject::Type::RIGID_BODY_WORLD;
+  if (dynamic)
     dynamicObjects.push_back(physicalObject);
   else
     solidObjects.push_back(physicalObject);
+
+  /* pairs are kept grouped by dynamic object, so particles of a fluid go into the broad phase once per step */
+  interactions.clear();
+  for (auto &dynamicObject: dynamicObjects) {
+    /* rigid worlds move on their own, but fluids hit them as solids */
+    std::vector<IPhysicalObject *> obstacles = solidObjects;
+    if (isFluid(dynamicObject))
+      for (auto &other: dynamicObjects)
+        if (other->getType() == IPhysicalObject::Type::RIGID_BODY_WORLD) obstacles.push_back(other);
+
+    for (auto &obstacle: obstacles) {
+      const CollisionDispatcher::Handler *handler = dispatcher.find(dynamicObject->getType(), obstacle->getType());
+      if (handler == nullptr) continue;
+
+      fluid::ParticleStorage *particles = isFluid(dynamicObject) ? &static_cast<fluid::IFluidContainer *>(dynamicObject)->getParticles() : nullptr;
+      interactions.push_back({handler, dynamicObject, obstacle, particles});
+    }
+  }
 }
 
 void Simulator::simulate(double dt) {
+  for (auto &solidObject: solidObjects)
+    solidObject->simulate(dt);
+
   for (auto &physObject: dynamicObjects)
     physObject->simulate(dt);
 
-  for (auto &physObject: dynamicObjects) {
-    for (auto &solidObject: solidObjects)
-      interact(physObject, solidObject);
+  const fluid::ParticleStorage *indexed = nullptr;
+  for (auto &interaction: interactions) {
+    if (interaction.particles != nullptr && interaction.particles != indexed) {
+      broadPhase.update(*interaction.particles);
+      indexed = interaction.particles;
+    }
+
+    (*interaction.handler)(*interaction.dynamicObject, *interaction.solid);
   }
 }
 
-void Simulator::interact(IPhysicalObject *dynamicObject, IPhysicalObject *solid) {
-  if (dynamicObject->getType() == IPhysicalObject::Type::SIMPLE_FLUID_CONTAINER) {
-    auto particles = (std::vector<fluid::Particle *> *) dynamicObject->getData();
-    if (solid->getType() == IPhysicalObject::Type::SOLID_SPHERE) {
-      auto sphere = (solid::SolidSphere *) solid;
-      for (auto particle: *particles)
-        CollisionSolver::particleWithSphereCollision(particle, sphere, 0.8);
-    }
+void Simulator::collide(fluid::IFluidContainer &fluid, solid::SolidSphere &sphere) {
+  auto &particles = fluid.getParticles();
+  auto &candidates = broadPhase.query(particles, sphere.getBounds());
+  broadPhase.addContacts(CollisionSolver::particlesWithSphereCollision(particles, candidates.data(), candidates.size(), &sphere, 0.8));
+}
+
+void Simulator::collide(fluid::IFluidContainer &fluid, solid::SolidMesh &mesh) {
+  auto &particles = fluid.getParticles();
+
+  if (const boundary::SdfGrid *sdf = mesh.getSdf()) {
+    auto &candidates = broadPhase.query(particles, mesh.getBounds());
+    broadPhase.addContacts(CollisionSolver::particlesWithSdfCollision(particles, candidates.data(), candidates.size(), *sdf, 0.8));
+    return;
+  }
+
+  broadPhase.forEachBatch(particles, mesh.getBounds(), [&](const uint32_t *indices, size_t count, const solid::Aabb &reach) {
+    mesh.getBvh().query(reach, nearTriangles);
+    if (nearTriangles.empty()) return;
+
+    broadPhase.addContacts(CollisionSolver::particlesWithTrianglesCollision(particles, indices, count, mesh.getTriangles(),
+                                                                            nearTriangles.data(), nearTriangles.size(), 0.8));
+  });
+}
+
+void Simulator::collide(fluid::IFluidContainer &fluid, rigid::RigidBodyWorld &world) {
+  auto &particles = fluid.getParticles();
+
+  for (size_t body = 0; body < world.getBodies().size(); ++body) {
+    auto &candidates = broadPhase.query(particles, world.getBodies()[body].getBounds());
+    broadPhase.addContacts(world.collideParticles(body, particles, candidates.data(), candidates.size(), 0.8));
   }
 }
 
+bool Simulator::isFluid(IPhysicalObject *physicalObject) {
+  return physicalObject->getType() == IPhysicalObject::Type::SIMPLE_FLUID_CONTAINER ||
+         physicalObject->getType() == IPhysicalObject::Type::SPH_FLUID_CONTAINER ||
+         physicalObject->getType() == IPhysicalObject::Type::PBF_FLUID_CONTAINER;
+}
+
 // end of Simulator.cpp
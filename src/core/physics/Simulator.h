@@ -17,30 +17,79 @@
 
 #include "../../Definitions.h"
 
+#include "BroadPhase.h"
+#include "CollisionDispatcher.h"
 #include "IPhysicalObject.h"
 
 namespace unreal_fluid::physics {
+  namespace fluid {
+    class IFluidContainer;
+  }
+  namespace solid {
+    class SolidSphere;
+    class SolidMesh;
+  } // namespace solid
+  namespace rigid {
+    class RigidBodyWorld;
+  }
+
   class Simulator {
   private:
+    /// @brief pair of objects which interact every step with handler found when they were added
+    struct Interaction {
+      const CollisionDispatcher::Handler *handler;
+      IPhysicalObject *dynamicObject;
+      IPhysicalObject *solid;
+      fluid::ParticleStorage *particles; // particles to put into the broad phase, nullptr if not a fluid
+    };
+
     std::vector<IPhysicalObject *> dynamicObjects;
     std::vector<IPhysicalObject *> solidObjects;
+    CollisionDispatcher dispatcher;
+    std::vector<Interaction> interactions;
+    BroadPhase broadPhase;
+    std::vector<uint32_t> nearTriangles; // triangles of a mesh near one grid cell
 
   public:
-    Simulator() = default;
+    /// @brief registers collision handlers of fluids with solids and rigid bodies
+    Simulator();
     ~Simulator() = default;
 
+    Simulator(const Simulator &) = delete;
+    Simulator &operator=(const Simulator &) = delete;
+
     /// @brief Adds IPhysicalObject to scene
     /// @details Adds IPhysicalObject into an internal buffer according to its type.
     void addPhysicalObject(IPhysicalObject *physicalObject);
 
     /// @brief Simulates the scene
-    /// @details calls simulate() function of each physical object in the internal buffer
-    /// and solves interaction between solids and dynamic objects.
+    /// @details moves kinematic solids, calls simulate() function of each dynamic object in the internal buffer
+    /// and solves interaction between solids and dynamic objects with handlers of the dispatcher. Particles of each fluid are
+    /// put into the broad phase once, so every solid is tested only against particles near it.
+    /// Meshes look up their triangles near every grid cell in their bounding volume hierarchy,
+    /// or sample their baked distance grid once per particle if they have one.
+    /// Rigid bodies are simulated as dynamic objects, but fluids collide with them as with solids
+    /// and push them back in the next step.
     void simulate(double dt);
 
+    /// @brief returns broad phase of fluid-solid interaction with its statistics
+    [[nodiscard]] BroadPhase &getBroadPhase() { return broadPhase; }
+
+    /// @brief returns collision handlers, new ones apply to objects added after registration
+    [[nodiscard]] CollisionDispatcher &getDispatcher() { return dispatcher; }
+
   private:
-    /// @brief used to interact a solid and a dynamic object
-    void interact(IPhysicalObject *dynamicObject, IPhysicalObject *solid);
+    /// @brief collides particles of a fluid with a sphere
+    void collide(fluid::IFluidContainer &fluid, solid::SolidSphere &sphere);
+
+    /// @brief collides particles of a fluid with a mesh, through its distance grid if it is baked
+    void collide(fluid::IFluidContainer &fluid, solid::SolidMesh &mesh);
+
+    /// @brief collides particles of a fluid with every body of a rigid world, the bodies feel the hits in the next step
+    void collide(fluid::IFluidContainer &fluid, rigid::RigidBodyWorld &world);
+
+    /// @brief checks if object is a particle fluid container
+    static bool isFluid(IPhysicalObject *physicalObject);
   };
 } // namespace unreal_fluid::physics
 
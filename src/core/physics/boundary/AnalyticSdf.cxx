@@ -0,0 +1,69 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : AnalyticSdf.cxx
+ * PURPOSE   : signed distance fields of simple shapes
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "AnalyticSdf.h"
+
+using namespace unreal_fluid::physics::boundary;
+
+namespace {
+  /// @brief returns direction of v, or fallback if v is zero
+  vec3 direction(const vec3 &v, const vec3 &fallback) {
+    double length2 = v.len2();
+    return length2 > 0 ? v / std::sqrt(length2) : fallback;
+  }
+} // namespace
+
+SdfPlane::SdfPlane(vec3 point, vec3 normal) : point(point),
+                                              normal(direction(normal, {0, 1, 0})) {}
+
+vec3 SdfPlane::gradient(const vec3 &) const {
+  return normal;
+}
+
+SdfBox::SdfBox(vec3 min, vec3 max) : centre((min + max) / 2.0),
+                                     halfSize((max - min) / 2.0) {}
+
+vec3 SdfBox::gradient(const vec3 &position) const {
+  vec3 local = position - centre;
+  vec3 q = {std::abs(local.x) - halfSize.x, std::abs(local.y) - halfSize.y, std::abs(local.z) - halfSize.z};
+  vec3 sign = {local.x < 0 ? -1.0 : 1.0, local.y < 0 ? -1.0 : 1.0, local.z < 0 ? -1.0 : 1.0};
+
+  /* outside gradient points from the closest point of the box, inside - through the closest face */
+  if (q.x > 0 || q.y > 0 || q.z > 0)
+    return direction(vec3(std::max(q.x, 0.0), std::max(q.y, 0.0), std::max(q.z, 0.0)) * sign, {0, 1, 0});
+
+  if (q.x >= q.y && q.x >= q.z) return {sign.x, 0, 0};
+  if (q.y >= q.z) return {0, sign.y, 0};
+  return {0, 0, sign.z};
+}
+
+SdfSphere::SdfSphere(vec3 centre, double radius) : centre(centre),
+                                                   radius(radius) {}
+
+vec3 SdfSphere::gradient(const vec3 &position) const {
+  return direction(position - centre, {0, 1, 0});
+}
+
+SdfCapsule::SdfCapsule(vec3 start, vec3 end, double radius) : start(start),
+                                                              axis(end - start),
+                                                              radius(radius) {
+  double length2 = axis.len2();
+  inverseAxisLength2 = length2 > 0 ? 1 / length2 : 0;
+}
+
+vec3 SdfCapsule::gradient(const vec3 &position) const {
+  return direction(position - closestPoint(position), {0, 1, 0});
+}
+
+// end of AnalyticSdf.cxx
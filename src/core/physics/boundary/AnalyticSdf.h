@@ -0,0 +1,99 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : AnalyticSdf.h
+ * PURPOSE   : signed distance fields of simple shapes
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "Sdf.h"
+
+namespace unreal_fluid::physics::boundary {
+  /// @brief Half-space below a plane.
+  class SdfPlane : public AnalyticSdf<SdfPlane> {
+  private:
+    vec3 point;
+    vec3 normal;
+
+  public:
+    /// @param normal direction out of the solid
+    SdfPlane(vec3 point, vec3 normal);
+
+    [[nodiscard]] double distance(const vec3 &position) const override { return (position - point).dot(normal); }
+    [[nodiscard]] vec3 gradient(const vec3 &position) const override;
+  };
+
+  /// @brief Axis aligned box.
+  class SdfBox : public AnalyticSdf<SdfBox> {
+  private:
+    vec3 centre;
+    vec3 halfSize;
+
+  public:
+    SdfBox(vec3 min, vec3 max);
+
+    [[nodiscard]] double distance(const vec3 &position) const override {
+      double qx = std::abs(position.x - centre.x) - halfSize.x;
+      double qy = std::abs(position.y - centre.y) - halfSize.y;
+      double qz = std::abs(position.z - centre.z) - halfSize.z;
+
+      double ox = std::max(qx, 0.0), oy = std::max(qy, 0.0), oz = std::max(qz, 0.0);
+      return std::sqrt(ox * ox + oy * oy + oz * oz) + std::min(std::max(qx, std::max(qy, qz)), 0.0);
+    }
+
+    [[nodiscard]] vec3 gradient(const vec3 &position) const override;
+  };
+
+  class SdfSphere : public AnalyticSdf<SdfSphere> {
+  private:
+    vec3 centre;
+    double radius;
+
+  public:
+    SdfSphere(vec3 centre, double radius);
+
+    [[nodiscard]] double distance(const vec3 &position) const override {
+      return std::sqrt((position - centre).len2()) - radius;
+    }
+
+    [[nodiscard]] vec3 gradient(const vec3 &position) const override;
+  };
+
+  /// @brief Segment with radius.
+  class SdfCapsule : public AnalyticSdf<SdfCapsule> {
+  private:
+    vec3 start;
+    vec3 axis; // from start to end
+    double inverseAxisLength2;
+    double radius;
+
+  public:
+    SdfCapsule(vec3 start, vec3 end, double radius);
+
+    [[nodiscard]] double distance(const vec3 &position) const override {
+      return std::sqrt((position - closestPoint(position)).len2()) - radius;
+    }
+
+    [[nodiscard]] vec3 gradient(const vec3 &position) const override;
+
+  private:
+    /// @brief returns point of the segment closest to position
+    [[nodiscard]] vec3 closestPoint(const vec3 &position) const {
+      double t = std::clamp((position - start).dot(axis) * inverseAxisLength2, 0.0, 1.0);
+      return start + axis * t;
+    }
+  };
+} // namespace unreal_fluid::physics::boundary
+
+// end of AnalyticSdf.h
@@ -0,0 +1,80 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : Boundary.cxx
+ * PURPOSE   : static boundary of particle containers
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "Boundary.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace unreal_fluid::physics::boundary;
+
+void Boundary::addSolid(std::unique_ptr<Sdf> sdf) {
+  shapes.push_back({std::move(sdf), 1});
+}
+
+void Boundary::addContainer(std::unique_ptr<Sdf> sdf) {
+  shapes.push_back({std::move(sdf), -1});
+}
+
+void Boundary::clear() {
+  shapes.clear();
+}
+
+double Boundary::distance(const vec3 &point) const {
+  double result = std::numeric_limits<double>::infinity();
+  for (const auto &shape: shapes)
+    result = std::min(result, shape.sign * shape.sdf->distance(point));
+  return result;
+}
+
+void Boundary::resolve(fluid::ParticleStorage &particles, double restitution, utils::ThreadPool &pool) const {
+  if (shapes.empty()) return;
+
+  constexpr size_t blockSize = 256;
+  constexpr int maxPushes = 3; // enough for a corner of a box
+  const vec3 &origin = particles.getOrigin();
+
+  /* shapes are resolved one after another, so a particle in a corner is pushed out of every wall of it */
+  pool.parallelFor(particles.size(), [&](size_t begin, size_t end, unsigned) {
+    double distances[blockSize];
+
+    for (size_t block = begin; block < end; block += blockSize) {
+      size_t count = std::min(blockSize, end - block);
+
+      for (const Shape &shape: shapes) {
+        shape.sdf->distances(particles.positions.data() + block, count, origin, distances);
+
+        for (size_t i = 0; i < count; ++i) {
+          size_t particle = block + i;
+          double penetration = particles.radii[particle] - shape.sign * distances[i];
+          if (penetration <= 0) continue;
+
+          /* inside a corner of a container pushing out of the closest face may leave particle in another one */
+          for (int iteration = 0; penetration > 0 && iteration < maxPushes; ++iteration) {
+            vec3 position = vec3(particles.positions[particle]) + origin;
+            vec3 normal = shape.sdf->gradient(position) * shape.sign;
+            particles.positions[particle] += normal * penetration;
+
+            double normalSpeed = normal.dot(particles.velocities[particle]);
+            if (normalSpeed < 0) particles.velocities[particle] -= normal * ((1 + restitution) * normalSpeed);
+
+            penetration = particles.radii[particle] - shape.sign * shape.sdf->distance(position + normal * penetration);
+          }
+        }
+      }
+    }
+  });
+}
+
+// end of Boundary.cxx
@@ -0,0 +1,75 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : Boundary.h
+ * PURPOSE   : static boundary of particle containers
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "../../../utils/thread_pool/ThreadPool.h"
+#include "../fluid/ParticleStorage.h"
+#include "Sdf.h"
+
+namespace unreal_fluid::physics::boundary {
+  /// @brief Static solids and walls particles collide with.
+  /// @details Every shape is either a solid with particles outside of it, or a container with
+  /// particles inside of it. Distance to the boundary is the smallest distance over all shapes.
+  /// Particles are resolved in blocks: each shape writes distances of a block with one call, and only
+  /// particles closer than their radius ask it for gradient. Shapes are resolved one after another,
+  /// so particles in corners are pushed out of all walls they touch.
+  class Boundary {
+  private:
+    struct Shape {
+      std::unique_ptr<Sdf> sdf;
+      double sign; // 1 for solids, -1 for containers
+    };
+
+    std::vector<Shape> shapes;
+
+  public:
+    Boundary() = default;
+    ~Boundary() = default;
+
+    /// @brief adds solid, particles are kept outside of it
+    void addSolid(std::unique_ptr<Sdf> sdf);
+
+    /// @brief adds container, particles are kept inside of it
+    void addContainer(std::unique_ptr<Sdf> sdf);
+
+    /// @brief removes all shapes
+    void clear();
+
+    [[nodiscard]] bool empty() const { return shapes.empty(); }
+
+    /// @brief returns distance from point to the boundary, negative if point is in a wall
+    [[nodiscard]] double distance(const vec3 &point) const;
+
+    /// @brief calls callback(shapeIndex, distance, normal) for every shape the point is closer to than margin
+    /// @details distance is negative inside a wall, normal points out of the wall
+    template<typename Callback>
+    void forEachShapeNear(const vec3 &point, double margin, Callback &&callback) const {
+      for (size_t index = 0; index < shapes.size(); ++index) {
+        const Shape &shape = shapes[index];
+        double distance = shape.sign * shape.sdf->distance(point);
+        if (distance < margin) callback(index, distance, shape.sdf->gradient(point) * shape.sign);
+      }
+    }
+
+    /// @brief pushes particles out of walls and reflects their velocities
+    /// @param restitution part of normal velocity left after a hit
+    void resolve(fluid::ParticleStorage &particles, double restitution, utils::ThreadPool &pool) const;
+  };
+} // namespace unreal_fluid::physics::boundary
+
+// end of Boundary.h
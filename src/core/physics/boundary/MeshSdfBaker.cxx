@@ -0,0 +1,242 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : MeshSdfBaker.cxx
+ * PURPOSE   : voxelises static meshes into signed distance grids
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "MeshSdfBaker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+
+using namespace unreal_fluid::physics::boundary;
+
+namespace {
+  constexpr uint64_t bakeVersion = 1; // changes of the algorithm must change hashes of cached grids
+
+  /// @brief FNV-1a over raw bytes
+  uint64_t mix(uint64_t hash, const void *data, size_t size) {
+    auto bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  /// @brief solves eikonal equation in a node from smallest neighbour distances along every axis
+  double solveEikonal(double a, double b, double c, double h) {
+    if (a > b) std::swap(a, b);
+    if (b > c) std::swap(b, c);
+    if (a > b) std::swap(a, b);
+
+    double u = a + h;
+    if (u <= b) return u;
+
+    u = (a + b + std::sqrt(2 * h * h - (a - b) * (a - b))) / 2;
+    if (u <= c) return u;
+
+    double sum = a + b + c;
+    return (sum + std::sqrt(sum * sum - 3 * (a * a + b * b + c * c - h * h))) / 3;
+  }
+} // namespace
+
+std::unique_ptr<SdfGrid> MeshSdfBaker::bake(const solid::SolidMesh &mesh, double cellSize, int bandCells, utils::ThreadPool &pool) {
+  const auto &triangles = mesh.getTriangles();
+  const solid::Bvh &bvh = mesh.getBvh();
+
+  double band = bandCells * cellSize;
+  solid::Aabb bounds = mesh.getBounds().empty() ? solid::Aabb({0, 0, 0}, {0, 0, 0}) : mesh.getBounds();
+  bounds.inflate(band + cellSize);
+
+  vec3 size = bounds.max - bounds.min;
+  int nx = int(std::ceil(size.x / cellSize)) + 1;
+  int ny = int(std::ceil(size.y / cellSize)) + 1;
+  int nz = int(std::ceil(size.z / cellSize)) + 1;
+  auto grid = std::make_unique<SdfGrid>(bounds.min, cellSize, nx, ny, nz);
+
+  auto index = [&](int x, int y, int z) { return (size_t(z) * ny + y) * nx + x; };
+  auto node = [&](int x, int y, int z) { return bounds.min + vec3(x, y, z) * cellSize; };
+
+  constexpr double infinity = std::numeric_limits<double>::infinity();
+  size_t count = size_t(nx) * ny * nz;
+  std::vector<double> distances(count, infinity);
+  std::vector<int32_t> closest(count, -1);
+
+  /* exact distances in nodes of cells crossed by the surface, every thread owns whole layers */
+  double seedRadius = cellSize * std::sqrt(3.0);
+  pool.parallelFor(size_t(nz), [&](size_t begin, size_t end, unsigned) {
+    std::vector<uint32_t> near;
+
+    for (auto z = int(begin); z < int(end); ++z) {
+      double layerZ = bounds.min.z + z * cellSize;
+      solid::Aabb layer({bounds.min.x, bounds.min.y, layerZ}, {bounds.max.x, bounds.max.y, layerZ});
+      layer.inflate(seedRadius);
+      bvh.query(layer, near);
+
+      for (uint32_t triangle: near) {
+        const solid::Triangle &t = triangles[triangle];
+        solid::Aabb reach;
+        reach.add(vec3(t.v1)), reach.add(vec3(t.v2)), reach.add(vec3(t.v3));
+        reach.inflate(seedRadius);
+
+        int minX = std::max(0, int(std::ceil((reach.min.x - bounds.min.x) / cellSize)));
+        int maxX = std::min(nx - 1, int(std::floor((reach.max.x - bounds.min.x) / cellSize)));
+        int minY = std::max(0, int(std::ceil((reach.min.y - bounds.min.y) / cellSize)));
+        int maxY = std::min(ny - 1, int(std::floor((reach.max.y - bounds.min.y) / cellSize)));
+
+        for (int y = minY; y <= maxY; ++y)
+          for (int x = minX; x <= maxX; ++x) {
+            vec3 point = node(x, y, z);
+            double distance = std::sqrt((point - t.closestPoint(point)).len2());
+
+            size_t i = index(x, y, z);
+            if (distance < seedRadius && distance < distances[i]) distances[i] = distance, closest[i] = int32_t(triangle);
+          }
+      }
+    }
+  });
+
+  /* fast sweeping along x lines, a line with j + k = level only reads lines of neighbour levels */
+  for (int direction = 0; direction < 8; ++direction) {
+    bool flipX = direction & 1, flipY = direction & 2, flipZ = direction & 4;
+
+    for (int level = 0; level <= (ny - 1) + (nz - 1); ++level) {
+      int kBegin = std::max(0, level - (ny - 1)), kEnd = std::min(nz - 1, level);
+
+      pool.parallelFor(size_t(kEnd - kBegin + 1), [&](size_t begin, size_t end, unsigned) {
+        for (auto k = int(kBegin + begin); k < int(kBegin + end); ++k) {
+          int y = flipY ? ny - 1 - (level - k) : level - k, z = flipZ ? nz - 1 - k : k;
+
+          for (int i = 0; i < nx; ++i) {
+            int x = flipX ? nx - 1 - i : i;
+
+            size_t at = index(x, y, z);
+            if (closest[at] >= 0) continue; // exact distances are kept
+
+            double a = std::min(x > 0 ? distances[at - 1] : infinity, x < nx - 1 ? distances[at + 1] : infinity);
+            double b = std::min(y > 0 ? distances[at - nx] : infinity, y < ny - 1 ? distances[at + nx] : infinity);
+            double c = std::min(z > 0 ? distances[at - size_t(nx) * ny] : infinity,
+                                z < nz - 1 ? distances[at + size_t(nx) * ny] : infinity);
+            if (std::min(a, std::min(b, c)) >= band) continue; // beyond the band
+
+            distances[at] = std::min(distances[at], solveEikonal(a, b, c, cellSize));
+          }
+        }
+      });
+    }
+  }
+
+  /* flood fill from the border through nodes farther than half a cell from the surface,
+   * two neighbour nodes on different sides of the surface can not both be that far */
+  double wall = cellSize / 2 * (1 + 1e-6);
+  std::vector<uint8_t> outside(count, 0);
+  std::vector<size_t> queue;
+
+  for (int z = 0; z < nz; ++z)
+    for (int y = 0; y < ny; ++y)
+      for (int x = 0; x < nx; ++x)
+        if ((x == 0 || y == 0 || z == 0 || x == nx - 1 || y == ny - 1 || z == nz - 1) && distances[index(x, y, z)] > wall) {
+          outside[index(x, y, z)] = 1;
+          queue.push_back(index(x, y, z));
+        }
+
+  const int offsets[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+  for (size_t head = 0; head < queue.size(); ++head) {
+    size_t at = queue[head];
+    int x = int(at % nx), y = int(at / nx % ny), z = int(at / (size_t(nx) * ny));
+
+    for (const auto &offset: offsets) {
+      int ox = x + offset[0], oy = y + offset[1], oz = z + offset[2];
+      if (ox < 0 || oy < 0 || oz < 0 || ox >= nx || oy >= ny || oz >= nz) continue;
+
+      size_t next = index(ox, oy, oz);
+      if (outside[next] || distances[next] <= wall) continue;
+      outside[next] = 1;
+      queue.push_back(next);
+    }
+  }
+
+  /* nodes on the surface take the side most of their far neighbours are on, or the side of the closest face */
+  for (int z = 0; z < nz; ++z)
+    for (int y = 0; y < ny; ++y)
+      for (int x = 0; x < nx; ++x) {
+        size_t at = index(x, y, z);
+        double distance = std::min(distances[at], band);
+        bool inside = !outside[at];
+
+        if (distances[at] <= wall) {
+          int votes = 0;
+          for (const auto &offset: offsets) {
+            int ox = x + offset[0], oy = y + offset[1], oz = z + offset[2];
+            if (ox < 0 || oy < 0 || oz < 0 || ox >= nx || oy >= ny || oz >= nz) continue;
+
+            size_t next = index(ox, oy, oz);
+            if (distances[next] > wall) votes += outside[next] ? -1 : 1;
+          }
+
+          if (votes != 0) {
+            inside = votes > 0;
+          } else {
+            const solid::Triangle &t = triangles[closest[at]];
+            vec3 normal = (vec3(t.v2) - vec3(t.v1)).cross(vec3(t.v3) - vec3(t.v1));
+            vec3 point = node(x, y, z);
+            inside = (point - t.closestPoint(point)).dot(normal) < 0;
+          }
+        }
+
+        grid->setValue(x, y, z, inside ? -distance : distance);
+      }
+
+  return grid;
+}
+
+std::unique_ptr<SdfGrid> MeshSdfBaker::load(const solid::SolidMesh &mesh, double cellSize, int bandCells,
+                                            std::string_view cacheDirectory, utils::ThreadPool &pool) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.sdf", static_cast<unsigned long long>(hash(mesh, cellSize, bandCells)));
+  std::filesystem::path path = std::filesystem::path(std::string(cacheDirectory)) / name;
+
+  if (std::ifstream file(path, std::ios::binary); file.is_open())
+    if (auto grid = SdfGrid::load(file)) return grid;
+
+  auto grid = bake(mesh, cellSize, bandCells, pool);
+
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+  std::ofstream file(path, std::ios::binary);
+  if (!file.is_open() || !grid->save(file))
+    Logger::logWarning("Can't write baked distance grid to", path.string());
+
+  return grid;
+}
+
+uint64_t MeshSdfBaker::hash(const solid::SolidMesh &mesh, double cellSize, int bandCells) {
+  uint64_t result = 14695981039346656037ull;
+  result = mix(result, &bakeVersion, sizeof(bakeVersion));
+  result = mix(result, &cellSize, sizeof(cellSize));
+  result = mix(result, &bandCells, sizeof(bandCells));
+
+  for (const auto &triangle: mesh.getTriangles())
+    for (const vec3f *vertex: {&triangle.v1, &triangle.v2, &triangle.v3}) {
+      float coordinates[3] = {vertex->x, vertex->y, vertex->z};
+      result = mix(result, coordinates, sizeof(coordinates));
+    }
+
+  return result;
+}
+
+// end of MeshSdfBaker.cxx
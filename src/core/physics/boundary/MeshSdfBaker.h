@@ -0,0 +1,53 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : MeshSdfBaker.h
+ * PURPOSE   : voxelises static meshes into signed distance grids
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "../../../utils/thread_pool/ThreadPool.h"
+#include "../solid/mesh/SolidMesh.h"
+#include "SdfGrid.h"
+
+namespace unreal_fluid::physics::boundary {
+  /// @brief Turns a triangle mesh into a narrow band signed distance grid.
+  /// @details Nodes closer than a cell diagonal to a triangle get exact distances, every thread
+  /// handles its own layers of nodes. The rest of the band is filled with parallel fast sweeping:
+  /// an eikonal update swept over the grid in 8 directions. Every sweep walks x lines, lines whose
+  /// y and z sum up to the same level do not depend on each other and are updated by all threads.
+  /// Distances beyond the band are clamped to its width.
+  /// Inside is what can not be reached from the grid border without passing closer than half a cell
+  /// to the surface, so meshes which are not closed come out with positive distances only.
+  ///
+  /// Baking takes seconds for detailed meshes, so load() keeps grids on disk under a hash of
+  /// the triangles and bake settings and reads them back on the next run.
+  class MeshSdfBaker {
+  public:
+    /// @brief bakes grid covering the mesh and its band
+    /// @param cellSize distance between nodes
+    /// @param bandCells width of the band in cells, it must be wider than particles colliding with the mesh
+    static std::unique_ptr<SdfGrid> bake(const solid::SolidMesh &mesh, double cellSize, int bandCells, utils::ThreadPool &pool);
+
+    /// @brief reads grid of the mesh from the cache directory, bakes and stores it there if it is missing
+    static std::unique_ptr<SdfGrid> load(const solid::SolidMesh &mesh, double cellSize, int bandCells,
+                                         std::string_view cacheDirectory, utils::ThreadPool &pool);
+
+    /// @brief returns hash of triangles and bake settings, names the cached grid
+    static uint64_t hash(const solid::SolidMesh &mesh, double cellSize, int bandCells);
+  };
+} // namespace unreal_fluid::physics::boundary
+
+// end of MeshSdfBaker.h
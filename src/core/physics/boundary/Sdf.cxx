@@ -0,0 +1,33 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : Sdf.cxx
+ * PURPOSE   : signed distance field interface
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "Sdf.h"
+
+using namespace unreal_fluid::physics::boundary;
+
+vec3 Sdf::gradient(const vec3 &point) const {
+  const double step = 1e-4;
+
+  vec3 result = {distance(point + vec3(step, 0, 0)) - distance(point - vec3(step, 0, 0)),
+                 distance(point + vec3(0, step, 0)) - distance(point - vec3(0, step, 0)),
+                 distance(point + vec3(0, 0, step)) - distance(point - vec3(0, 0, step))};
+  return result / (2 * step);
+}
+
+void Sdf::distances(const vec3r *points, size_t count, const vec3 &offset, double *out) const {
+  for (size_t point = 0; point < count; ++point)
+    out[point] = distance(vec3(points[point]) + offset);
+}
+
+// end of Sdf.cxx
@@ -0,0 +1,52 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : Sdf.h
+ * PURPOSE   : signed distance field interface
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "../PhysicsDefinitions.h"
+
+namespace unreal_fluid::physics::boundary {
+  /// @brief Signed distance field of a solid.
+  /// @details Distance is negative inside the solid and positive outside, gradient points outside.
+  class Sdf {
+  public:
+    virtual ~Sdf() = default;
+
+    /// @brief returns signed distance from point to surface
+    [[nodiscard]] virtual double distance(const vec3 &point) const = 0;
+
+    /// @brief returns gradient of distance, unit length near the surface
+    /// @details default implementation uses central differences
+    [[nodiscard]] virtual vec3 gradient(const vec3 &point) const;
+
+    /// @brief writes distances of count points moved by offset to out
+    /// @details one virtual call for many points, shapes override it with a loop the compiler can vectorise
+    virtual void distances(const vec3r *points, size_t count, const vec3 &offset, double *out) const;
+  };
+
+  /// @brief Implements batched distances of a shape with its own non-virtual distance.
+  template<typename Shape>
+  class AnalyticSdf : public Sdf {
+  public:
+    void distances(const vec3r *points, size_t count, const vec3 &offset, double *out) const override {
+      const auto &shape = static_cast<const Shape &>(*this);
+      for (size_t point = 0; point < count; ++point)
+        out[point] = shape.Shape::distance(vec3(points[point]) + offset);
+    }
+  };
+} // namespace unreal_fluid::physics::boundary
+
+// end of Sdf.h
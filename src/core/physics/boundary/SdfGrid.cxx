@@ -0,0 +1,138 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : SdfGrid.cxx
+ * PURPOSE   : signed distance field sampled on a regular grid
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "SdfGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+using namespace unreal_fluid::physics::boundary;
+
+namespace {
+  constexpr char fileTag[8] = {'U', 'F', 'S', 'D', 'F', 'G', 'R', '1'};
+
+  /// @brief header of saved grid, values follow it
+  struct FileHeader {
+    char tag[8];
+    double min[3];
+    double cellSize;
+    int32_t size[3];
+  };
+} // namespace
+
+SdfGrid::SdfGrid(vec3 min, double cellSize, int nodesX, int nodesY, int nodesZ) : min(min),
+                                                                                  cellSize(cellSize),
+                                                                                  inverseCellSize(1 / cellSize),
+                                                                                  sizeX(std::max(nodesX, 2)),
+                                                                                  sizeY(std::max(nodesY, 2)),
+                                                                                  sizeZ(std::max(nodesZ, 2)),
+                                                                                  values(size_t(sizeX) * sizeY * sizeZ, 0.0f) {}
+
+SdfGrid SdfGrid::sample(const Sdf &sdf, vec3 min, vec3 max, double cellSize) {
+  vec3 size = max - min;
+  SdfGrid grid(min, cellSize,
+               int(std::ceil(size.x / cellSize)) + 1,
+               int(std::ceil(size.y / cellSize)) + 1,
+               int(std::ceil(size.z / cellSize)) + 1);
+
+  for (int z = 0; z < grid.sizeZ; ++z)
+    for (int y = 0; y < grid.sizeY; ++y)
+      for (int x = 0; x < grid.sizeX; ++x)
+        grid.setValue(x, y, z, sdf.distance(min + vec3(x, y, z) * cellSize));
+
+  return grid;
+}
+
+double SdfGrid::interpolate(const vec3 &point, vec3 *gradient) const {
+  /* cell coordinates, clamped so the last cell is used up to the far nodes */
+  double cx = std::clamp((point.x - min.x) * inverseCellSize, 0.0, double(sizeX - 1));
+  double cy = std::clamp((point.y - min.y) * inverseCellSize, 0.0, double(sizeY - 1));
+  double cz = std::clamp((point.z - min.z) * inverseCellSize, 0.0, double(sizeZ - 1));
+
+  int x = std::min(int(cx), sizeX - 2);
+  int y = std::min(int(cy), sizeY - 2);
+  int z = std::min(int(cz), sizeZ - 2);
+  double fx = cx - x, fy = cy - y, fz = cz - z;
+
+  size_t base = index(x, y, z);
+  size_t dy = sizeX, dz = size_t(sizeX) * sizeY;
+  double v000 = values[base], v100 = values[base + 1];
+  double v010 = values[base + dy], v110 = values[base + dy + 1];
+  double v001 = values[base + dz], v101 = values[base + dz + 1];
+  double v011 = values[base + dy + dz], v111 = values[base + dy + dz + 1];
+
+  double x00 = v000 + (v100 - v000) * fx, x10 = v010 + (v110 - v010) * fx;
+  double x01 = v001 + (v101 - v001) * fx, x11 = v011 + (v111 - v011) * fx;
+  double y0 = x00 + (x10 - x00) * fy, y1 = x01 + (x11 - x01) * fy;
+
+  if (gradient) {
+    double gx = ((v100 - v000) * (1 - fy) + (v110 - v010) * fy) * (1 - fz) +
+                ((v101 - v001) * (1 - fy) + (v111 - v011) * fy) * fz;
+    double gy = (x10 - x00) * (1 - fz) + (x11 - x01) * fz;
+    double gz = y1 - y0;
+    *gradient = vec3(gx, gy, gz) * inverseCellSize;
+  }
+
+  return y0 + (y1 - y0) * fz;
+}
+
+double SdfGrid::distance(const vec3 &point) const {
+  vec3 max = min + vec3(sizeX - 1, sizeY - 1, sizeZ - 1) * cellSize;
+  vec3 clamped = {std::clamp(point.x, min.x, max.x), std::clamp(point.y, min.y, max.y), std::clamp(point.z, min.z, max.z)};
+
+  return interpolate(clamped, nullptr) + std::sqrt((point - clamped).len2());
+}
+
+vec3 SdfGrid::gradient(const vec3 &point) const {
+  vec3 result;
+  (void) interpolate(point, &result);
+
+  double length2 = result.len2();
+  return length2 > 0 ? result / std::sqrt(length2) : vec3(0, 1, 0);
+}
+
+void SdfGrid::distances(const vec3r *points, size_t count, const vec3 &offset, double *out) const {
+  for (size_t point = 0; point < count; ++point)
+    out[point] = SdfGrid::distance(vec3(points[point]) + offset);
+}
+
+bool SdfGrid::save(std::ostream &stream) const {
+  FileHeader header{};
+  std::memcpy(header.tag, fileTag, sizeof(fileTag));
+  header.min[0] = min.x, header.min[1] = min.y, header.min[2] = min.z;
+  header.cellSize = cellSize;
+  header.size[0] = sizeX, header.size[1] = sizeY, header.size[2] = sizeZ;
+
+  stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  stream.write(reinterpret_cast<const char *>(values.data()), std::streamsize(values.size() * sizeof(float)));
+  return bool(stream);
+}
+
+std::unique_ptr<SdfGrid> SdfGrid::load(std::istream &stream) {
+  FileHeader header{};
+  if (!stream.read(reinterpret_cast<char *>(&header), sizeof(header))) return nullptr;
+  if (std::memcmp(header.tag, fileTag, sizeof(fileTag)) != 0 || !(header.cellSize > 0)) return nullptr;
+  if (header.size[0] < 2 || header.size[1] < 2 || header.size[2] < 2) return nullptr;
+
+  auto grid = std::make_unique<SdfGrid>(vec3(header.min[0], header.min[1], header.min[2]), header.cellSize,
+                                        header.size[0], header.size[1], header.size[2]);
+  auto bytes = std::streamsize(grid->values.size() * sizeof(float));
+  if (!stream.read(reinterpret_cast<char *>(grid->values.data()), bytes)) return nullptr;
+
+  return grid;
+}
+
+// end of SdfGrid.cxx
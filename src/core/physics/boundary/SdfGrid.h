@@ -0,0 +1,79 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : SdfGrid.h
+ * PURPOSE   : signed distance field sampled on a regular grid
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "Sdf.h"
+
+namespace unreal_fluid::physics::boundary {
+  /// @brief Distances sampled in nodes of a regular grid.
+  /// @details Distance between nodes is interpolated trilinearly, gradient is the normalised gradient
+  /// of the interpolation. Outside of the grid distance of the closest node cell is increased by
+  /// distance to the grid box, so far points are never taken for points inside the solid.
+  class SdfGrid : public Sdf {
+  private:
+    vec3 min;
+    double cellSize;
+    double inverseCellSize;
+    int sizeX, sizeY, sizeZ; // amount of nodes along axes
+    std::vector<float> values;
+
+  public:
+    /// @brief creates grid with all distances equal to zero
+    /// @param min position of the first node
+    /// @param nodes amount of nodes along x, y and z, at least 2 on every axis
+    SdfGrid(vec3 min, double cellSize, int nodesX, int nodesY, int nodesZ);
+
+    /// @brief samples sdf in nodes of a grid covering box from min to max
+    static SdfGrid sample(const Sdf &sdf, vec3 min, vec3 max, double cellSize);
+
+    /// @brief sets distance in node with given indices
+    void setValue(int x, int y, int z, double value) { values[index(x, y, z)] = float(value); }
+
+    [[nodiscard]] double getValue(int x, int y, int z) const { return values[index(x, y, z)]; }
+
+    [[nodiscard]] const vec3 &getMin() const { return min; }
+    [[nodiscard]] double getCellSize() const { return cellSize; }
+    [[nodiscard]] int getSizeX() const { return sizeX; }
+    [[nodiscard]] int getSizeY() const { return sizeY; }
+    [[nodiscard]] int getSizeZ() const { return sizeZ; }
+
+    /// @brief writes grid in binary form
+    /// @return true on success
+    bool save(std::ostream &stream) const;
+
+    /// @brief reads grid written by save()
+    /// @return nullptr if the stream does not hold a grid
+    static std::unique_ptr<SdfGrid> load(std::istream &stream);
+
+    /// @brief interpolates distance and its gradient at point clamped to the grid
+    /// @details gradient is not normalised, one call costs one trilinear sample
+    /// @return distance, gradient is written if it is not null
+    [[nodiscard]] double interpolate(const vec3 &point, vec3 *gradient) const;
+
+    [[nodiscard]] double distance(const vec3 &point) const override;
+    [[nodiscard]] vec3 gradient(const vec3 &point) const override;
+    void distances(const vec3r *points, size_t count, const vec3 &offset, double *out) const override;
+
+  private:
+    [[nodiscard]] size_t index(int x, int y, int z) const { return (size_t(z) * sizeY + y) * sizeX + x; }
+  };
+} // namespace unreal_fluid::physics::boundary
+
+// end of SdfGrid.h
@@ -16,7 +16,7 @@
 
 #include <vector>
 #include "../IPhysicalObject.h"
-#include "Particle.h"
+#include "ParticleStorage.h"
 
 namespace unreal_fluid::physics::fluid {
 
@@ -26,9 +26,12 @@ namespace unreal_fluid::physics::fluid {
     };
 
     class IFluidContainer : public IPhysicalObject {
+    public:
+        /// @brief returns particles stored in the container
+        ParticleStorage &getParticles() { return particles; }
 
     protected:
-        std::vector<Particle *> particles;
+        ParticleStorage particles;
     };
 
 } // namespace unreal_fluid::physics::fluid
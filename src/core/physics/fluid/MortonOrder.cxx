@@ -0,0 +1,77 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : MortonOrder.cxx
+ * PURPOSE   : Z-order sorting of particle storage
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "MortonOrder.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace unreal_fluid::physics::fluid;
+
+namespace {
+  constexpr int keyBits = 21;
+  constexpr int keyBias = 1 << (keyBits - 1);
+
+  /// @brief spreads lower 21 bits of value so there are two zero bits between every two of them
+  uint64_t spreadBits(uint64_t value) {
+    value &= 0x1fffff;
+    value = (value | value << 32) & 0x1f00000000ffff;
+    value = (value | value << 16) & 0x1f0000ff0000ff;
+    value = (value | value << 8) & 0x100f00f00f00f00f;
+    value = (value | value << 4) & 0x10c30c30c30c30c3;
+    value = (value | value << 2) & 0x1249249249249249;
+    return value;
+  }
+} // namespace
+
+bool MortonOrder::sort(ParticleStorage &particles) {
+  double averageRadius = 0;
+  for (double radius: particles.radii) averageRadius += radius;
+  if (!particles.empty()) averageRadius /= particles.size();
+
+  return sort(particles, averageRadius > 0 ? 2.5 * averageRadius : 1);
+}
+
+bool MortonOrder::sort(ParticleStorage &particles, double cellSize) {
+  double inverseCellSize = 1 / cellSize;
+  auto toCell = [&](double coordinate) {
+    double cell = std::floor(coordinate * inverseCellSize);
+    return static_cast<int>(std::clamp(cell, double(-keyBias), double(keyBias - 1)));
+  };
+
+  keys.resize(particles.size());
+  for (size_t slot = 0; slot < particles.size(); ++slot) {
+    const vec3r &position = particles.positions[slot];
+    keys[slot] = {encode(toCell(position.x), toCell(position.y), toCell(position.z)), static_cast<uint32_t>(slot)};
+  }
+
+  if (std::is_sorted(keys.begin(), keys.end())) return false;
+  std::sort(keys.begin(), keys.end());
+
+  order.resize(keys.size());
+  for (size_t slot = 0; slot < keys.size(); ++slot)
+    order[slot] = keys[slot].second;
+
+  particles.reorder(order);
+  return true;
+}
+
+uint64_t MortonOrder::encode(int x, int y, int z) {
+  /* bias makes negative coordinates go before positive ones */
+  return spreadBits(uint64_t(x + keyBias)) |
+         spreadBits(uint64_t(y + keyBias)) << 1 |
+         spreadBits(uint64_t(z + keyBias)) << 2;
+}
+
+// end of MortonOrder.cxx
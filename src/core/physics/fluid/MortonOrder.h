@@ -0,0 +1,50 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : MortonOrder.h
+ * PURPOSE   : Z-order sorting of particle storage
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "ParticleStorage.h"
+
+namespace unreal_fluid::physics::fluid {
+  /// @brief Sorts particle storage by Morton (Z-order) key of particle cells.
+  /// @details Particles close in space get close slots, so neighbour loops read nearby memory.
+  /// Ties are broken by old slot, so the result does not depend on anything but positions.
+  class MortonOrder {
+  private:
+    std::vector<std::pair<uint64_t, uint32_t>> keys;
+    std::vector<uint32_t> order;
+
+  public:
+    MortonOrder() = default;
+    ~MortonOrder() = default;
+
+    /// @brief reorders particles with cell size picked from average particle radius, as SpatialGrid does
+    /// @return false if particles already were in order and nothing was moved
+    bool sort(ParticleStorage &particles);
+
+    /// @brief reorders particles
+    /// @param cellSize size of a cell, particles of one cell keep their relative order
+    /// @return false if particles already were in order and nothing was moved
+    bool sort(ParticleStorage &particles, double cellSize);
+
+    /// @brief interleaves bits of cell coordinates, every coordinate keeps its lower 21 bits
+    static uint64_t encode(int x, int y, int z);
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of MortonOrder.h
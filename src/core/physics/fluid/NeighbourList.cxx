@@ -0,0 +1,51 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : NeighbourList.cxx
+ * PURPOSE   : per-particle neighbour lists
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "NeighbourList.h"
+
+using namespace unreal_fluid::physics::fluid;
+
+void NeighbourList::build(const SpatialGrid &grid, const ParticleStorage &particles, double radius, utils::ThreadPool &pool) {
+  size_t count = particles.size();
+  double radius2 = radius * radius;
+
+  auto isNeighbour = [&](uint32_t i, uint32_t j) {
+    return (particles.positions[i] - particles.positions[j]).len2() < radius2;
+  };
+
+  /* count, pairs of one colour never share a particle, so counters are not shared either */
+  cursors.assign(count, 0);
+  grid.forEachPairParallel(pool, [&](uint32_t i, uint32_t j) {
+    if (!isNeighbour(i, j)) return;
+    cursors[i]++;
+    cursors[j]++;
+  });
+
+  offsets.resize(count + 1);
+  offsets[0] = 0;
+  for (size_t particle = 0; particle < count; ++particle) {
+    offsets[particle + 1] = offsets[particle] + cursors[particle];
+    cursors[particle] = offsets[particle];
+  }
+
+  /* fill, pairs come in the same order for any amount of threads */
+  neighbours.resize(offsets[count]);
+  grid.forEachPairParallel(pool, [&](uint32_t i, uint32_t j) {
+    if (!isNeighbour(i, j)) return;
+    neighbours[cursors[i]++] = j;
+    neighbours[cursors[j]++] = i;
+  });
+}
+
+// end of NeighbourList.cxx
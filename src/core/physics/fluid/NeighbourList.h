@@ -0,0 +1,51 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : NeighbourList.h
+ * PURPOSE   : per-particle neighbour lists
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "SpatialGrid.h"
+
+namespace unreal_fluid::physics::fluid {
+  /// @brief Neighbours of every particle in one flat array.
+  /// @details Neighbours of particle i are neighbours[offsets[i]] ... neighbours[offsets[i + 1] - 1].
+  /// Every pair is stored twice, once for each particle, so per-particle passes only write to own particle.
+  class NeighbourList {
+  private:
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> cursors;
+    std::vector<uint32_t> neighbours;
+
+  public:
+    NeighbourList() = default;
+    ~NeighbourList() = default;
+
+    /// @brief collects pairs closer than radius
+    /// @param grid grid updated for current positions with cell size not less than radius
+    void build(const SpatialGrid &grid, const ParticleStorage &particles, double radius, utils::ThreadPool &pool);
+
+    /// @brief returns amount of particles the list was built for
+    [[nodiscard]] size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    [[nodiscard]] const uint32_t *begin(size_t particle) const { return neighbours.data() + offsets[particle]; }
+    [[nodiscard]] const uint32_t *end(size_t particle) const { return neighbours.data() + offsets[particle + 1]; }
+
+    /// @brief returns total amount of stored neighbours
+    [[nodiscard]] size_t getNeighboursCount() const { return neighbours.size(); }
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of NeighbourList.h
@@ -0,0 +1,43 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : PairList.h
+ * PURPOSE   : contiguous list of candidate particle pairs
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace unreal_fluid::physics::fluid {
+  /// @brief Pairs of particle indices stored as two columns.
+  /// @details Filled by neighbour search and consumed by batched collision kernels.
+  struct PairList {
+    std::vector<uint32_t> first;
+    std::vector<uint32_t> second;
+
+    [[nodiscard]] size_t size() const { return first.size(); }
+    [[nodiscard]] bool empty() const { return first.empty(); }
+
+    void add(uint32_t a, uint32_t b) {
+      first.push_back(a);
+      second.push_back(b);
+    }
+
+    void clear() {
+      first.clear();
+      second.clear();
+    }
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of PairList.h
@@ -0,0 +1,163 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : ParticleStorage.cxx
+ * PURPOSE   : structure-of-arrays particle storage
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "ParticleStorage.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+
+using namespace unreal_fluid::physics::fluid;
+
+void ParticleStorage::reserve(size_t count) {
+  positions.reserve(count);
+  velocities.reserve(count);
+  radii.reserve(count);
+  masses.reserve(count);
+  ids.reserve(count);
+  slots.reserve(count);
+}
+
+void ParticleStorage::clear() {
+  positions.clear();
+  velocities.clear();
+  radii.clear();
+  masses.clear();
+  ids.clear();
+  slots.clear();
+  freeIds.clear();
+  killed.clear();
+}
+
+size_t ParticleStorage::add(vec3 position, vec3 velocity, double radius, double mass) {
+  size_t slot = append(1);
+
+  positions[slot] = position - origin;
+  velocities[slot] = velocity;
+  radii[slot] = real(radius);
+  masses[slot] = real(mass);
+  return slot;
+}
+
+size_t ParticleStorage::append(size_t count) {
+  size_t first = size();
+
+  positions.resize(first + count, vec3r(0));
+  velocities.resize(first + count, vec3r(0));
+  radii.resize(first + count, 0);
+  masses.resize(first + count, 0);
+  ids.resize(first + count);
+
+  for (size_t slot = first; slot < first + count; ++slot) {
+    if (freeIds.empty()) {
+      ids[slot] = static_cast<uint32_t>(slots.size());
+      slots.push_back(static_cast<uint32_t>(slot));
+    } else {
+      ids[slot] = freeIds.back();
+      slots[freeIds.back()] = static_cast<uint32_t>(slot);
+      freeIds.pop_back();
+    }
+  }
+
+  peakSize = std::max(peakSize, size());
+  return first;
+}
+
+void ParticleStorage::kill(size_t slot) {
+  uint32_t &idSlot = slots[ids[slot]];
+  if (idSlot == noSlot) return;
+
+  idSlot = noSlot;
+  killed.push_back(static_cast<uint32_t>(slot));
+}
+
+bool ParticleStorage::compact() {
+  if (killed.empty()) return false;
+
+  /* going from the last slot down, particle moved into a freed slot is never a killed one */
+  std::sort(killed.begin(), killed.end(), std::greater<>());
+
+  for (uint32_t slot: killed) {
+    freeIds.push_back(ids[slot]);
+
+    size_t last = size() - 1;
+    if (slot != last) {
+      positions[slot] = positions[last];
+      velocities[slot] = velocities[last];
+      radii[slot] = radii[last];
+      masses[slot] = masses[last];
+      ids[slot] = ids[last];
+      slots[ids[slot]] = slot;
+    }
+
+    positions.pop_back();
+    velocities.pop_back();
+    radii.pop_back();
+    masses.pop_back();
+    ids.pop_back();
+  }
+
+  killed.clear();
+  return true;
+}
+
+void ParticleStorage::reorder(const std::vector<uint32_t> &order) {
+  assert(killed.empty());
+
+  std::vector<vec3r> vectors;
+  std::vector<real> scalars;
+  std::vector<uint32_t> indices;
+
+  permute(positions, order, vectors);
+  permute(velocities, order, vectors);
+  permute(radii, order, scalars);
+  permute(masses, order, scalars);
+  permute(ids, order, indices);
+
+  for (size_t slot = 0; slot < ids.size(); ++slot)
+    slots[ids[slot]] = static_cast<uint32_t>(slot);
+}
+
+void ParticleStorage::setOrigin(vec3 newOrigin) {
+  vec3 shift = origin - newOrigin;
+  for (auto &position: positions)
+    position = vec3(position) + shift;
+
+  origin = newOrigin;
+}
+
+bool ParticleStorage::recenter(double cellSize) {
+  if (empty()) return false;
+
+  vec3 centre = {0, 0, 0};
+  for (const auto &position: positions) centre += vec3(position);
+  centre = origin + centre / double(size());
+
+  vec3 newOrigin = {std::floor(centre.x / cellSize) * cellSize,
+                    std::floor(centre.y / cellSize) * cellSize,
+                    std::floor(centre.z / cellSize) * cellSize};
+  if (newOrigin == origin) return false;
+
+  setOrigin(newOrigin);
+  return true;
+}
+
+size_t ParticleStorage::getMemoryUsage() const {
+  return positions.capacity() * sizeof(vec3r) + velocities.capacity() * sizeof(vec3r) +
+         radii.capacity() * sizeof(real) + masses.capacity() * sizeof(real) +
+         (ids.capacity() + slots.capacity() + freeIds.capacity() + killed.capacity()) * sizeof(uint32_t);
+}
+
+// end of ParticleStorage.cxx
@@ -0,0 +1,131 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : ParticleStorage.h
+ * PURPOSE   : structure-of-arrays particle storage
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../PhysicsDefinitions.h"
+
+namespace unreal_fluid::physics::fluid {
+  /// @brief Contiguous particle storage.
+  /// @details Every particle attribute is stored in its own column, particle i is
+  /// the i-th element of each column. Passes over one attribute touch only its column.
+  /// Slots of particles may change when storage is reordered, so code that keeps a particle
+  /// between steps should keep its id and look the slot up with getSlot().
+  ///
+  /// Killing a particle is O(1), killed particles keep their slots until compact() moves the last
+  /// particles into them, and their ids are given to particles added later. Columns never shrink,
+  /// so scenes which spawn and kill particles at the same rate stop allocating at their peak size.
+  ///
+  /// Columns hold physics::real values. Positions are stored relative to a double precision origin,
+  /// which may be moved close to the particles, so single precision keeps its resolution far from
+  /// the world origin. Code comparing positions with world coordinates must subtract the origin.
+  class ParticleStorage {
+  public:
+    std::vector<vec3r> positions; // relative to origin
+    std::vector<vec3r> velocities;
+    std::vector<real> radii;
+    std::vector<real> masses;
+    std::vector<uint32_t> ids; // stable id of the particle in every slot
+
+    /// @brief slot of ids which have no particle
+    static constexpr uint32_t noSlot = std::numeric_limits<uint32_t>::max();
+
+    ParticleStorage() = default;
+    ~ParticleStorage() = default;
+
+    /// @brief returns amount of stored particles
+    [[nodiscard]] size_t size() const { return positions.size(); }
+
+    /// @brief checks if there are no particles
+    [[nodiscard]] bool empty() const { return positions.empty(); }
+
+    /// @brief reserves memory in every column
+    /// @param count amount of particles to reserve memory for
+    void reserve(size_t count);
+
+    /// @brief removes all particles
+    void clear();
+
+    /// @brief appends particle to the end of storage
+    /// @details new particle gets id of a particle removed by compact(), or the next unused id
+    /// @param position position in world coordinates
+    /// @return index of the new particle
+    size_t add(vec3 position, vec3 velocity, double radius, double mass);
+
+    /// @brief appends count particles at once, caller fills their columns
+    /// @details ids are given out as by add(), all other columns are zero
+    /// @return slot of the first new particle
+    size_t append(size_t count);
+
+    /// @brief returns world position of the particle in given slot
+    [[nodiscard]] vec3 getPosition(size_t slot) const { return origin + vec3(positions[slot]); }
+
+    /// @brief returns origin positions are stored relative to
+    [[nodiscard]] const vec3 &getOrigin() const { return origin; }
+
+    /// @brief moves origin, stored positions are shifted so world positions stay the same
+    void setOrigin(vec3 newOrigin);
+
+    /// @brief moves origin to the corner of the cell which contains the centre of particles
+    /// @param cellSize origin is snapped to multiples of it, so small drifts of the centre do not move it
+    /// @return true if origin was moved
+    bool recenter(double cellSize);
+
+    /// @brief returns amount of bytes allocated by columns
+    [[nodiscard]] size_t getMemoryUsage() const;
+
+    /// @brief returns current slot of the particle with given id, noSlot if it was killed
+    [[nodiscard]] size_t getSlot(uint32_t id) const { return slots[id]; }
+
+    /// @brief returns amount of ids given out, every id is below it
+    [[nodiscard]] size_t getIdsCount() const { return slots.size(); }
+
+    /// @brief marks particle for removal, its id has no slot from now on
+    /// @details particle stays in its slot until compact(), killing it twice does nothing
+    void kill(size_t slot);
+
+    /// @brief removes killed particles, last particles are moved to their slots
+    /// @return true if any particle was removed
+    bool compact();
+
+    /// @brief returns the largest amount of particles stored at once
+    [[nodiscard]] size_t getPeakSize() const { return peakSize; }
+
+    /// @brief moves particles to new slots, storage must have no killed particles
+    /// @param order order[slot] is the old slot of the particle which goes to slot, must be a permutation
+    void reorder(const std::vector<uint32_t> &order);
+
+  private:
+    std::vector<uint32_t> slots;   // slot of every id
+    std::vector<uint32_t> freeIds; // ids of removed particles
+    std::vector<uint32_t> killed;  // slots waiting for compact()
+    size_t peakSize = 0;
+    vec3 origin = {0, 0, 0};
+
+    template<typename T>
+    static void permute(std::vector<T> &column, const std::vector<uint32_t> &order, std::vector<T> &scratch) {
+      scratch.reserve(column.capacity()); // columns keep their capacity after the swap
+      scratch.resize(column.size());
+      for (size_t slot = 0; slot < order.size(); ++slot)
+        scratch[slot] = column[order[slot]];
+      column.swap(scratch);
+    }
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of ParticleStorage.h
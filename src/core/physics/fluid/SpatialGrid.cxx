@@ -0,0 +1,178 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : SpatialGrid.cxx
+ * PURPOSE   : sorted uniform grid for neighbour search
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "SpatialGrid.h"
+
+#include <algorithm>
+
+using namespace unreal_fluid::physics::fluid;
+
+namespace {
+  /* every axis is packed into 21 bits of the cell key */
+  constexpr int keyBits = 21;
+  constexpr int keyBias = 1 << (keyBits - 1);
+  constexpr uint32_t bigBucket = UINT32_MAX;
+} // namespace
+
+const int SpatialGrid::halfShell[13][3] = {
+        {1, 0, 0},
+        {-1, 1, 0}, {0, 1, 0}, {1, 1, 0},
+        {-1, -1, 1}, {0, -1, 1}, {1, -1, 1},
+        {-1, 0, 1}, {0, 0, 1}, {1, 0, 1},
+        {-1, 1, 1}, {0, 1, 1}, {1, 1, 1},
+};
+
+void SpatialGrid::update(const ParticleStorage &particles) {
+  double averageRadius = 0;
+  for (double radius: particles.radii) averageRadius += radius;
+  if (!particles.empty()) averageRadius /= particles.size();
+
+  update(particles, averageRadius > 0 ? 2.5 * averageRadius : 1);
+}
+
+void SpatialGrid::update(const ParticleStorage &particles, double newCellSize, double skin) {
+  cellSize = newCellSize;
+  inverseCellSize = 1 / newCellSize;
+
+  auto count = static_cast<uint32_t>(particles.size());
+
+  uint32_t tableSize = 64;
+  while (tableSize < 2 * count) tableSize <<= 1;
+  tableMask = tableSize - 1;
+
+  particleBuckets.resize(count);
+  particleKeys.resize(count);
+  bucketStarts.assign(tableSize + 1, 0);
+  bigParticles.clear();
+  maxSmallRadius = 0;
+
+  /* histogram of buckets */
+  for (uint32_t index = 0; index < count; ++index) {
+    /* small particles are not bigger than half of a cell without skin, so two of them in neighbour cells
+     * are found while they are closer than sum of radii plus skin */
+    if (2 * particles.radii[index] + skin > cellSize) {
+      particleBuckets[index] = bigBucket;
+      bigParticles.push_back({index, 0, 0, 0, 0, 0, 0}); // cells it reaches need maxSmallRadius, they are set below
+      continue;
+    }
+
+    maxSmallRadius = std::max(maxSmallRadius, double(particles.radii[index]));
+
+    const vec3r &position = particles.positions[index];
+    int x = toCell(position.x), y = toCell(position.y), z = toCell(position.z);
+
+    particleKeys[index] = packKey(x, y, z);
+    particleBuckets[index] = hash(x, y, z);
+    bucketStarts[particleBuckets[index] + 1]++;
+  }
+
+  /* big particles reach every small particle they may pair with */
+  for (auto &big: bigParticles) {
+    const vec3r &position = particles.positions[big.index];
+    double reach = particles.radii[big.index] + maxSmallRadius + skin;
+
+    big.minX = toCell(position.x - reach), big.minY = toCell(position.y - reach), big.minZ = toCell(position.z - reach);
+    big.maxX = toCell(position.x + reach), big.maxY = toCell(position.y + reach), big.maxZ = toCell(position.z + reach);
+  }
+
+  /* prefix sums */
+  for (uint32_t bucket = 0; bucket < tableSize; ++bucket)
+    bucketStarts[bucket + 1] += bucketStarts[bucket];
+
+  /* stable scatter, bucketCells is used as a write cursor here */
+  bucketCells.assign(bucketStarts.begin(), bucketStarts.end());
+  sortedIndices.resize(bucketStarts[tableSize]);
+  for (uint32_t index = 0; index < count; ++index) {
+    if (particleBuckets[index] == bigBucket) continue;
+    sortedIndices[bucketCells[particleBuckets[index]]++] = index;
+  }
+
+  /* split buckets into runs of one cell, different cells rarely share a bucket */
+  cells.clear();
+  for (uint32_t bucket = 0; bucket < tableSize; ++bucket) {
+    bucketCells[bucket] = static_cast<uint32_t>(cells.size());
+
+    uint32_t begin = bucketStarts[bucket], end = bucketStarts[bucket + 1];
+    if (begin == end) continue;
+
+    auto first = sortedIndices.begin() + begin, last = sortedIndices.begin() + end;
+    uint64_t firstKey = particleKeys[*first];
+    if (std::any_of(first, last, [&](uint32_t index) { return particleKeys[index] != firstKey; }))
+      std::stable_sort(first, last, [&](uint32_t a, uint32_t b) { return particleKeys[a] < particleKeys[b]; });
+
+    for (uint32_t runBegin = begin; runBegin < end;) {
+      uint64_t key = particleKeys[sortedIndices[runBegin]];
+      uint32_t runEnd = runBegin + 1;
+      while (runEnd < end && particleKeys[sortedIndices[runEnd]] == key) runEnd++;
+
+      const vec3r &position = particles.positions[sortedIndices[runBegin]];
+      cells.push_back({toCell(position.x), toCell(position.y), toCell(position.z), key, runBegin, runEnd});
+      runBegin = runEnd;
+    }
+  }
+  bucketCells[tableSize] = static_cast<uint32_t>(cells.size());
+
+  /* counting sort of cells by colour */
+  auto colourOf = [](const Cell &cell) {
+    auto mod3 = [](int value) { return ((value % 3) + 3) % 3; };
+    return mod3(cell.x) + 3 * mod3(cell.y) + 9 * mod3(cell.z);
+  };
+
+  std::fill(std::begin(colourStarts), std::end(colourStarts), 0);
+  for (const auto &cell: cells)
+    colourStarts[colourOf(cell) + 1]++;
+  for (int colour = 0; colour < coloursCount; ++colour)
+    colourStarts[colour + 1] += colourStarts[colour];
+
+  uint32_t cursors[coloursCount];
+  std::copy(colourStarts, colourStarts + coloursCount, cursors);
+  colouredCells.resize(cells.size());
+  for (uint32_t cell = 0; cell < cells.size(); ++cell)
+    colouredCells[cursors[colourOf(cells[cell])]++] = cell;
+}
+
+const SpatialGrid::Cell *SpatialGrid::findCell(int x, int y, int z) const {
+  if (cells.empty()) return nullptr;
+  if (x < -keyBias || x >= keyBias || y < -keyBias || y >= keyBias || z < -keyBias || z >= keyBias) return nullptr;
+
+  uint32_t bucket = hash(x, y, z);
+  uint64_t key = packKey(x, y, z);
+
+  for (uint32_t cell = bucketCells[bucket]; cell < bucketCells[bucket + 1]; ++cell)
+    if (cells[cell].key == key) return &cells[cell];
+
+  return nullptr;
+}
+
+uint64_t SpatialGrid::packKey(int x, int y, int z) {
+  const uint64_t mask = (uint64_t(1) << keyBits) - 1;
+  return (uint64_t(x + keyBias) & mask) |
+         ((uint64_t(y + keyBias) & mask) << keyBits) |
+         ((uint64_t(z + keyBias) & mask) << (2 * keyBits));
+}
+
+uint32_t SpatialGrid::hash(int x, int y, int z) const {
+  return (uint32_t(x) * 73856093u ^ uint32_t(y) * 19349663u ^ uint32_t(z) * 83492791u) & tableMask;
+}
+
+SpatialGrid::CellRange SpatialGrid::toCellRange(const vec3 &min, const vec3 &max) const {
+  return {toCell(min.x), toCell(min.y), toCell(min.z), toCell(max.x), toCell(max.y), toCell(max.z)};
+}
+
+int SpatialGrid::toCell(double coordinate) const {
+  double cell = std::floor(coordinate * inverseCellSize);
+  return static_cast<int>(std::clamp(cell, double(-keyBias), double(keyBias - 1)));
+}
+
+// end of SpatialGrid.cxx
@@ -0,0 +1,227 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : SpatialGrid.h
+ * PURPOSE   : sorted uniform grid for neighbour search
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../../../utils/thread_pool/ThreadPool.h"
+#include "ParticleStorage.h"
+
+namespace unreal_fluid::physics::fluid {
+  /// @brief Uniform grid over an unbounded domain.
+  /// @details Particles are counting-sorted by a hash of their cell, so the grid is a flat array
+  /// of particle indices plus prefix sums and does not allocate once it reached its working size.
+  /// Every cell is stored once, neighbours are visited with a half-shell stencil, so every pair
+  /// of particles is reported exactly once.
+  /// Cells are also split into 27 colours by their coordinates modulo 3. Pairs reported for two
+  /// cells of one colour never share a particle, so such cells may be processed in parallel.
+  class SpatialGrid {
+  public:
+    /// @brief run of particles sharing one cell
+    struct Cell {
+      int x, y, z;
+      uint64_t key;
+      uint32_t begin, end; // range in sorted indices
+    };
+
+    /// @brief particle that does not fit into a cell and range of cells it may touch
+    struct BigParticle {
+      uint32_t index;
+      int minX, minY, minZ;
+      int maxX, maxY, maxZ;
+    };
+
+    /// @brief cell offsets of the half-shell stencil (the cell itself is not included)
+    static const int halfShell[13][3];
+
+    static constexpr int coloursCount = 27;
+
+  private:
+    double cellSize = 1;
+    double inverseCellSize = 1;
+    uint32_t tableMask = 0;
+
+    std::vector<uint32_t> particleBuckets;
+    std::vector<uint64_t> particleKeys;
+    std::vector<uint32_t> bucketStarts;
+    std::vector<uint32_t> bucketCells;
+    std::vector<uint32_t> sortedIndices;
+    std::vector<Cell> cells;
+    std::vector<uint32_t> colouredCells;
+    uint32_t colourStarts[coloursCount + 1] = {};
+    std::vector<BigParticle> bigParticles;
+    double maxSmallRadius = 0; // the largest radius of particles stored in cells
+
+  public:
+    SpatialGrid() = default;
+    ~SpatialGrid() = default;
+
+    /// @brief rebuilds grid with cell size picked from average particle radius
+    void update(const ParticleStorage &particles);
+
+    /// @brief rebuilds grid
+    /// @details particles whose diameter plus skin exceeds cell size are not stored in cells and are tested
+    /// against every cell they reach instead, that is their radius plus the largest radius of stored particles
+    /// plus skin. Pairs closer than sum of radii plus skin are reported, as no stored pair can be farther
+    /// apart than one cell.
+    /// @param particles particles to distribute
+    /// @param newCellSize size of one cell
+    /// @param skin distance pairs may be apart besides sum of their radii
+    void update(const ParticleStorage &particles, double newCellSize, double skin = 0);
+
+    /// @brief calls callback(first, second) once for every pair of particles that may touch
+    template<typename Callback>
+    void forEachPair(Callback &&callback) const {
+      forEachBigParticlePair(callback);
+
+      for (const auto &cell: cells)
+        forEachPairInCell(cell, callback);
+    }
+
+    /// @brief same as forEachPair, but cells of one colour are processed by all threads of the pool
+    /// @details Big particles are processed first by the calling thread, then colours go one by one.
+    /// Order of pairs inside one cell does not depend on amount of threads, so the result does not either.
+    template<typename Callback>
+    void forEachPairParallel(utils::ThreadPool &pool, Callback &&callback) const {
+      forEachBigParticlePair(callback);
+
+      forEachCellParallel(pool, [&](const Cell &cell, unsigned) {
+        forEachPairInCell(cell, callback);
+      });
+    }
+
+    /// @brief calls callback(cell, threadIndex) for every cell, colour by colour
+    /// @details cells of one colour are split between threads of the pool
+    template<typename Callback>
+    void forEachCellParallel(utils::ThreadPool &pool, Callback &&callback) const {
+      for (int colour = 0; colour < coloursCount; ++colour) {
+        uint32_t colourBegin = colourStarts[colour];
+        pool.parallelFor(colourStarts[colour + 1] - colourBegin, [&](size_t begin, size_t end, unsigned thread) {
+          for (size_t cell = begin; cell < end; ++cell)
+            callback(cells[colouredCells[colourBegin + cell]], thread);
+        });
+      }
+    }
+
+    /// @brief calls callback(first, second) for every pair with a big particle
+    template<typename Callback>
+    void forEachBigParticlePair(Callback &&callback) const {
+      for (size_t big = 0; big < bigParticles.size(); ++big) {
+        const auto &particle = bigParticles[big];
+
+        for (size_t other = big + 1; other < bigParticles.size(); ++other)
+          callback(bigParticles[other].index, particle.index);
+
+        for (int x = particle.minX; x <= particle.maxX; ++x)
+          for (int y = particle.minY; y <= particle.maxY; ++y)
+            for (int z = particle.minZ; z <= particle.maxZ; ++z) {
+              const Cell *cell = findCell(x, y, z);
+              if (cell == nullptr) continue;
+
+              for (uint32_t a = cell->begin; a < cell->end; ++a)
+                callback(sortedIndices[a], particle.index);
+            }
+      }
+    }
+
+    /// @brief calls callback(first, second) for pairs inside the cell and between the cell and its half-shell neighbours
+    template<typename Callback>
+    void forEachPairInCell(const Cell &cell, Callback &&callback) const {
+      for (uint32_t a = cell.begin; a < cell.end; ++a)
+        for (uint32_t b = a + 1; b < cell.end; ++b)
+          callback(sortedIndices[a], sortedIndices[b]);
+
+      for (const auto &offset: halfShell) {
+        const Cell *neighbour = findCell(cell.x + offset[0], cell.y + offset[1], cell.z + offset[2]);
+        if (neighbour == nullptr) continue;
+
+        for (uint32_t a = cell.begin; a < cell.end; ++a)
+          for (uint32_t b = neighbour->begin; b < neighbour->end; ++b)
+            callback(sortedIndices[a], sortedIndices[b]);
+      }
+    }
+
+    /// @brief calls callback(cell) for every stored cell whose particles may touch the box
+    /// @details Box is given in coordinates particles were stored in and is widened by the largest radius
+    /// of stored particles, as they reach no further out of their cells. Boxes covering more cells than stored
+    /// are answered by a scan over stored cells, so a huge box costs no more than the grid itself.
+    template<typename Callback>
+    void forEachCellInBox(const vec3 &min, const vec3 &max, Callback &&callback) const {
+      CellRange range = toCellRange(min - vec3(1, 1, 1) * maxSmallRadius, max + vec3(1, 1, 1) * maxSmallRadius);
+
+      double volume = double(range.maxX - range.minX + 1) * double(range.maxY - range.minY + 1) * double(range.maxZ - range.minZ + 1);
+      if (volume > double(cells.size())) {
+        for (const auto &cell: cells)
+          if (range.contains(cell.x, cell.y, cell.z)) callback(cell);
+      } else {
+        for (int x = range.minX; x <= range.maxX; ++x)
+          for (int y = range.minY; y <= range.maxY; ++y)
+            for (int z = range.minZ; z <= range.maxZ; ++z)
+              if (const Cell *cell = findCell(x, y, z)) callback(*cell);
+      }
+    }
+
+    /// @brief calls callback(index) for every big particle whose range of cells overlaps the box
+    template<typename Callback>
+    void forEachBigParticleInBox(const vec3 &min, const vec3 &max, Callback &&callback) const {
+      CellRange range = toCellRange(min, max);
+
+      for (const auto &particle: bigParticles)
+        if (particle.minX <= range.maxX && particle.maxX >= range.minX && particle.minY <= range.maxY &&
+            particle.maxY >= range.minY && particle.minZ <= range.maxZ && particle.maxZ >= range.minZ)
+          callback(particle.index);
+    }
+
+    /// @brief calls callback(index) for every particle which may touch the box
+    template<typename Callback>
+    void forEachParticleInBox(const vec3 &min, const vec3 &max, Callback &&callback) const {
+      forEachCellInBox(min, max, [&](const Cell &cell) {
+        for (uint32_t a = cell.begin; a < cell.end; ++a)
+          callback(sortedIndices[a]);
+      });
+
+      forEachBigParticleInBox(min, max, callback);
+    }
+
+    /// @brief returns cell with given coordinates or nullptr if it is empty
+    [[nodiscard]] const Cell *findCell(int x, int y, int z) const;
+
+    [[nodiscard]] const std::vector<Cell> &getCells() const { return cells; }
+    [[nodiscard]] const std::vector<uint32_t> &getSortedIndices() const { return sortedIndices; }
+    [[nodiscard]] const std::vector<BigParticle> &getBigParticles() const { return bigParticles; }
+    [[nodiscard]] double getCellSize() const { return cellSize; }
+    [[nodiscard]] double getMaxSmallRadius() const { return maxSmallRadius; }
+
+  private:
+    /// @brief inclusive range of cell coordinates
+    struct CellRange {
+      int minX, minY, minZ;
+      int maxX, maxY, maxZ;
+
+      [[nodiscard]] bool contains(int x, int y, int z) const {
+        return x >= minX && x <= maxX && y >= minY && y <= maxY && z >= minZ && z <= maxZ;
+      }
+    };
+
+    [[nodiscard]] CellRange toCellRange(const vec3 &min, const vec3 &max) const;
+
+    static uint64_t packKey(int x, int y, int z);
+    [[nodiscard]] uint32_t hash(int x, int y, int z) const;
+    [[nodiscard]] int toCell(double coordinate) const;
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of SpatialGrid.h
@@ -0,0 +1,162 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : VerletList.cxx
+ * PURPOSE   : persistent candidate pairs with skin distance
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "VerletList.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace unreal_fluid::physics::fluid;
+
+VerletList::VerletList(double skinFactor) : skinFactor(skinFactor) {}
+
+void VerletList::setSkinFactor(double newSkinFactor) {
+  skinFactor = newSkinFactor;
+  stored = false; // next update rebuilds the list with new skin
+}
+
+void VerletList::reset() {
+  stored = false;
+  referencePositions.clear();
+}
+
+bool VerletList::update(const ParticleStorage &particles, utils::ThreadPool &pool) {
+  size_t count = particles.size();
+  size_t known = referencePositions.size();
+
+  double displacement2 = count < known ? std::numeric_limits<double>::infinity() : getMaxDisplacement2(particles, pool);
+  stepsSinceBuild++;
+
+  /* spawning a few particles is cheaper to handle by brute force, than by rebuilding everything */
+  if (stored && count - known <= known / 16 && displacement2 <= skin * skin / 4) {
+    addNewParticles(particles);
+    reusesCount++;
+    return false;
+  }
+
+  /* stored list lasted only one step, or streamed particles moved more than half of skin in one step,
+   * so a new list would not be reused either */
+  bool fast = stored ? stepsSinceBuild == 1 : displacement2 > skin * skin / 4;
+
+  if (fast) rebuildGrid(particles, pool);
+  else build(particles, pool);
+
+  stepsSinceBuild = 0;
+  buildsCount++;
+  return true;
+}
+
+double VerletList::getMaxDisplacement2(const ParticleStorage &particles, utils::ThreadPool &pool) {
+  threadDisplacements.assign(pool.getThreadsCount(), 0);
+  pool.parallelFor(referencePositions.size(), [&](size_t begin, size_t end, unsigned thread) {
+    double maxDisplacement2 = 0;
+    for (size_t particle = begin; particle < end; ++particle)
+      maxDisplacement2 = std::max(maxDisplacement2, double((particles.positions[particle] - referencePositions[particle]).len2()));
+    threadDisplacements[thread] = maxDisplacement2;
+  });
+
+  return *std::max_element(threadDisplacements.begin(), threadDisplacements.end());
+}
+
+void VerletList::build(const ParticleStorage &particles, utils::ThreadPool &pool) {
+  double averageRadius = updateSkin(particles);
+
+  /* particles small for SpatialGrid::update(particles) stay in cells, which are widened by skin,
+   * so their candidates are in neighbour cells and bigger particles are paired by reach */
+  double maxSmallRadius = 0;
+  for (double radius: particles.radii)
+    if (radius <= 1.25 * averageRadius) maxSmallRadius = std::max(maxSmallRadius, radius);
+
+  grid.update(particles, maxSmallRadius > 0 ? 2 * maxSmallRadius + skin : 1, skin);
+  builtCount = particles.size();
+
+  extraPairs.clear();
+  grid.forEachBigParticlePair([&](uint32_t first, uint32_t second) {
+    if (isCandidate(particles, first, second, skin)) extraPairs.add(first, second);
+  });
+
+  /* every thread appends pairs of its cells to its own list, cells remember where their run is */
+  const SpatialGrid::Cell *cells = grid.getCells().data();
+
+  threadPairs.resize(pool.getThreadsCount());
+  for (auto &list: threadPairs) list.clear();
+  cellPairs.resize(grid.getCells().size());
+
+  grid.forEachCellParallel(pool, [&](const SpatialGrid::Cell &cell, unsigned thread) {
+    PairList &list = threadPairs[thread];
+    auto begin = static_cast<uint32_t>(list.size());
+
+    grid.forEachPairInCell(cell, [&](uint32_t first, uint32_t second) {
+      if (isCandidate(particles, first, second, skin)) list.add(first, second);
+    });
+
+    cellPairs[&cell - cells] = {thread, begin, static_cast<uint32_t>(list.size())};
+  });
+
+  referencePositions.assign(particles.positions.begin(), particles.positions.end());
+  stored = true;
+}
+
+void VerletList::rebuildGrid(const ParticleStorage &particles, utils::ThreadPool &pool) {
+  updateSkin(particles);
+  grid.update(particles);
+
+  extraPairs.clear();
+  grid.forEachBigParticlePair([&](uint32_t first, uint32_t second) { extraPairs.add(first, second); });
+
+  threadPairs.resize(pool.getThreadsCount());
+
+  /* positions of this step are compared with the next one to see if particles slowed down */
+  referencePositions.assign(particles.positions.begin(), particles.positions.end());
+  stored = false;
+}
+
+double VerletList::updateSkin(const ParticleStorage &particles) {
+  double averageRadius = 0;
+  for (double radius: particles.radii) averageRadius += radius;
+  if (!particles.empty()) averageRadius /= particles.size();
+
+  skin = skinFactor * averageRadius;
+  return averageRadius;
+}
+
+void VerletList::addNewParticles(const ParticleStorage &particles) {
+  for (auto particle = static_cast<uint32_t>(referencePositions.size()); particle < particles.size(); ++particle) {
+    referencePositions.push_back(particles.positions[particle]);
+
+    /* the grid keeps particles at their reference positions, every particle stays within half of skin of its one
+     * until the next build, so pairs closer than skin there are all pairs which may touch before it */
+    vec3 position = vec3(particles.positions[particle]);
+    vec3 reach = vec3(1, 1, 1) * (particles.radii[particle] + skin);
+
+    grid.forEachParticleInBox(position - reach, position + reach, [&](uint32_t other) {
+      if (isReferenceCandidate(particles, other, particle)) extraPairs.add(other, particle);
+    });
+
+    for (auto other = static_cast<uint32_t>(builtCount); other < particle; ++other)
+      if (isReferenceCandidate(particles, other, particle)) extraPairs.add(other, particle);
+  }
+}
+
+bool VerletList::isReferenceCandidate(const ParticleStorage &particles, uint32_t first, uint32_t second) const {
+  double reach = particles.radii[first] + particles.radii[second] + skin;
+  return (referencePositions[first] - referencePositions[second]).len2() < reach * reach;
+}
+
+bool VerletList::isCandidate(const ParticleStorage &particles, uint32_t first, uint32_t second, double skin) {
+  double reach = particles.radii[first] + particles.radii[second] + skin;
+  return (particles.positions[first] - particles.positions[second]).len2() < reach * reach;
+}
+
+// end of VerletList.cxx
@@ -0,0 +1,134 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : VerletList.h
+ * PURPOSE   : persistent candidate pairs with skin distance
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PairList.h"
+#include "SpatialGrid.h"
+
+namespace unreal_fluid::physics::fluid {
+  /// @brief Candidate pairs which stay valid for several steps.
+  /// @details Pairs closer than sum of radii plus skin are collected with a spatial grid and kept
+  /// until some particle moves more than half of the skin away from its position at the build.
+  /// Until then no pair of particles can start touching without being in the list.
+  /// Pairs are grouped by grid cells of the build, so cells of one colour may still be processed
+  /// in parallel, see SpatialGrid. Particles appended after the build look up their candidates in the grid
+  /// of the build and among each other, their pairs go to a separate list, so a few spawned particles
+  /// do not force a rebuild.
+  ///
+  /// Storing pairs costs more than streaming them from the grid once. While particles move so fast
+  /// that a list would not survive the next step, the grid is rebuilt every step and its pairs
+  /// are passed on directly, as if there were no list.
+  class VerletList {
+  private:
+    /// @brief pairs of one grid cell, they are stored in the list of the thread which collected them
+    struct CellPairs {
+      uint32_t thread;
+      uint32_t begin, end;
+    };
+
+    double skinFactor;
+    double skin = 0;
+
+    SpatialGrid grid;
+    bool stored = false;              // pairs are kept in threadPairs, otherwise they are streamed from the grid
+    std::vector<PairList> threadPairs;
+    std::vector<CellPairs> cellPairs; // indexed as cells of the grid
+    PairList extraPairs;              // pairs with big particles and with particles added after the build
+
+    std::vector<vec3r> referencePositions;
+    size_t builtCount = 0;            // particles stored in the grid by the last build
+    std::vector<double> threadDisplacements;
+
+    size_t stepsSinceBuild = 0;
+    size_t buildsCount = 0;
+    size_t reusesCount = 0;
+
+  public:
+    /// @param skinFactor skin distance in average particle radii
+    explicit VerletList(double skinFactor = 2);
+    ~VerletList() = default;
+
+    /// @brief sets skin distance, larger skin gives more candidates, but rarer rebuilds
+    /// @param skinFactor skin distance in average particle radii
+    void setSkinFactor(double skinFactor);
+
+    /// @brief drops stored pairs, must be called when particles change their slots
+    void reset();
+
+    /// @brief rebuilds the list if it is not valid for current positions any more
+    /// @return true if the grid was rebuilt
+    bool update(const ParticleStorage &particles, utils::ThreadPool &pool);
+
+    /// @brief calls callback(first, second, count, threadIndex) with pairs of every cell, colour by colour
+    /// @details first and second point to count pair indices, cells of one colour are split between threads
+    template<typename Callback>
+    void forEachCellPairsParallel(utils::ThreadPool &pool, Callback &&callback) {
+      const SpatialGrid::Cell *cells = grid.getCells().data();
+
+      grid.forEachCellParallel(pool, [&](const SpatialGrid::Cell &cell, unsigned thread) {
+        const PairList *pairs;
+        uint32_t begin = 0, end;
+
+        if (stored) {
+          const CellPairs &range = cellPairs[&cell - cells];
+          pairs = &threadPairs[range.thread];
+          begin = range.begin, end = range.end;
+        } else {
+          PairList &scratch = threadPairs[thread];
+          scratch.clear();
+          grid.forEachPairInCell(cell, [&](uint32_t first, uint32_t second) { scratch.add(first, second); });
+          pairs = &scratch, end = static_cast<uint32_t>(scratch.size());
+        }
+
+        if (begin != end) callback(pairs->first.data() + begin, pairs->second.data() + begin, size_t(end - begin), thread);
+      });
+    }
+
+    /// @brief returns pairs which are not bound to a cell, they must be processed by one thread
+    [[nodiscard]] const PairList &getExtraPairs() const { return extraPairs; }
+
+    /// @brief returns amount of steps the grid was rebuilt at
+    [[nodiscard]] size_t getBuildsCount() const { return buildsCount; }
+
+    /// @brief returns amount of steps stored pairs were reused at
+    [[nodiscard]] size_t getReusesCount() const { return reusesCount; }
+
+  private:
+    /// @brief returns the largest squared distance a particle moved from its reference position
+    [[nodiscard]] double getMaxDisplacement2(const ParticleStorage &particles, utils::ThreadPool &pool);
+
+    /// @brief collects and stores all pairs from scratch
+    void build(const ParticleStorage &particles, utils::ThreadPool &pool);
+
+    /// @brief only rebuilds the grid, pairs are streamed from it
+    void rebuildGrid(const ParticleStorage &particles, utils::ThreadPool &pool);
+
+    /// @brief sets skin from average radius of particles and returns the radius
+    double updateSkin(const ParticleStorage &particles);
+
+    /// @brief collects pairs of particles appended after the build from the grid and among new particles
+    void addNewParticles(const ParticleStorage &particles);
+
+    /// @brief checks pair at reference positions of both particles, as drift is measured from them
+    [[nodiscard]] bool isReferenceCandidate(const ParticleStorage &particles, uint32_t first, uint32_t second) const;
+
+    [[nodiscard]] static bool isCandidate(const ParticleStorage &particles, uint32_t first, uint32_t second, double skin);
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of VerletList.h
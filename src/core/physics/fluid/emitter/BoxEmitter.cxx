@@ -0,0 +1,28 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : BoxEmitter.cxx
+ * PURPOSE   : emitter of particles in a box volume
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "BoxEmitter.h"
+
+using namespace unreal_fluid::physics::fluid;
+
+BoxEmitter::BoxEmitter(EmitterDescriptor descriptor, vec3 min, vec3 max) : Emitter(descriptor),
+                                                                           min(min),
+                                                                           max(max) {}
+
+vec3 BoxEmitter::samplePosition(uint64_t number) const {
+  vec3 size = max - min;
+  return min + vec3(size.x * random(number, 0), size.y * random(number, 1), size.z * random(number, 2));
+}
+
+// end of BoxEmitter.cxx
@@ -5,8 +5,8 @@
 
 /* PROJECT   : UnrealFluidPhysics
  * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
- * FILE NAME : Particle.h
- * PURPOSE   : particle realization
+ * FILE NAME : BoxEmitter.h
+ * PURPOSE   : emitter of particles in a box volume
  *
  * No part of this file may be changed and used without agreement of
  * authors of this project.
@@ -14,17 +14,21 @@
 
 #pragma once
 
-#include "../../../Definitions.h"
+#include "Emitter.h"
 
 namespace unreal_fluid::physics::fluid {
-  class Particle {
+  /// @brief Emits particles uniformly inside an axis aligned box.
+  class BoxEmitter : public Emitter {
+  private:
+    vec3 min, max;
+
   public:
-    vec3 velocity, position;
-    double radius, mass;
+    BoxEmitter(EmitterDescriptor descriptor, vec3 min, vec3 max);
+    ~BoxEmitter() override { wait(); }
 
-    Particle() = default;
-    ~Particle() = default;
+  protected:
+    [[nodiscard]] vec3 samplePosition(uint64_t number) const override;
   };
 } // namespace unreal_fluid::physics::fluid
 
-// end of Particle.h
+// end of BoxEmitter.h
@@ -0,0 +1,40 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : DiskEmitter.cxx
+ * PURPOSE   : emitter of particles on a disk
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "DiskEmitter.h"
+
+#include <cmath>
+
+using namespace unreal_fluid::physics::fluid;
+
+DiskEmitter::DiskEmitter(EmitterDescriptor descriptor, vec3 centre, vec3 normal, double radius) : Emitter(descriptor),
+                                                                                                  centre(centre),
+                                                                                                  radius(radius) {
+  normal.normalizeSelf();
+
+  /* any vector not parallel to the normal gives the first axis */
+  vec3 helper = std::abs(normal.x) < 0.9 ? vec3(1, 0, 0) : vec3(0, 1, 0);
+  tangent = normal.cross(helper).normalized();
+  bitangent = normal.cross(tangent);
+}
+
+vec3 DiskEmitter::samplePosition(uint64_t number) const {
+  /* square root of the radius makes density uniform over the area */
+  double distance = radius * std::sqrt(random(number, 0));
+  double angle = 2 * math::PI * random(number, 1);
+
+  return centre + tangent * (distance * std::cos(angle)) + bitangent * (distance * std::sin(angle));
+}
+
+// end of DiskEmitter.cxx
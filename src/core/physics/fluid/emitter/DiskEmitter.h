@@ -0,0 +1,37 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : DiskEmitter.h
+ * PURPOSE   : emitter of particles on a disk
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include "Emitter.h"
+
+namespace unreal_fluid::physics::fluid {
+  /// @brief Emits particles uniformly over a disk, like a nozzle.
+  /// @details velocity of the descriptor is usually directed along the normal.
+  class DiskEmitter : public Emitter {
+  private:
+    vec3 centre;
+    vec3 tangent, bitangent; // orthonormal axes of the disk plane
+    double radius;
+
+  public:
+    DiskEmitter(EmitterDescriptor descriptor, vec3 centre, vec3 normal, double radius);
+    ~DiskEmitter() override { wait(); }
+
+  protected:
+    [[nodiscard]] vec3 samplePosition(uint64_t number) const override;
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of DiskEmitter.h
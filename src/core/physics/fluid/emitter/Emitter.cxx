@@ -0,0 +1,84 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : Emitter.cxx
+ * PURPOSE   : base class of particle emitters
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "Emitter.h"
+
+#include <cmath>
+
+using namespace unreal_fluid::physics::fluid;
+
+Emitter::Emitter(EmitterDescriptor descriptor) : descriptor(descriptor) {}
+
+Emitter::~Emitter() {
+  /* derived emitters have waited already, samplePosition() is not there anymore */
+  wait();
+}
+
+void Emitter::setRate(double rate) {
+  wait();
+  descriptor.rate = rate;
+}
+
+void Emitter::prepare(double dt) {
+  pending += descriptor.rate * dt;
+  auto count = static_cast<size_t>(std::floor(pending));
+  pending -= double(count);
+
+  batch.resize(count);
+  for (size_t particle = 0; particle < count; ++particle)
+    batch[particle] = samplePosition(emittedCount + particle);
+
+  emittedCount += count;
+  prepared = true;
+}
+
+void Emitter::prepareAsync(double dt) {
+  wait();
+  preparing = std::async(std::launch::async, [this, dt] { prepare(dt); });
+}
+
+void Emitter::wait() {
+  if (preparing.valid()) preparing.wait();
+}
+
+size_t Emitter::write(ParticleStorage &particles, double dt) {
+  if (preparing.valid()) preparing.get();
+  if (!prepared) prepare(dt);
+  prepared = false;
+
+  size_t first = particles.append(batch.size());
+  vec3 origin = particles.getOrigin();
+
+  for (size_t particle = 0; particle < batch.size(); ++particle) {
+    size_t slot = first + particle;
+    particles.positions[slot] = batch[particle] - origin;
+    particles.velocities[slot] = descriptor.velocity;
+    particles.radii[slot] = real(descriptor.particleRadius);
+    particles.masses[slot] = real(descriptor.particleMass);
+  }
+
+  return batch.size();
+}
+
+double Emitter::random(uint64_t number, unsigned component) const {
+  /* SplitMix64 finalizer of the counter, components of one particle are consecutive counters */
+  uint64_t x = descriptor.seed * 0x9e3779b97f4a7c15ull + number * 4 + component;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  x ^= x >> 31;
+
+  return double(x >> 11) * 0x1.0p-53;
+}
+
+// end of Emitter.cxx
@@ -0,0 +1,89 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : Emitter.h
+ * PURPOSE   : base class of particle emitters
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <vector>
+
+#include "../ParticleStorage.h"
+
+namespace unreal_fluid::physics::fluid {
+  struct EmitterDescriptor {
+    double rate;            // particles per second
+    double particleRadius;
+    double particleMass;
+    vec3 velocity = {0, 0, 0};
+    uint64_t seed = 0;
+  };
+
+  /// @brief Source of particles with constant rate.
+  /// @details Particles of a step are generated into a batch first and then appended to storage at once.
+  /// Generating does not touch particle storage, so it may run on another thread while the
+  /// container simulates the previous step, see prepareAsync().
+  ///
+  /// Random numbers are hashes of seed and particle number, so the n-th particle of an emitter is
+  /// the same whichever thread generated it and however steps were split into batches.
+  ///
+  /// Generating calls samplePosition(), so a derived emitter must call wait() in its destructor,
+  /// before its members are destroyed under a batch still being generated.
+  class Emitter {
+  private:
+    EmitterDescriptor descriptor;
+    double pending = 0;       // fraction of a particle left from previous steps
+    uint64_t emittedCount = 0;
+
+    std::vector<vec3> batch;
+    bool prepared = false;
+    std::future<void> preparing;
+
+  public:
+    explicit Emitter(EmitterDescriptor descriptor);
+    virtual ~Emitter();
+
+    Emitter(const Emitter &) = delete;
+    Emitter &operator=(const Emitter &) = delete;
+
+    /// @brief sets amount of particles emitted per second
+    /// @details waits for the batch being generated, the new rate is used from the next one
+    void setRate(double rate);
+
+    /// @brief generates positions of particles emitted during dt
+    void prepare(double dt);
+
+    /// @brief runs prepare(dt) on another thread, write() waits for it
+    void prepareAsync(double dt);
+
+    /// @brief waits until the batch started by prepareAsync() is generated
+    void wait();
+
+    /// @brief appends prepared particles to storage, prepares them for dt first if nothing was prepared
+    /// @return amount of added particles
+    size_t write(ParticleStorage &particles, double dt);
+
+    /// @brief returns amount of particles generated since creation
+    [[nodiscard]] uint64_t getEmittedCount() const { return emittedCount; }
+
+  protected:
+    /// @brief returns position of particle with given number
+    /// @details must depend only on the number and random(number, ...) values
+    [[nodiscard]] virtual vec3 samplePosition(uint64_t number) const = 0;
+
+    /// @brief returns random number in [0, 1) for component of particle with given number
+    [[nodiscard]] double random(uint64_t number, unsigned component) const;
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of Emitter.h
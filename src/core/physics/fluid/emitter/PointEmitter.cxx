@@ -0,0 +1,28 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : PointEmitter.cxx
+ * PURPOSE   : emitter of particles around a point
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "PointEmitter.h"
+
+using namespace unreal_fluid::physics::fluid;
+
+PointEmitter::PointEmitter(EmitterDescriptor descriptor, vec3 position, double spread) : Emitter(descriptor),
+                                                                                         position(position),
+                                                                                         spread(spread) {}
+
+vec3 PointEmitter::samplePosition(uint64_t number) const {
+  vec3 offset = {random(number, 0) - 0.5, random(number, 1) - 0.5, random(number, 2) - 0.5};
+  return position + offset * spread;
+}
+
+// end of PointEmitter.cxx
@@ -0,0 +1,37 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : PointEmitter.h
+ * PURPOSE   : emitter of particles around a point
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include "Emitter.h"
+
+namespace unreal_fluid::physics::fluid {
+  /// @brief Emits particles in a small cube around a point.
+  /// @details Particles emitted at exactly one point would never be pushed apart, spread keeps them distinct.
+  class PointEmitter : public Emitter {
+  private:
+    vec3 position;
+    double spread;
+
+  public:
+    /// @param spread edge of the cube particles are emitted in
+    PointEmitter(EmitterDescriptor descriptor, vec3 position, double spread = 0.001);
+    ~PointEmitter() override { wait(); }
+
+  protected:
+    [[nodiscard]] vec3 samplePosition(uint64_t number) const override;
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of PointEmitter.h
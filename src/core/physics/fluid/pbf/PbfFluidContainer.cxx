@@ -0,0 +1,221 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : PbfFluidContainer.cxx
+ * PURPOSE   : position based fluid
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "PbfFluidContainer.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace unreal_fluid::physics::fluid;
+
+PbfFluidContainer::PbfFluidContainer(FluidDescriptor descriptor, PbfParameters parameters) : parameters(parameters) {
+  particleRadius = descriptor.particleRadius > 0 ? descriptor.particleRadius : 0.02;
+
+  double spacing = 2 * particleRadius;
+  particleMass = descriptor.particleMass > 0 ? descriptor.particleMass : parameters.restDensity * spacing * spacing * spacing;
+
+  smoothingRadius = 2 * spacing;
+  kernels = SphKernels(smoothingRadius);
+}
+
+unreal_fluid::physics::IPhysicalObject::Type PbfFluidContainer::getType() {
+  return Type::PBF_FLUID_CONTAINER;
+}
+
+void PbfFluidContainer::addParticle(vec3 position, vec3 velocity) {
+  particles.add(position, velocity, particleRadius, particleMass);
+}
+
+void PbfFluidContainer::fillBox(vec3 min, vec3 max) {
+  double spacing = 2 * particleRadius;
+
+  for (double x = min.x + particleRadius; x <= max.x - particleRadius; x += spacing)
+    for (double y = min.y + particleRadius; y <= max.y - particleRadius; y += spacing)
+      for (double z = min.z + particleRadius; z <= max.z - particleRadius; z += spacing)
+        addParticle({x, y, z});
+}
+
+void PbfFluidContainer::setBounds(vec3 min, vec3 max) {
+  boundsMin = min;
+  boundsMax = max;
+}
+
+void PbfFluidContainer::setIterations(int iterations) {
+  parameters.iterations = std::max(iterations, 1);
+}
+
+void PbfFluidContainer::setThreadsCount(unsigned threadsCount) {
+  threadPool.setThreadsCount(threadsCount);
+}
+
+void PbfFluidContainer::simulate(double dt) {
+  particles.compact();
+  size_t count = particles.size();
+  if (count == 0) return;
+
+  predicted.resize(count);
+  corrections.resize(count);
+  densities.resize(count);
+  lambdas.resize(count);
+
+  threadPool.parallelFor(count, [&](size_t begin, size_t end, unsigned) {
+    for (size_t i = begin; i < end; ++i) {
+      particles.velocities[i] += G * dt;
+      predicted[i] = particles.positions[i] + particles.velocities[i] * dt;
+      clampToBounds(predicted[i]);
+    }
+  });
+
+  /* neighbours are searched around predicted positions, grid reads positions column */
+  std::swap(particles.positions, predicted);
+  grid.update(particles, smoothingRadius);
+  neighbours.build(grid, particles, smoothingRadius, threadPool);
+  std::swap(particles.positions, predicted);
+
+  for (int iteration = 0; iteration < parameters.iterations; ++iteration) {
+    computeLambdas();
+    applyCorrections();
+  }
+
+  updateVelocities(dt);
+}
+
+void PbfFluidContainer::computeLambdas() {
+  double h2 = kernels.getSmoothingRadius2();
+  double inverseRestDensity = 1 / parameters.restDensity;
+
+  threadPool.parallelFor(predicted.size(), [&](size_t begin, size_t end, unsigned) {
+    for (size_t i = begin; i < end; ++i) {
+      double density = particles.masses[i] * kernels.poly6(0);
+      double gradientSum2 = 0;
+      vec3 ownGradient = {0, 0, 0};
+
+      for (auto j = neighbours.begin(i); j != neighbours.end(i); ++j) {
+        vec3 diff = separation(i, *j);
+        double r2 = diff.len2();
+        if (r2 >= h2) continue;
+
+        density += particles.masses[*j] * kernels.poly6(r2);
+
+        vec3 gradient = diff * (particles.masses[*j] * inverseRestDensity * kernels.spikyGradient(r2));
+        gradientSum2 += gradient.len2();
+        ownGradient += gradient;
+      }
+
+      gradientSum2 += ownGradient.len2();
+      densities[i] = density;
+
+      /* unilateral constraint, underdense particles at the free surface are not pulled together */
+      double constraint = std::max(0.0, density * inverseRestDensity - 1);
+      lambdas[i] = -constraint / (gradientSum2 + parameters.relaxation);
+    }
+  });
+}
+
+void PbfFluidContainer::applyCorrections() {
+  double h2 = kernels.getSmoothingRadius2();
+  double inverseRestDensity = 1 / parameters.restDensity;
+  double tensileDistance = parameters.tensileDistance * smoothingRadius;
+  double inverseTensileKernel = 1 / kernels.poly6(tensileDistance * tensileDistance);
+  /* lambda scales as h^2 with mass weighted gradients, artificial pressure is brought to the same units */
+  double tensileStrength = parameters.tensileStrength * kernels.getSmoothingRadius2();
+  double maxCorrection = parameters.maxCorrection * particleRadius / parameters.iterations;
+
+  threadPool.parallelFor(predicted.size(), [&](size_t begin, size_t end, unsigned) {
+    for (size_t i = begin; i < end; ++i) {
+      vec3 correction = {0, 0, 0};
+
+      for (auto j = neighbours.begin(i); j != neighbours.end(i); ++j) {
+        vec3 diff = separation(i, *j);
+        double r2 = diff.len2();
+        if (r2 >= h2) continue;
+
+        double tensile = -tensileStrength * std::pow(kernels.poly6(r2) * inverseTensileKernel, parameters.tensilePower);
+        correction += diff * ((lambdas[i] + lambdas[*j] + tensile) * particles.masses[*j] * kernels.spikyGradient(r2));
+      }
+
+      correction *= inverseRestDensity;
+
+      /* Jacobi corrections of a crowded particle overshoot, limited step keeps dt = 0.02 stable */
+      double length = correction.len();
+      corrections[i] = length > maxCorrection ? correction * (maxCorrection / length) : correction;
+    }
+  });
+
+  threadPool.parallelFor(predicted.size(), [&](size_t begin, size_t end, unsigned) {
+    for (size_t i = begin; i < end; ++i) {
+      predicted[i] += corrections[i];
+      clampToBounds(predicted[i]);
+    }
+  });
+}
+
+void PbfFluidContainer::updateVelocities(double dt) {
+  double h2 = kernels.getSmoothingRadius2();
+
+  threadPool.parallelFor(predicted.size(), [&](size_t begin, size_t end, unsigned) {
+    for (size_t i = begin; i < end; ++i)
+      particles.velocities[i] = (predicted[i] - particles.positions[i]) / dt;
+  });
+
+  /* XSPH, corrections buffer is reused for smoothed velocities */
+  threadPool.parallelFor(predicted.size(), [&](size_t begin, size_t end, unsigned) {
+    for (size_t i = begin; i < end; ++i) {
+      vec3 smoothing = {0, 0, 0};
+
+      for (auto j = neighbours.begin(i); j != neighbours.end(i); ++j) {
+        double r2 = (predicted[i] - predicted[*j]).len2();
+        if (r2 >= h2) continue;
+
+        smoothing += (particles.velocities[*j] - particles.velocities[i]) *
+                     (particles.masses[*j] / densities[*j] * kernels.poly6(r2));
+      }
+
+      corrections[i] = particles.velocities[i] + smoothing * parameters.xsphViscosity;
+    }
+  });
+
+  std::swap(particles.velocities, corrections);
+  std::swap(particles.positions, predicted);
+}
+
+vec3 PbfFluidContainer::separation(size_t i, size_t j) const {
+  vec3 diff = predicted[i] - predicted[j];
+  double minDistance = 0.2 * particleRadius;
+  double distance2 = diff.len2();
+  if (distance2 >= minDistance * minDistance) return diff;
+
+  /* gradient vanishes with distance, so overlapping particles are kept apart as if they were at minDistance */
+  if (distance2 > 0) return diff * (minDistance / std::sqrt(distance2));
+
+  /* particles clamped into one corner of bounds coincide exactly,
+   * they are split along an axis picked by their indices, opposite for the other particle */
+  double sign = i < j ? minDistance : -minDistance;
+  switch ((i + j) % 3) {
+    case 0: return {sign, 0, 0};
+    case 1: return {0, sign, 0};
+    default: return {0, 0, sign};
+  }
+}
+
+void PbfFluidContainer::clampToBounds(vec3r &position) const {
+  vec3 low = boundsMin - particles.getOrigin() + vec3(particleRadius);
+  vec3 high = boundsMax - particles.getOrigin() - vec3(particleRadius);
+
+  position.x = real(std::clamp(double(position.x), low.x, high.x));
+  position.y = real(std::clamp(double(position.y), low.y, high.y));
+  position.z = real(std::clamp(double(position.z), low.z, high.z));
+}
+
+// end of PbfFluidContainer.cxx
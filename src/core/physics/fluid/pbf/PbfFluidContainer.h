@@ -0,0 +1,107 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : PbfFluidContainer.h
+ * PURPOSE   : position based fluid
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include "../../../../utils/thread_pool/ThreadPool.h"
+#include "../../PhysicsDefinitions.h"
+#include "../IFluidContainer.h"
+#include "../NeighbourList.h"
+#include "../SpatialGrid.h"
+#include "../sph/SphKernels.h"
+
+namespace unreal_fluid::physics::fluid {
+  struct PbfParameters {
+    double restDensity = 1000;
+    int iterations = 4;           // solver iterations per step, more iterations - less compression
+    double relaxation = 1e-6;     // constraint force mixing, keeps lambda finite for lonely particles
+    double xsphViscosity = 0.01;  // XSPH velocity smoothing
+    double tensileStrength = 0.1; // artificial pressure against clumping
+    double tensileDistance = 0.2; // distance of artificial pressure, in smoothing radii
+    int tensilePower = 4;
+    double maxCorrection = 0.8;   // limit of position correction per step, in particle radii
+  };
+
+  /// @brief Position based fluid container.
+  /// @details Every step particles are moved by their velocities, then density constraints are
+  /// solved with Jacobi iterations, velocities are taken from position change and smoothed with XSPH.
+  /// Neighbour lists are built once per step and reused by all iterations.
+  class PbfFluidContainer : public IFluidContainer {
+  private:
+    double particleRadius;
+    double particleMass;
+    double smoothingRadius;
+    PbfParameters parameters;
+    SphKernels kernels;
+
+    vec3 boundsMin = {-0.5, -1, -0.5};
+    vec3 boundsMax = {0.5, 10, 0.5};
+
+    SpatialGrid grid;
+    NeighbourList neighbours;
+    utils::ThreadPool threadPool;
+
+    std::vector<vec3r> predicted;
+    std::vector<vec3r> corrections;
+    std::vector<double> densities;
+    std::vector<double> lambdas;
+
+  public:
+    /// @param descriptor particle radius and mass, zero mass is computed from rest density
+    /// @param parameters solver parameters
+    explicit PbfFluidContainer(FluidDescriptor descriptor, PbfParameters parameters = {});
+    ~PbfFluidContainer() override = default;
+
+    IPhysicalObject::Type getType() override;
+
+    /// @brief adds one particle
+    void addParticle(vec3 position, vec3 velocity = {0, 0, 0});
+
+    /// @brief fills axis-aligned box with particles at rest spacing
+    void fillBox(vec3 min, vec3 max);
+
+    /// @brief sets box which keeps fluid inside
+    void setBounds(vec3 min, vec3 max);
+
+    /// @brief sets amount of constraint iterations per step
+    /// @details fewer iterations are faster, but fluid gets more compressible,
+    /// a single iteration lets a resting pool compress to about twice of rest density
+    void setIterations(int iterations);
+
+    /// @brief sets amount of threads, 0 means all hardware threads
+    void setThreadsCount(unsigned threadsCount);
+
+    [[nodiscard]] const std::vector<double> &getDensities() const { return densities; }
+
+  private:
+    void simulate(double dt) override;
+
+    /// @brief computes density and lambda of every particle from predicted positions
+    void computeLambdas();
+
+    /// @brief computes and applies position corrections
+    void applyCorrections();
+
+    /// @brief updates velocities from positions change and applies XSPH viscosity
+    void updateVelocities(double dt);
+
+    /// @brief returns predicted[i] - predicted[j], not shorter than a fraction of particle radius
+    [[nodiscard]] vec3 separation(size_t i, size_t j) const;
+
+    /// @brief pushes position inside bounds
+    void clampToBounds(vec3r &position) const;
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of PbfFluidContainer.h
@@ -13,73 +13,112 @@
  */
 
 #include "SimpleFluidContainer.h"
-#include <random>
 #include "../../CollisionSolver.h"
+#include "../../boundary/AnalyticSdf.h"
 
 using namespace unreal_fluid::physics::fluid;
 
-SimpleFluidContainer::SimpleFluidContainer(FluidDescriptor descriptor) : distributor(CellsDistributor()) {
+SimpleFluidContainer::SimpleFluidContainer(FluidDescriptor descriptor) {
   k = 0.1;
+  walls.addSolid(std::make_unique<boundary::SdfPlane>(vec3(0, -1, 0), vec3(0, 1, 0)));
   /// TODO : write constructor implementation
 }
 
-SimpleFluidContainer::~SimpleFluidContainer() {
-  for (auto &particle: particles) {
-    delete particle;
-  }
-}
+SimpleFluidContainer::~SimpleFluidContainer() = default;
 
 void SimpleFluidContainer::addExternalForces(double dt) {
-  for (auto &particle: particles) {
-    particle->velocity += G * dt;
+  for (auto &velocity: particles.velocities) {
+    velocity += G * dt;
   }
 }
 
 void SimpleFluidContainer::advect(double dt) {
-  for (auto particle: particles)
-    particle->position += particle->velocity * dt;
-
-  /// TODO this is the temporary measure to prevent particles from falling down. Solids should be used
-  for (auto p: particles) {
-    double push = -1 - p->position.y + p->radius;
-    if (push > 0) {
-      p->position.y += push;
-      p->velocity.y = -k * p->velocity.y;
-    }
+  for (size_t p = 0; p < particles.size(); ++p)
+    particles.positions[p] += particles.velocities[p] * dt;
+
+  walls.resolve(particles, k, threadPool);
+
+  vec3 low = despawnMin - particles.getOrigin(), high = despawnMax - particles.getOrigin();
+  for (size_t p = 0; p < particles.size(); ++p) {
+    const vec3r &position = particles.positions[p];
+    if (position.x < low.x || position.y < low.y || position.z < low.z ||
+        position.x > high.x || position.y > high.y || position.z > high.z)
+      particles.kill(p);
   }
 }
 
+void SimpleFluidContainer::compact() {
+  if (particles.compact()) neighbours.reset();
+}
+
+void SimpleFluidContainer::reorder() {
+  /* the first step sorts too, so particles added in any order are sorted before they are simulated */
+  if (reorderPeriod <= 0 || stepsSinceReorder-- > 0) return;
+  stepsSinceReorder = reorderPeriod - 1;
+
+  bool moved = mortonOrder.sort(particles);
+
+  /* origin is moved in whole metres, so it does not follow every small drift of the particles */
+  if (relativePositions && particles.recenter(1)) moved = true;
+
+  if (moved) neighbours.reset();
+}
+
 void SimpleFluidContainer::interact() {
-  distributor.update(particles);
-
-  for (auto bigParticle: distributor.big_particles) {
-    for (auto particle: particles) {
-      if (particle->position != bigParticle->position &&
-          (particle->position - bigParticle->position).len() <= particle->radius + bigParticle->radius)
-        CollisionSolver::particleWithParticleCollision(particle, bigParticle, k);
-    }
-  }
+  neighbours.update(particles, threadPool);
+
+  CollisionSolver::particlesWithParticlesCollision(particles, neighbours.getExtraPairs(), k);
 
-  for (auto p = distributor.nextPair(); p != CellsDistributor::terminator; p = distributor.nextPair())
-    CollisionSolver::particleWithParticleCollision(p.first, p.second, k);
+  neighbours.forEachCellPairsParallel(threadPool, [this](const uint32_t *first, const uint32_t *second, size_t count, unsigned) {
+    CollisionSolver::particlesWithParticlesCollision(particles, first, second, count, k);
+  });
 }
 
-/// TODO flows and addParticle should be methods of another class
-void SimpleFluidContainer::flows() {
-  for (int i = 0; i < 10; ++i) {
-    addParticle({double(rand() % 100) / 100000, 1, double(rand() % 100) / 100000}, {0, 0, 0}, 0.02, 1);
+void SimpleFluidContainer::emit(double dt) {
+  for (auto &emitter: emitters) {
+    emitter->write(particles, dt);
+    if (asyncEmission) emitter->prepareAsync(dt);
   }
 }
 
 void SimpleFluidContainer::simulate(double dt) {
-  flows();
+  emit(dt);
+  compact();
+  reorder();
   interact();
   addExternalForces(dt);
   advect(dt);
 }
 
-void *SimpleFluidContainer::getData() {
-  return &particles;
+void SimpleFluidContainer::setThreadsCount(unsigned threadsCount) {
+  threadPool.setThreadsCount(threadsCount);
+}
+
+void SimpleFluidContainer::setNeighbourSkin(double skinFactor) {
+  neighbours.setSkinFactor(skinFactor);
+}
+
+void SimpleFluidContainer::setReorderPeriod(int steps) {
+  reorderPeriod = steps;
+  stepsSinceReorder = 0;
+}
+
+Emitter &SimpleFluidContainer::addEmitter(std::unique_ptr<Emitter> emitter) {
+  emitters.push_back(std::move(emitter));
+  return *emitters.back();
+}
+
+void SimpleFluidContainer::setAsyncEmission(bool enabled) {
+  asyncEmission = enabled;
+}
+
+void SimpleFluidContainer::setDespawnBounds(vec3 min, vec3 max) {
+  despawnMin = min;
+  despawnMax = max;
+}
+
+void SimpleFluidContainer::setRelativePositions(bool enabled) {
+  relativePositions = enabled;
 }
 
 unreal_fluid::physics::IPhysicalObject::Type SimpleFluidContainer::getType() {
@@ -87,12 +126,7 @@ unreal_fluid::physics::IPhysicalObject::Type SimpleFluidContainer::getType() {
 }
 
 void SimpleFluidContainer::addParticle(vec3 position, vec3 velocity, double radius, double mass) {
-  auto particle = new Particle;
-  particle->position = position;
-  particle->mass = mass;
-  particle->radius = radius;
-  particle->velocity = velocity;
-  particles.push_back(particle);
+  particles.add(position, velocity, radius, mass);
 }
 
 // end of FluidContainer.cxx
@@ -14,16 +14,34 @@
 
 #pragma once
 
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../../../../utils/thread_pool/ThreadPool.h"
 #include "../../PhysicsDefinitions.h"
 #include "../../Simulator.h"
+#include "../../boundary/Boundary.h"
 #include "../IFluidContainer.h"
-#include "CellsDistributor.h"
+#include "../MortonOrder.h"
+#include "../VerletList.h"
+#include "../emitter/Emitter.h"
 
 namespace unreal_fluid::physics::fluid {
   class SimpleFluidContainer : public IFluidContainer {
   private:
     double k = 0.1;
-    CellsDistributor distributor;
+    VerletList neighbours;
+    MortonOrder mortonOrder;
+    int reorderPeriod = 100;
+    int stepsSinceReorder = 0;
+    bool relativePositions = false;
+    vec3 despawnMin = vec3(-std::numeric_limits<double>::infinity());
+    vec3 despawnMax = vec3(std::numeric_limits<double>::infinity());
+    std::vector<std::unique_ptr<Emitter>> emitters;
+    boundary::Boundary walls;
+    bool asyncEmission = false;
+    utils::ThreadPool threadPool;
 
   public:
     explicit SimpleFluidContainer(FluidDescriptor descriptor);
@@ -31,15 +49,60 @@ namespace unreal_fluid::physics::fluid {
     void simulate(double dt) override;
 
     IPhysicalObject::Type getType() override;
-    void *getData() override;
+
+    /// @brief sets amount of threads used in interaction stage
+    /// @details result of the simulation does not depend on amount of threads
+    /// @param threadsCount amount of threads, 0 means all hardware threads
+    void setThreadsCount(unsigned threadsCount);
+
+    void addParticle(vec3 position, vec3 velocity, double radius, double mass);
+
+    /// @brief sets skin distance of neighbour lists
+    /// @details larger skin gives more candidate pairs, but lists are rebuilt less often
+    /// @param skinFactor skin distance in average particle radii
+    void setNeighbourSkin(double skinFactor);
+
+    /// @brief sets how often particles are sorted in memory by Morton order of their cells
+    /// @details particles change their slots, use ParticleStorage::getSlot to find a particle by id
+    /// @param steps amount of steps between sorts, 0 disables sorting
+    void setReorderPeriod(int steps);
+
+    /// @brief returns walls particles collide with, by default it is the floor plane y = -1
+    boundary::Boundary &getWalls() { return walls; }
+
+    /// @brief adds source of particles, container owns it
+    /// @return the added emitter
+    Emitter &addEmitter(std::unique_ptr<Emitter> emitter);
+
+    /// @brief generates particles of the next step on another thread while the current step is simulated
+    /// @details next batch is generated for dt of the current step
+    void setAsyncEmission(bool enabled);
+
+    /// @brief sets box particles are killed outside of, there are no bounds by default
+    /// @details with bounds emitted particles leave the scene, and amount of particles stops growing
+    void setDespawnBounds(vec3 min, vec3 max);
+
+    /// @brief keeps origin of particle positions close to the particles
+    /// @details origin is moved when particles are reordered, so it needs reorder period above 0.
+    /// Useful with single precision build, when fluid is far from the world origin.
+    void setRelativePositions(bool enabled);
+
+    /// @brief returns neighbour lists, their build and reuse counts show how often the grid was rebuilt
+    [[nodiscard]] const VerletList &getNeighbours() const { return neighbours; }
 
   private:
-    /// @brief adds particles
-    /// @details adds fluid particles from external sources
-    void flows();
+    /// @brief adds particles of all emitters
+    void emit(double dt);
+
+    /// @brief removes particles killed during the previous step
+    void compact();
+
+    /// @brief sorts particles by Morton order once in reorder period
+    void reorder();
 
     /// @brief changes particles positions
-    /// @details for each particle chang its position regarding to its velocity
+    /// @details for each particle chang its position regarding to its velocity, resolves walls
+    /// and kills particles out of despawn bounds
     void advect(double dt);
 
     /// @brief change particles velocities
@@ -47,10 +110,10 @@ namespace unreal_fluid::physics::fluid {
     void addExternalForces(double dt);
 
     /// @brief runs through particles interaction stage
-    /// @details updates distributor, for each pair collides particles
+    /// @details updates neighbour lists, for each pair collides particles.
+    /// Cells of one colour are processed in parallel, see SpatialGrid.
+    /// Candidate pairs of a cell are resolved by one batched kernel call.
     void interact();
-
-    void addParticle(vec3 position, vec3 velocity, double radius, double mass);
   };
 } // namespace unreal_fluid::physics::fluid
 
@@ -0,0 +1,179 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : SphFluidContainer.cxx
+ * PURPOSE   : weakly compressible SPH fluid
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "SphFluidContainer.h"
+
+#include <algorithm>
+
+using namespace unreal_fluid::physics::fluid;
+
+SphFluidContainer::SphFluidContainer(FluidDescriptor descriptor, SphParameters parameters) : parameters(parameters) {
+  particleRadius = descriptor.particleRadius > 0 ? descriptor.particleRadius : 0.02;
+
+  /* particles are placed 2 radii apart, so one particle takes (2r)^3 of volume */
+  double spacing = 2 * particleRadius;
+  particleMass = descriptor.particleMass > 0 ? descriptor.particleMass : parameters.restDensity * spacing * spacing * spacing;
+
+  smoothingRadius = 2 * spacing;
+  kernels = SphKernels(smoothingRadius);
+}
+
+unreal_fluid::physics::IPhysicalObject::Type SphFluidContainer::getType() {
+  return Type::SPH_FLUID_CONTAINER;
+}
+
+void SphFluidContainer::addParticle(vec3 position, vec3 velocity) {
+  particles.add(position, velocity, particleRadius, particleMass);
+}
+
+void SphFluidContainer::fillBox(vec3 min, vec3 max) {
+  double spacing = 2 * particleRadius;
+
+  for (double x = min.x + particleRadius; x <= max.x - particleRadius; x += spacing)
+    for (double y = min.y + particleRadius; y <= max.y - particleRadius; y += spacing)
+      for (double z = min.z + particleRadius; z <= max.z - particleRadius; z += spacing)
+        addParticle({x, y, z});
+}
+
+void SphFluidContainer::setBounds(vec3 min, vec3 max) {
+  boundsMin = min;
+  boundsMax = max;
+}
+
+void SphFluidContainer::setThreadsCount(unsigned threadsCount) {
+  threadPool.setThreadsCount(threadsCount);
+}
+
+void SphFluidContainer::simulate(double dt) {
+  particles.compact();
+  if (particles.empty()) return;
+
+  /* time left over by previous steps is simulated first */
+  double frame = dt;
+  dt += lagTime;
+
+  for (int substep = 0; substep < parameters.maxSubsteps && dt > 0; ++substep) {
+    grid.update(particles, smoothingRadius);
+    computeDensities();
+    computeForces();
+
+    double step = std::min(dt, computeSubstep());
+    integrate(step);
+
+    dt -= step;
+  }
+
+  /* every substep keeps to CFL limit, time which did not fit into maxSubsteps is carried to the next step,
+   * but not more than one step of it, so fluid slows down instead of falling behind forever */
+  if (dt > 0 && lagTime == 0)
+    Logger::logWarning("SPH fluid needs more than", parameters.maxSubsteps, "substeps per step, it runs slower than real time");
+  lagTime = std::max(0.0, std::min(dt, frame));
+}
+
+double SphFluidContainer::computeSubstep() const {
+  double maxSpeed2 = 0;
+  for (const auto &velocity: particles.velocities)
+    maxSpeed2 = std::max(maxSpeed2, double(velocity.len2()));
+
+  double maxAcceleration = G.len();
+  for (const auto &acceleration: accelerations)
+    maxAcceleration = std::max(maxAcceleration, acceleration.len());
+
+  double byVelocity = parameters.courantNumber * smoothingRadius / (parameters.soundSpeed + std::sqrt(maxSpeed2));
+  double byForce = 0.25 * std::sqrt(smoothingRadius / maxAcceleration);
+  return std::min(byVelocity, byForce);
+}
+
+void SphFluidContainer::computeDensities() {
+  size_t count = particles.size();
+  densities.assign(count, particleMass * kernels.poly6(0));
+  pressures.resize(count);
+
+  double h2 = kernels.getSmoothingRadius2();
+  grid.forEachPairParallel(threadPool, [&](uint32_t i, uint32_t j) {
+    double r2 = (particles.positions[i] - particles.positions[j]).len2();
+    if (r2 >= h2) return;
+
+    double w = kernels.poly6(r2);
+    densities[i] += particles.masses[j] * w;
+    densities[j] += particles.masses[i] * w;
+  });
+
+  /* Tait equation, negative pressure is dropped to avoid clumping at the free surface */
+  const double gamma = 7;
+  double stiffness = parameters.restDensity * parameters.soundSpeed * parameters.soundSpeed / gamma;
+  threadPool.parallelFor(count, [&](size_t begin, size_t end, unsigned) {
+    for (size_t i = begin; i < end; ++i) {
+      double ratio = densities[i] / parameters.restDensity;
+      double ratio2 = ratio * ratio, ratio4 = ratio2 * ratio2;
+      pressures[i] = std::max(0.0, stiffness * (ratio4 * ratio2 * ratio - 1));
+    }
+  });
+}
+
+void SphFluidContainer::computeForces() {
+  accelerations.assign(particles.size(), vec3(0, 0, 0));
+
+  double h2 = kernels.getSmoothingRadius2();
+  grid.forEachPairParallel(threadPool, [&](uint32_t i, uint32_t j) {
+    vec3 diff = particles.positions[i] - particles.positions[j];
+    double r2 = diff.len2();
+    if (r2 >= h2 || r2 == 0) return;
+
+    double pressureTerm = pressures[i] / (densities[i] * densities[i]) + pressures[j] / (densities[j] * densities[j]);
+    vec3 pressureForce = diff * (pressureTerm * kernels.spikyGradient(r2));
+
+    vec3 viscosityForce = (particles.velocities[j] - particles.velocities[i]) *
+                          (parameters.viscosity * kernels.viscosityLaplacian(r2));
+
+    accelerations[i] -= pressureForce * particles.masses[j];
+    accelerations[j] += pressureForce * particles.masses[i];
+    accelerations[i] += viscosityForce * (particles.masses[j] / densities[j]);
+    accelerations[j] -= viscosityForce * (particles.masses[i] / densities[i]);
+  });
+}
+
+void SphFluidContainer::integrate(double dt) {
+  const double restitution = 0.1;
+  vec3 localMin = boundsMin - particles.getOrigin(), localMax = boundsMax - particles.getOrigin();
+
+  threadPool.parallelFor(particles.size(), [&](size_t begin, size_t end, unsigned) {
+    for (size_t i = begin; i < end; ++i) {
+      vec3r &velocity = particles.velocities[i];
+      vec3r &position = particles.positions[i];
+
+      velocity += (accelerations[i] + G) * dt;
+      position += velocity * dt;
+
+      real *coordinates[3] = {&position.x, &position.y, &position.z};
+      real *speeds[3] = {&velocity.x, &velocity.y, &velocity.z};
+      double minimums[3] = {localMin.x, localMin.y, localMin.z};
+      double maximums[3] = {localMax.x, localMax.y, localMax.z};
+
+      for (int axis = 0; axis < 3; ++axis) {
+        double low = minimums[axis] + particleRadius, high = maximums[axis] - particleRadius;
+
+        if (*coordinates[axis] < low) {
+          *coordinates[axis] = real(low);
+          if (*speeds[axis] < 0) *speeds[axis] *= -restitution;
+        } else if (*coordinates[axis] > high) {
+          *coordinates[axis] = real(high);
+          if (*speeds[axis] > 0) *speeds[axis] *= -restitution;
+        }
+      }
+    }
+  });
+}
+
+// end of SphFluidContainer.cxx
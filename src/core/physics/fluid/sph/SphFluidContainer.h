@@ -0,0 +1,100 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : SphFluidContainer.h
+ * PURPOSE   : weakly compressible SPH fluid
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include "../../../../utils/thread_pool/ThreadPool.h"
+#include "../../PhysicsDefinitions.h"
+#include "../IFluidContainer.h"
+#include "../SpatialGrid.h"
+#include "SphKernels.h"
+
+namespace unreal_fluid::physics::fluid {
+  struct SphParameters {
+    double restDensity = 1000;
+    double soundSpeed = 10;     // speed of sound, bigger values make fluid less compressible and steps shorter
+    double viscosity = 0.05;    // kinematic viscosity
+    double courantNumber = 0.4; // CFL number used to pick substep length
+    int maxSubsteps = 32;       // time which does not fit into them is carried to the next step
+  };
+
+  /// @brief Weakly compressible SPH container.
+  /// @details Density is computed with poly6 kernel, pressure with Tait equation, pressure forces with
+  /// spiky kernel gradient and viscosity with its laplacian. Kernels are read from precomputed tables.
+  /// Neighbours are found with SpatialGrid with cell size equal to the smoothing radius.
+  /// Step passed by the simulator is split into CFL-limited substeps, time which does not fit into
+  /// maxSubsteps of them is simulated in the next step.
+  class SphFluidContainer : public IFluidContainer {
+  private:
+    double particleRadius;
+    double particleMass;
+    double smoothingRadius;
+    SphParameters parameters;
+    SphKernels kernels;
+
+    vec3 boundsMin = {-0.5, -1, -0.5};
+    vec3 boundsMax = {0.5, 10, 0.5};
+
+    SpatialGrid grid;
+    utils::ThreadPool threadPool;
+
+    std::vector<double> densities;
+    std::vector<double> pressures;
+    std::vector<vec3> accelerations;
+
+    double lagTime = 0; // time left over by the previous step
+
+  public:
+    /// @param descriptor particle radius and mass, zero mass is computed from rest density
+    /// @param parameters fluid parameters
+    explicit SphFluidContainer(FluidDescriptor descriptor, SphParameters parameters = {});
+    ~SphFluidContainer() override = default;
+
+    IPhysicalObject::Type getType() override;
+
+    /// @brief adds one particle
+    void addParticle(vec3 position, vec3 velocity = {0, 0, 0});
+
+    /// @brief fills axis-aligned box with particles at rest spacing
+    void fillBox(vec3 min, vec3 max);
+
+    /// @brief sets box which keeps fluid inside
+    void setBounds(vec3 min, vec3 max);
+
+    /// @brief sets amount of threads, 0 means all hardware threads
+    void setThreadsCount(unsigned threadsCount);
+
+    [[nodiscard]] const std::vector<double> &getDensities() const { return densities; }
+
+    /// @brief returns time the fluid is behind the simulator, it grows when steps need more than maxSubsteps
+    [[nodiscard]] double getLagTime() const { return lagTime; }
+
+  private:
+    void simulate(double dt) override;
+
+    /// @brief returns longest stable substep for current velocities and accelerations
+    [[nodiscard]] double computeSubstep() const;
+
+    /// @brief computes density and pressure of every particle
+    void computeDensities();
+
+    /// @brief computes pressure and viscosity accelerations
+    void computeForces();
+
+    /// @brief moves particles and keeps them inside bounds
+    void integrate(double dt);
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of SphFluidContainer.h
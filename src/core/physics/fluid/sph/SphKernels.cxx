@@ -0,0 +1,56 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : SphKernels.cxx
+ * PURPOSE   : precomputed smoothing kernels
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "SphKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../../../../utils/math/MathHeaders"
+
+using namespace unreal_fluid::physics::fluid;
+
+SphKernels::SphKernels(double smoothingRadius, int resolution) {
+  double h = smoothingRadius;
+  smoothingRadius2 = h * h;
+  scale = (resolution - 1) / smoothingRadius2;
+
+  double poly6Factor = 315 / (64 * math::PI * std::pow(h, 9));
+  double spikyFactor = -45 / (math::PI * std::pow(h, 6));
+  double viscosityFactor = 45 / (math::PI * std::pow(h, 6));
+
+  poly6Table.resize(resolution + 1);
+  spikyTable.resize(resolution + 1);
+  viscosityTable.resize(resolution + 1);
+
+  /* gradient over r grows as 1 / r, so closer than the first sample it would be interpolated
+   * from a huge value at zero - it is held at the first sample instead */
+  double minGradientDistance = std::sqrt(1 / scale);
+
+  for (int sample = 0; sample < resolution; ++sample) {
+    double r2 = sample / scale;
+    double r = std::sqrt(r2);
+
+    poly6Table[sample] = poly6Factor * std::pow(smoothingRadius2 - r2, 3);
+    spikyTable[sample] = spikyFactor * (h - r) * (h - r) / std::max(r, minGradientDistance);
+    viscosityTable[sample] = viscosityFactor * (h - r);
+  }
+
+  /* kernels vanish at the support radius, extra zero sample keeps interpolation in bounds */
+  poly6Table[resolution - 1] = poly6Table[resolution] = 0;
+  spikyTable[resolution - 1] = spikyTable[resolution] = 0;
+  viscosityTable[resolution - 1] = viscosityTable[resolution] = 0;
+}
+
+// end of SphKernels.cxx
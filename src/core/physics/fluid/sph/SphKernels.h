@@ -0,0 +1,60 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : SphKernels.h
+ * PURPOSE   : precomputed smoothing kernels
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace unreal_fluid::physics::fluid {
+  /// @brief Tables of SPH smoothing kernels.
+  /// @details Kernels are sampled over squared distance in [0, h^2], so lookups
+  /// need neither square roots nor powers. Values between samples are interpolated linearly.
+  class SphKernels {
+  private:
+    double smoothingRadius2 = 1;
+    double scale = 0;
+    std::vector<double> poly6Table;
+    std::vector<double> spikyTable;
+    std::vector<double> viscosityTable;
+
+  public:
+    /// @param smoothingRadius h - support radius of kernels
+    /// @param resolution amount of samples in each table
+    explicit SphKernels(double smoothingRadius = 1, int resolution = 1024);
+
+    /// @brief poly6 kernel W(r)
+    [[nodiscard]] double poly6(double r2) const { return lookup(poly6Table, r2); }
+
+    /// @brief spiky kernel gradient divided by r, gradient itself is spikyGradient(r^2) * r_vector
+    [[nodiscard]] double spikyGradient(double r2) const { return lookup(spikyTable, r2); }
+
+    /// @brief laplacian of viscosity kernel
+    [[nodiscard]] double viscosityLaplacian(double r2) const { return lookup(viscosityTable, r2); }
+
+    [[nodiscard]] double getSmoothingRadius2() const { return smoothingRadius2; }
+
+  private:
+    [[nodiscard]] double lookup(const std::vector<double> &table, double r2) const {
+      double position = r2 * scale;
+      auto index = static_cast<size_t>(position);
+      if (index + 1 >= table.size()) return 0;
+
+      double t = position - double(index);
+      return table[index] + (table[index + 1] - table[index]) * t;
+    }
+  };
+} // namespace unreal_fluid::physics::fluid
+
+// end of SphKernels.h
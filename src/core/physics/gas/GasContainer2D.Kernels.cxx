@@ -0,0 +1,344 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : GasContainer2D.Kernels.cxx
+ * PURPOSE   : row kernels of flows and diffusion of 2-dimensional gas
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <initializer_list>
+
+#include "GasContainer2D.h"
+#include "../../../utils/cpu/CpuFeatures.h"
+
+#ifdef UNREAL_FLUID_X86_64
+#include <immintrin.h>
+#endif
+
+using namespace unreal_fluid::physics::gas;
+
+namespace {
+  using unreal_fluid::utils::CpuFeatures;
+
+  /// @brief fields of cells a pair kernel moves gas between, pointers start at the first cell of the first pair
+  struct Cells {
+    double *amount;
+    double *temperature;
+    float *red;
+    float *green;
+    float *blue;
+  };
+
+  template<typename T>
+  T mix(T value, T other, T share) {
+    return value + share * (other - value);
+  }
+
+  void calculateFlowsScalar(const double *amount, const double *temperature, double *flowsX, double *flowsY,
+                            size_t stride, size_t width, bool lastRow, double scale) {
+    for (size_t cell = 0; cell + 1 < width; ++cell)
+      flowsX[cell] += (amount[cell] * temperature[cell] - amount[cell + 1] * temperature[cell + 1]) * scale;
+    if (lastRow)
+      return;
+    for (size_t cell = 0; cell < width; ++cell)
+      flowsY[cell] += (amount[cell] * temperature[cell] - amount[cell + stride] * temperature[cell + stride]) * scale;
+  }
+
+  void invertAmountsScalar(const double *amount, double *inverseAmount, size_t width) {
+    for (size_t cell = 0; cell < width; ++cell) {
+      double inverse = 1 / amount[cell];
+      inverseAmount[cell] = amount[cell] != 0 ? inverse : 0;
+    }
+  }
+
+  /// @brief moves flow of pair (first, second) of cells, the target mixes colour and temperature
+  void flowPair(const Cells &cells, size_t first, size_t second, double flow) {
+    double amount1 = cells.amount[first] - flow, amount2 = cells.amount[second] + flow;
+    double share = std::abs(flow) / (flow > 0 ? amount2 : amount1);
+    double share1 = flow < 0 ? share : 0, share2 = flow > 0 ? share : 0;
+
+    double temperature1 = cells.temperature[first], temperature2 = cells.temperature[second];
+    cells.temperature[first] = mix(temperature1, temperature2, share1);
+    cells.temperature[second] = mix(temperature2, temperature1, share2);
+    for (float *color : {cells.red, cells.green, cells.blue}) {
+      float color1 = color[first], color2 = color[second];
+      color[first] = mix(color1, color2, float(share1));
+      color[second] = mix(color2, color1, float(share2));
+    }
+    cells.amount[first] = amount1;
+    cells.amount[second] = amount2;
+  }
+
+  /// @brief exchanges dt * the smaller amount of pair (first, second) of cells, the amounts stay the same
+  void diffusePair(const Cells &cells, const double *inverseAmount, size_t first, size_t second, double dt) {
+    double slice = dt * std::min(cells.amount[first], cells.amount[second]);
+    double share1 = slice * inverseAmount[first], share2 = slice * inverseAmount[second];
+
+    double temperature1 = cells.temperature[first], temperature2 = cells.temperature[second];
+    cells.temperature[first] = mix(temperature1, temperature2, share1);
+    cells.temperature[second] = mix(temperature2, temperature1, share2);
+    for (float *color : {cells.red, cells.green, cells.blue}) {
+      float color1 = color[first], color2 = color[second];
+      color[first] = mix(color1, color2, float(share1));
+      color[second] = mix(color2, color1, float(share2));
+    }
+  }
+
+  void flowPairsScalar(const Cells &cells, const double *flows, size_t offset, size_t step, size_t count) {
+    for (size_t pair = 0, cell = 0; pair < count; ++pair, cell += step)
+      flowPair(cells, cell, cell + offset, flows[cell]);
+  }
+
+  void diffusePairsScalar(const Cells &cells, const double *inverseAmount, size_t offset, size_t step, size_t count,
+                          double dt) {
+    for (size_t pair = 0, cell = 0; pair < count; ++pair, cell += step)
+      diffusePair(cells, inverseAmount, cell, cell + offset, dt);
+  }
+
+#ifdef UNREAL_FLUID_X86_64
+  /* A vector holds four pairs. Pairs across rows are four cells in a row and four cells below them.
+   * Pairs along a row are eight cells in a row, split into first and second cells of pairs, which
+   * leaves pairs in lanes in order 0, 2, 1, 3 for doubles and floats alike. */
+
+  /// @brief order of floats of eight cells of a row: first cells of pairs, then second ones, it is its own inverse
+  UNREAL_FLUID_TARGET_AVX2
+  inline __m256i pairOrder() {
+    return _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7);
+  }
+
+  template<size_t step>
+  UNREAL_FLUID_TARGET_AVX2
+  inline void load(const double *field, size_t offset, __m256d &first, __m256d &second) {
+    if constexpr (step == 1) {
+      first = _mm256_loadu_pd(field);
+      second = _mm256_loadu_pd(field + offset);
+    } else {
+      __m256d low = _mm256_loadu_pd(field), high = _mm256_loadu_pd(field + 4);
+      first = _mm256_unpacklo_pd(low, high);
+      second = _mm256_unpackhi_pd(low, high);
+    }
+  }
+
+  template<size_t step>
+  UNREAL_FLUID_TARGET_AVX2
+  inline __m256d loadFirst(const double *field) {
+    if constexpr (step == 1)
+      return _mm256_loadu_pd(field);
+    else
+      return _mm256_unpacklo_pd(_mm256_loadu_pd(field), _mm256_loadu_pd(field + 4));
+  }
+
+  template<size_t step>
+  UNREAL_FLUID_TARGET_AVX2
+  inline void store(double *field, size_t offset, __m256d first, __m256d second) {
+    if constexpr (step == 1) {
+      _mm256_storeu_pd(field, first);
+      _mm256_storeu_pd(field + offset, second);
+    } else {
+      _mm256_storeu_pd(field, _mm256_unpacklo_pd(first, second));
+      _mm256_storeu_pd(field + 4, _mm256_unpackhi_pd(first, second));
+    }
+  }
+
+  template<size_t step>
+  UNREAL_FLUID_TARGET_AVX2
+  inline void load(const float *field, size_t offset, __m128 &first, __m128 &second) {
+    if constexpr (step == 1) {
+      first = _mm_loadu_ps(field);
+      second = _mm_loadu_ps(field + offset);
+    } else {
+      __m256 cells = _mm256_permutevar8x32_ps(_mm256_loadu_ps(field), pairOrder());
+      first = _mm256_castps256_ps128(cells);
+      second = _mm256_extractf128_ps(cells, 1);
+    }
+  }
+
+  template<size_t step>
+  UNREAL_FLUID_TARGET_AVX2
+  inline void store(float *field, size_t offset, __m128 first, __m128 second) {
+    if constexpr (step == 1) {
+      _mm_storeu_ps(field, first);
+      _mm_storeu_ps(field + offset, second);
+    } else {
+      __m256 cells = _mm256_insertf128_ps(_mm256_castps128_ps256(first), second, 1);
+      _mm256_storeu_ps(field, _mm256_permutevar8x32_ps(cells, pairOrder()));
+    }
+  }
+
+  /// @brief mixes temperature and colour of four pairs with shares of the other cell of a pair
+  template<size_t step>
+  UNREAL_FLUID_TARGET_AVX2
+  inline void mixPairs(const Cells &cells, size_t cell, size_t offset, __m256d share1, __m256d share2) {
+    __m256d temperature1, temperature2;
+    load<step>(cells.temperature + cell, offset, temperature1, temperature2);
+    __m256d difference = _mm256_sub_pd(temperature2, temperature1);
+    store<step>(cells.temperature + cell, offset, _mm256_add_pd(temperature1, _mm256_mul_pd(share1, difference)),
+                _mm256_sub_pd(temperature2, _mm256_mul_pd(share2, difference)));
+
+    __m128 colorShare1 = _mm256_cvtpd_ps(share1), colorShare2 = _mm256_cvtpd_ps(share2);
+    for (float *color : {cells.red, cells.green, cells.blue}) {
+      __m128 color1, color2;
+      load<step>(color + cell, offset, color1, color2);
+      __m128 colorDifference = _mm_sub_ps(color2, color1);
+      store<step>(color + cell, offset, _mm_add_ps(color1, _mm_mul_ps(colorShare1, colorDifference)),
+                  _mm_sub_ps(color2, _mm_mul_ps(colorShare2, colorDifference)));
+    }
+  }
+
+  /// @brief returns pressure of four cells up to a constant factor
+  UNREAL_FLUID_TARGET_AVX2
+  inline __m256d pressure(const double *amount, const double *temperature, size_t cell) {
+    return _mm256_mul_pd(_mm256_loadu_pd(amount + cell), _mm256_loadu_pd(temperature + cell));
+  }
+
+  UNREAL_FLUID_TARGET_AVX2
+  void calculateFlowsAvx2(const double *amount, const double *temperature, double *flowsX, double *flowsY,
+                          size_t stride, size_t width, bool lastRow, double scale) {
+    const __m256d factor = _mm256_set1_pd(scale);
+
+    size_t cell = 0;
+    for (; cell + 4 < width; cell += 4) {
+      __m256d difference = _mm256_sub_pd(pressure(amount, temperature, cell), pressure(amount, temperature, cell + 1));
+      _mm256_storeu_pd(flowsX + cell, _mm256_add_pd(_mm256_loadu_pd(flowsX + cell), _mm256_mul_pd(difference, factor)));
+    }
+    for (; cell + 1 < width; ++cell)
+      flowsX[cell] += (amount[cell] * temperature[cell] - amount[cell + 1] * temperature[cell + 1]) * scale;
+
+    if (lastRow)
+      return;
+    for (cell = 0; cell + 4 <= width; cell += 4) {
+      __m256d difference = _mm256_sub_pd(pressure(amount, temperature, cell), pressure(amount, temperature, cell + stride));
+      _mm256_storeu_pd(flowsY + cell, _mm256_add_pd(_mm256_loadu_pd(flowsY + cell), _mm256_mul_pd(difference, factor)));
+    }
+    for (; cell < width; ++cell)
+      flowsY[cell] += (amount[cell] * temperature[cell] - amount[cell + stride] * temperature[cell + stride]) * scale;
+  }
+
+  UNREAL_FLUID_TARGET_AVX2
+  void invertAmountsAvx2(const double *amount, double *inverseAmount, size_t width) {
+    const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1);
+
+    size_t cell = 0;
+    for (; cell + 4 <= width; cell += 4) {
+      __m256d cells = _mm256_loadu_pd(amount + cell);
+      __m256d inverse = _mm256_div_pd(one, cells);
+      _mm256_storeu_pd(inverseAmount + cell, _mm256_and_pd(inverse, _mm256_cmp_pd(cells, zero, _CMP_NEQ_UQ)));
+    }
+    invertAmountsScalar(amount + cell, inverseAmount + cell, width - cell);
+  }
+
+  template<size_t step>
+  UNREAL_FLUID_TARGET_AVX2
+  void flowPairsAvx2(const Cells &cells, const double *flows, size_t offset, size_t count) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d sign = _mm256_set1_pd(-0.0);
+
+    size_t pair = 0, cell = 0;
+    for (; pair + 4 <= count; pair += 4, cell += 4 * step) {
+      __m256d flow = loadFirst<step>(flows + cell);
+      __m256d amount1, amount2;
+      load<step>(cells.amount + cell, offset, amount1, amount2);
+      amount1 = _mm256_sub_pd(amount1, flow);
+      amount2 = _mm256_add_pd(amount2, flow);
+
+      /* lanes without flow may divide zero by zero, the masks drop them */
+      __m256d forward = _mm256_cmp_pd(flow, zero, _CMP_GT_OQ), backward = _mm256_cmp_pd(flow, zero, _CMP_LT_OQ);
+      __m256d share = _mm256_div_pd(_mm256_andnot_pd(sign, flow), _mm256_blendv_pd(amount1, amount2, forward));
+      mixPairs<step>(cells, cell, offset, _mm256_and_pd(share, backward), _mm256_and_pd(share, forward));
+      store<step>(cells.amount + cell, offset, amount1, amount2);
+    }
+
+    Cells rest{cells.amount + cell, cells.temperature + cell, cells.red + cell, cells.green + cell, cells.blue + cell};
+    flowPairsScalar(rest, flows + cell, offset, step, count - pair);
+  }
+
+  template<size_t step>
+  UNREAL_FLUID_TARGET_AVX2
+  void diffusePairsAvx2(const Cells &cells, const double *inverseAmount, size_t offset, size_t count, double dt) {
+    const __m256d time = _mm256_set1_pd(dt);
+
+    size_t pair = 0, cell = 0;
+    for (; pair + 4 <= count; pair += 4, cell += 4 * step) {
+      __m256d amount1, amount2, inverse1, inverse2;
+      load<step>(cells.amount + cell, offset, amount1, amount2);
+      load<step>(inverseAmount + cell, offset, inverse1, inverse2);
+
+      __m256d slice = _mm256_mul_pd(time, _mm256_min_pd(amount1, amount2));
+      mixPairs<step>(cells, cell, offset, _mm256_mul_pd(slice, inverse1), _mm256_mul_pd(slice, inverse2));
+    }
+
+    Cells rest{cells.amount + cell, cells.temperature + cell, cells.red + cell, cells.green + cell, cells.blue + cell};
+    diffusePairsScalar(rest, inverseAmount + cell, offset, step, count - pair, dt);
+  }
+#endif
+
+  bool useAvx2() {
+    return CpuFeatures::getInstructionSet() >= CpuFeatures::InstructionSet::AVX2;
+  }
+} // namespace
+
+void GasContainer2d::calculateFlowsRow(size_t first, bool lastRow) {
+  /* pressure is amount * gasConstant * temperature / cellVolume, flows grow by a tenth of its differences */
+  constexpr double scale = gasConstant / cellVolume / 10;
+
+#ifdef UNREAL_FLUID_X86_64
+  if (useAvx2()) {
+    calculateFlowsAvx2(&_amount[first], &_temperature[first], &_flowsX[first], &_flowsY[first], _stride, _width, lastRow, scale);
+    return;
+  }
+#endif
+  calculateFlowsScalar(&_amount[first], &_temperature[first], &_flowsX[first], &_flowsY[first], _stride, _width, lastRow, scale);
+}
+
+void GasContainer2d::invertAmountsRow(size_t first) {
+#ifdef UNREAL_FLUID_X86_64
+  if (useAvx2()) {
+    invertAmountsAvx2(&_amount[first], &_inverseAmount[first], _width);
+    return;
+  }
+#endif
+  invertAmountsScalar(&_amount[first], &_inverseAmount[first], _width);
+}
+
+void GasContainer2d::flowPairs(const std::vector<double> &flows, size_t first, size_t offset, size_t step, size_t count) {
+  assert(step == 1 || step == 2);
+  Cells cells{&_amount[first], &_temperature[first], &_red[first], &_green[first], &_blue[first]};
+
+#ifdef UNREAL_FLUID_X86_64
+  if (useAvx2()) {
+    if (step == 1)
+      flowPairsAvx2<1>(cells, &flows[first], offset, count);
+    else
+      flowPairsAvx2<2>(cells, &flows[first], offset, count);
+    return;
+  }
+#endif
+  flowPairsScalar(cells, &flows[first], offset, step, count);
+}
+
+void GasContainer2d::diffusePairs(size_t first, size_t offset, size_t step, size_t count, double dt) {
+  assert(step == 1 || step == 2);
+  Cells cells{&_amount[first], &_temperature[first], &_red[first], &_green[first], &_blue[first]};
+
+#ifdef UNREAL_FLUID_X86_64
+  if (useAvx2()) {
+    if (step == 1)
+      diffusePairsAvx2<1>(cells, &_inverseAmount[first], offset, count, dt);
+    else
+      diffusePairsAvx2<2>(cells, &_inverseAmount[first], offset, count, dt);
+    return;
+  }
+#endif
+  diffusePairsScalar(cells, &_inverseAmount[first], offset, step, count, dt);
+}
+
+// end of GasContainer2D.Kernels.cxx
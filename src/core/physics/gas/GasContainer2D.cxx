@@ -16,115 +16,152 @@
 
 #include "GasContainer2D.h"
 
+#include <algorithm>
+
+#include "solver/MultigridSolver.h"
+
 using namespace unreal_fluid::physics::gas;
 
-GasContainer2d::GasContainer2d(int height, int width, int particle_number) : _height(height),
-                                                                             _width(width) {
-  _storage.resize(height, std::vector<GasCell>(width));
-  _flowsX.resize(height, std::vector<double>(width + 1));
-  _flowsY.resize(height + 1, std::vector<double>(width));
+GasContainer2d::GasContainer2d(int height, int width, int particle_number, Mode mode, StableFluidParameters parameters) : _mode(mode),
+                                                                                                                       _parameters(parameters),
+                                                                                                                       _height(height),
+                                                                                                                       _width(width),
+                                                                                                                       _stride(width + 2) {
+  size_t size = _stride * (height + 2);
+  _amount.resize(size, 0);
+  _temperature.resize(size, 300);
+  _red.resize(size, 1);
+  _green.resize(size, 1);
+  _blue.resize(size, 1);
+
+  if (mode == Mode::FLOWS) {
+    _flowsX.resize(size, 0);
+    _flowsY.resize(size, 0);
+    _inverseAmount.resize(size, 0);
+  } else {
+    _velocityX.resize(size, 0);
+    _velocityY.resize(size, 0);
+    _divergence.resize(size, 0);
+    _pressure.resize(size, 0);
+    _pressureGrid = std::make_unique<PoissonGrid>(width, height);
+    _pressureSolver = std::make_unique<MultigridSolver>();
+  }
+
+  /* edge rows dissolve as a whole, other rows only at both ends */
+  for (int row = 0; row < height; ++row) {
+    bool edge = row < edgeSize || row >= height - edgeSize;
+    for (int column = 0; column < width;) {
+      int end = edge ? width : std::min(column + edgeSize, width);
+      _edgeRuns.push_back({index(row, column), end - column});
+      column = std::max(end, width - edgeSize);
+    }
+  }
 
   for (int counter = 0; counter < particle_number; ++counter) {
     int x = rand() % height, y = rand() % width;
 
-    _storage[x][y] = GasCell(rand() % 100, vec3f(rand() % 100, rand() % 100, rand() % 100) / 100.0);
+    setGas(x, y, rand() % 100, vec3f(rand() % 100, rand() % 100, rand() % 100) / 100.0);
   }
 }
 
-double GasContainer2d::calculateFlow(const GasCell &cell1, const GasCell &cell2) const {
-  double pressureDiff = cell1.getPressure() - cell2.getPressure();
-  double targetFlow = pressureDiff / 10.0;
-  return targetFlow;
+void GasContainer2d::setGas(int row, int column, double amount, vec3f color, double temperature) {
+  size_t cell = index(row, column);
+  _amount[cell] = amount;
+  _temperature[cell] = temperature;
+  _red[cell] = color.x;
+  _green[cell] = color.y;
+  _blue[cell] = color.z;
 }
 
-void GasContainer2d::calculateAndSaveFlow(GasCell &cell1, GasCell &cell2, int y, int x, bool isHorizontal) {
-  double targetFlow = calculateFlow(cell1, cell2);
-  if (isHorizontal) _flowsX[y][x] += targetFlow;
-  else
-    _flowsY[y][x] += targetFlow;
-}
-
-void GasContainer2d::calculateFlows(double dt) {
-  for (int row = 0; row < _height; ++row) {
-    for (int column = 0; column < _width; ++column) {
-      auto &cell = _storage[row][column];
-
-      if (row < _height - 1) calculateAndSaveFlow(cell, _storage[row + 1][column], row, column, false);
-      if (column < _width - 1) calculateAndSaveFlow(cell, _storage[row][column + 1], row, column, true);
-    }
-  }
+template<typename Body>
+void GasContainer2d::forEachRow(Body &&body) {
+  _threadPool.parallelFor(_height, [&](size_t begin, size_t end, unsigned) {
+    for (auto row = int(begin); row < int(end); ++row)
+      body(index(row, 0), row);
+  });
 }
 
-void GasContainer2d::applyFlow(GasCell &cell1, GasCell &cell2, double targetFlow) const {
-  if (targetFlow > 0) cell2.add(cell1.slice(targetFlow));
-  else
-    cell1.add(cell2.slice(-targetFlow));
-}
+template<typename Across, typename Along>
+void GasContainer2d::sweepPairPhases(Across &&across, Along &&along) {
+  auto pairsAcross = [&](int row) { across(index(row, 0)); };
+  auto pairsAlong = [&](int row) { along(index(row, 0)); };
 
-void GasContainer2d::applyFlows(double dt) {
-  for (size_t row = 0; row < _height; ++row) {
-    for (size_t column = 0; column < _width; ++column) {
-      auto &cell = _storage[row][column];
+  size_t tiles = (_height + tileRows - 1) / tileRows;
+  _threadPool.parallelFor(tiles, [&](size_t begin, size_t end, unsigned) {
+    for (size_t tile = begin; tile < end; ++tile) {
+      int first = int(tile) * tileRows, last = std::min(first + tileRows, _height);
 
-      if (row < _height - 1) {
-        double targetFlow = _flowsY[row][column];
-        applyFlow(cell, _storage[row + 1][column], targetFlow);
-      }
-      if (column < _width - 1) {
-        double targetFlow = _flowsX[row][column];
-        applyFlow(cell, _storage[row][column + 1], targetFlow);
+      /* pairs from an even row, then the odd row above it is done with both of its pairs across */
+      for (int row = first; row < last; row += 2) {
+        if (row + 1 < _height) pairsAcross(row);
+        if (row > first) {
+          pairsAcross(row - 1);
+          pairsAlong(row - 1);
+          pairsAlong(row);
+        } else if (row == 0) {
+          pairsAlong(row);
+        }
       }
+      if (last == _height && (last - first) % 2 == 0) pairsAlong(last - 1);
     }
-  }
-}
+  });
 
-void GasContainer2d::diffuseTwoCells(GasCell &cell1, GasCell &cell2, double dt) {
-  double slicingPart = dt * std::min(cell1.amountOfGas, cell2.amountOfGas);
+  /* an odd row at the end of a tile pairs with the first row of the next one */
+  _threadPool.parallelFor(tiles - 1, [&](size_t begin, size_t end, unsigned) {
+    for (size_t tile = begin + 1; tile < end + 1; ++tile) {
+      int row = int(tile) * tileRows;
+      pairsAcross(row - 1);
+      pairsAlong(row - 1);
+      pairsAlong(row);
+    }
+  });
+}
 
-  auto cell_1 = cell1.slice(slicingPart);
-  auto cell_2 = cell2.slice(slicingPart);
+void GasContainer2d::calculateFlows(double dt) {
+  forEachRow([&](size_t first, int row) { calculateFlowsRow(first, row == _height - 1); });
+}
 
-  cell1.add(cell_2);
-  cell2.add(cell_1);
+void GasContainer2d::applyFlows(double dt) {
+  /* flows are only kept between cells of the grid, pairs never reach ghost cells */
+  sweepPairPhases([&](size_t first) { flowPairs(_flowsY, first, _stride, 1, _width); },
+                  [&](size_t first) {
+                    flowPairs(_flowsX, first, 1, 2, _width / 2);
+                    flowPairs(_flowsX, first + 1, 1, 2, (_width - 1) / 2);
+                  });
 }
 
 void GasContainer2d::diffuseCells(double dt) {
-  for (size_t row = 0; row < _height; ++row) {
-    for (size_t column = 0; column < _width; ++column) {
-      auto &cell = _storage[row][column];
-      if (row < _height - 1) diffuseTwoCells(cell, _storage[row + 1][column], dt);
-      if (column < _width - 1) diffuseTwoCells(cell, _storage[row][column + 1], dt);
-    }
-  }
-}
+  /* diffusion keeps amounts, so their reciprocals serve all four phases */
+  forEachRow([&](size_t first, int) { invertAmountsRow(first); });
 
-void GasContainer2d::dissolveCell(GasCell &cell, double dt) {
-  cell.amountOfGas -= dt * cell.amountOfGas;
-  cell.amountOfGas = std::max(cell.amountOfGas, 0.0);
+  /* amount of gas may be negative, so ghost cells must not take part in diffusion, and pairs never reach them */
+  sweepPairPhases([&](size_t first) { diffusePairs(first, _stride, 1, _width, dt); },
+                  [&](size_t first) {
+                    diffusePairs(first, 1, 2, _width / 2, dt);
+                    diffusePairs(first + 1, 1, 2, (_width - 1) / 2, dt);
+                  });
 }
 
 void GasContainer2d::dissolveCells(double dt) {
-  int edgeSize = 3;
-
-  for (size_t row = 0; row < _height; ++row) {
-    for (size_t column = 0; column < _width; ++column) {
-      if (row < edgeSize || row >= _height - edgeSize || column < edgeSize || column >= _width - edgeSize) {
-        auto &cell = _storage[row][column];
-        dissolveCell(cell, dt);
-      }
+  _threadPool.parallelFor(_edgeRuns.size(), [&](size_t begin, size_t end, unsigned) {
+    for (size_t run = begin; run < end; ++run) {
+      double *amount = _amount.data() + _edgeRuns[run].first;
+      for (int cell = 0; cell < _edgeRuns[run].length; ++cell)
+        amount[cell] = std::max(amount[cell] - dt * amount[cell], 0.0);
     }
-  }
+  });
 }
 
 unreal_fluid::physics::IPhysicalObject::Type GasContainer2d::getType() {
   return Type::GAS_CONTAINER_2D;
 }
 
-void *GasContainer2d::getData() {
-  return &_storage;
-}
-
 void GasContainer2d::simulate(double dt) {
+  if (_mode == Mode::STABLE_FLUIDS) {
+    simulateStableFluids(dt);
+    return;
+  }
+
   calculateFlows(dt);
   applyFlows(dt);
   diffuseCells(dt);
@@ -136,9 +173,142 @@ void GasContainer2d::advect(double dt) {
   for (int counter = 0; counter < 100; ++counter) {
     if (rand() & 1) continue;
     int x = rand() % _height, y = rand() % _width;
-    auto cell = _storage[x][y];
-    cell.amountOfGas += 100 * dt * cell.amountOfGas;
+    double amountOfGas = _amount[index(x, y)];
+    amountOfGas += 100 * dt * amountOfGas;
   }
 }
 
+void GasContainer2d::simulateStableFluids(double dt) {
+  addBuoyancy(dt);
+
+  /* both components are traced back through the old velocities */
+  advectField(_velocityX, _newVelocityX, _traced, 0, 0.5, dt);
+  advectField(_velocityY, _newVelocityY, _traced, 0.5, 0, dt);
+  _velocityX.swap(_newVelocityX);
+  _velocityY.swap(_newVelocityY);
+
+  project();
+
+  advectField(_amount, _advected, _traced, 0.5, 0.5, dt);
+  _amount.swap(_advected);
+  advectField(_temperature, _advected, _traced, 0.5, 0.5, dt);
+  _temperature.swap(_advected);
+  advectField(_red, _advectedColor, _tracedColor, 0.5, 0.5, dt);
+  _red.swap(_advectedColor);
+  advectField(_green, _advectedColor, _tracedColor, 0.5, 0.5, dt);
+  _green.swap(_advectedColor);
+  advectField(_blue, _advectedColor, _tracedColor, 0.5, 0.5, dt);
+  _blue.swap(_advectedColor);
+
+  dissolveCells(dt);
+}
+
+void GasContainer2d::addBuoyancy(double dt) {
+  /* lower faces of cells above the bottom row, between the cell and the one under it */
+  for (int row = 1; row < _height; ++row) {
+    size_t cell = index(row, 0);
+    for (int column = 0; column < _width; ++column, ++cell) {
+      double temperature = (_temperature[cell] + _temperature[cell - _stride]) / 2;
+      double amount = (_amount[cell] + _amount[cell - _stride]) / 2;
+      _velocityY[cell] += dt * (_parameters.lift * (temperature - _parameters.ambientTemperature) - _parameters.weight * amount);
+    }
+  }
+}
+
+void GasContainer2d::project() {
+  /* nothing passes through the walls */
+  for (int row = 0; row < _height; ++row) {
+    _velocityX[index(row, 0)] = 0;
+    _velocityX[index(row, _width)] = 0;
+  }
+  for (int column = 0; column < _width; ++column) {
+    _velocityY[index(0, column)] = 0;
+    _velocityY[index(_height, column)] = 0;
+  }
+
+  for (int row = 0; row < _height; ++row) {
+    size_t cell = index(row, 0);
+    for (int column = 0; column < _width; ++column, ++cell)
+      _divergence[cell] = _velocityX[cell + 1] - _velocityX[cell] + _velocityY[cell + _stride] - _velocityY[cell];
+  }
+
+  /* pressure times dt, the last one is the first guess; walls push nothing, so the solver needs no ghost values */
+  _pressureSolver->solve(*_pressureGrid, _pressure, _divergence, _threadPool);
+
+  for (int row = 0; row < _height; ++row) {
+    size_t cell = index(row, 1);
+    for (int column = 1; column < _width; ++column, ++cell)
+      _velocityX[cell] -= _pressure[cell] - _pressure[cell - 1];
+  }
+  for (int row = 1; row < _height; ++row) {
+    size_t cell = index(row, 0);
+    for (int column = 0; column < _width; ++column, ++cell)
+      _velocityY[cell] -= _pressure[cell] - _pressure[cell - _stride];
+  }
+}
+
+vec2 GasContainer2d::velocityAt(double x, double y) const {
+  return {sample(_velocityX, x, y, 0, 0.5), sample(_velocityY, x, y, 0.5, 0)};
+}
+
+template<typename T>
+T GasContainer2d::sample(const std::vector<T> &field, double x, double y, double offsetX, double offsetY, T *low, T *high) const {
+  double maxX = _width - 2 * offsetX, maxY = _height - 2 * offsetY;
+  double gridX = std::clamp(x - offsetX, 0.0, maxX), gridY = std::clamp(y - offsetY, 0.0, maxY);
+
+  int column = std::min(int(gridX), std::max(int(maxX) - 1, 0));
+  int row = std::min(int(gridY), std::max(int(maxY) - 1, 0));
+  double fractionX = gridX - column, fractionY = gridY - row;
+
+  size_t cell = index(row, column);
+  T a = field[cell], b = field[cell + 1], c = field[cell + _stride], d = field[cell + _stride + 1];
+
+  if (low != nullptr) *low = std::min(std::min(a, b), std::min(c, d));
+  if (high != nullptr) *high = std::max(std::max(a, b), std::max(c, d));
+  return T((a * (1 - fractionX) + b * fractionX) * (1 - fractionY) + (c * (1 - fractionX) + d * fractionX) * fractionY);
+}
+
+vec2 GasContainer2d::traceBack(double x, double y, double dt) const {
+  /* second order Runge-Kutta: velocity in the middle of the path */
+  vec2 velocity = velocityAt(x, y);
+  vec2 middle = velocityAt(x - velocity.x * dt / 2, y - velocity.y * dt / 2);
+  return {x - middle.x * dt, y - middle.y * dt};
+}
+
+template<typename T>
+void GasContainer2d::advectField(const std::vector<T> &field, std::vector<T> &advected, std::vector<T> &traced,
+                                 double offsetX, double offsetY, double dt) {
+  advected = field;
+  int columns = int(_width - 2 * offsetX) + 1, rows = int(_height - 2 * offsetY) + 1;
+
+  for (int row = 0; row < rows; ++row)
+    for (int column = 0; column < columns; ++column) {
+      vec2 from = traceBack(column + offsetX, row + offsetY, dt);
+      advected[index(row, column)] = sample(field, from.x, from.y, offsetX, offsetY);
+    }
+
+  if (!_parameters.maccormack)
+    return;
+
+  /* carrying the result back should give the field again, half of the difference is the error of advection */
+  traced = advected;
+  for (int row = 0; row < rows; ++row)
+    for (int column = 0; column < columns; ++column) {
+      vec2 to = traceBack(column + offsetX, row + offsetY, -dt);
+      traced[index(row, column)] = sample(advected, to.x, to.y, offsetX, offsetY);
+    }
+
+  /* corrected values outside of the values they came from would grow into oscillations */
+  for (int row = 0; row < rows; ++row)
+    for (int column = 0; column < columns; ++column) {
+      size_t cell = index(row, column);
+      vec2 from = traceBack(column + offsetX, row + offsetY, dt);
+
+      T low, high;
+      (void)sample(field, from.x, from.y, offsetX, offsetY, &low, &high);
+      T corrected = T(advected[cell] + (field[cell] - traced[cell]) / 2);
+      if (corrected >= low && corrected <= high) advected[cell] = corrected;
+    }
+}
+
 // End of GasContainer2D.cxx
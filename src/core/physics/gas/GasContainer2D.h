@@ -16,67 +16,228 @@
 
 #pragma once
 
+#include <cassert>
+#include <memory>
+#include <vector>
+
 #include "../Simulator.h"
-#include "GasCell.h"
+#include "solver/IPoissonSolver.h"
 
 namespace unreal_fluid::physics::gas {
+  struct StableFluidParameters {
+    bool maccormack = true;          // corrects semi-Lagrangian advection by tracing forward and back
+    double lift = 0.05;              // upward acceleration per degree above ambient temperature
+    double weight = 0.002;           // downward acceleration per unit of amount of gas
+    double ambientTemperature = 300;
+  };
+
+  /// @brief Gas on a 2D grid of cells.
+  /// @details Every quantity of cells is a flat row-major field of its own. Fields have one ring of
+  /// ghost cells around the grid, so stencils read neighbours of every cell without bounds checks.
+  /// Ghost cells hold no gas and are never paired with cells of the grid, so nothing flows through the border.
+  ///
+  /// Flows and diffusion move gas between two neighbouring cells at a time, in place. Pairs are taken in
+  /// four phases: every cell with the one below it from even rows, then from odd rows, then every cell with
+  /// the one to the right from even columns, then from odd columns. Pairs of a phase share no cells, as red
+  /// and black cells of a Gauss-Seidel sweep do, so tiles of rows run on threads of a pool and results
+  /// do not depend on the amount of threads.
+  /// A phase of a row is one call of a row kernel over the flat fields, see GasContainer2D.Kernels.cxx:
+  /// pressure is computed from amount and temperature inside the flows kernel, diffusion multiplies by
+  /// reciprocals of amounts computed once per step, and only flows divide, once per pair, since they
+  /// change amounts between phases. AVX2 kernels fuse multiply-adds, so they round differently from
+  /// scalar ones, which run on other CPUs.
+  ///
+  /// In STABLE_FLUIDS mode gas is carried by an incompressible velocity field instead of pressure flows.
+  /// Velocities live on faces of cells (a staggered grid), every step adds buoyancy, advects velocities
+  /// and gas semi-Lagrangian, with MacCormack correction if enabled, and projects velocities to zero
+  /// divergence. Tracing back never overshoots, so the step is stable for any dt. Rows grow upwards.
+  /// Pressure is solved by a pluggable IPoissonSolver, multigrid by default. Only this mode allocates
+  /// the solver and its grid.
   class GasContainer2d : public IPhysicalObject {
+  public:
+    enum class Mode {
+      FLOWS,         // gas moves from cells with higher pressure to neighbours
+      STABLE_FLUIDS, // gas is advected by an incompressible velocity field
+    };
+
+  private:
+    Mode _mode;
+    StableFluidParameters _parameters;
+
     int _height;
     int _width;
-    std::vector<std::vector<GasCell>> _storage;
-    std::vector<std::vector<double>> _flowsX;
-    std::vector<std::vector<double>> _flowsY;
+    size_t _stride; // width with ghost cells
+
+    /* fields of cells, including ghost ones */
+    std::vector<double> _amount;      // amount of gas = mass / molarMass
+    std::vector<double> _temperature; // temperature of gas
+    std::vector<float> _red;          // colour is a quantity to define gas
+    std::vector<float> _green;
+    std::vector<float> _blue;
+
+    /// @brief cells first, first + 1, ..., first + length - 1 of a row
+    struct CellRun {
+      size_t first;
+      int length;
+    };
+    std::vector<CellRun> _edgeRuns;   // cells closer than edgeSize to the walls, gas dissolves in them
+
+    /* pressure flows, ghost cells and the last cell of a row and of a column keep zero flows */
+    std::vector<double> _flowsX;       // flow from a cell to its right neighbour
+    std::vector<double> _flowsY;       // flow from a cell to its lower neighbour
+    std::vector<double> _inverseAmount; // 1 / amount of gas, 0 in empty cells, filled before diffusion
+
+    /* stable fluids, velocities are stored at the left and the lower face of a cell */
+    std::vector<double> _velocityX;
+    std::vector<double> _velocityY;
+    std::vector<double> _newVelocityX;
+    std::vector<double> _newVelocityY;
+    std::vector<double> _divergence;
+    std::vector<double> _pressure; // pressure times dt
+    std::unique_ptr<PoissonGrid> _pressureGrid;
+    std::unique_ptr<IPoissonSolver> _pressureSolver;
+    utils::ThreadPool _threadPool;
+    std::vector<double> _advected;     // new values of a field while it is advected
+    std::vector<double> _traced;       // values traced forward again for MacCormack correction
+    std::vector<float> _advectedColor;
+    std::vector<float> _tracedColor;
+
+    static constexpr double gasConstant = 0.003; // real = 8.3144598
+    static constexpr double cellVolume = 1;      // volume of cell (now 1x1x1)
+    static constexpr int tileRows = 64;          // rows of a tile of pair phases, even
+    static constexpr int edgeSize = 3;           // gas dissolves in cells closer to the walls
 
   public:
     /// @brief Constructor.
     /// @param height height of container
     /// @param width width of container
     /// @param particle_number amount of particles in container (randomly distributed)
-    GasContainer2d(int height, int width, int particle_number);
+    /// @param mode how gas moves
+    /// @param parameters parameters of STABLE_FLUIDS mode
+    GasContainer2d(int height, int width, int particle_number, Mode mode = Mode::FLOWS, StableFluidParameters parameters = {});
+
+    /// @brief sets amount of threads, 0 means all hardware threads
+    void setThreadsCount(unsigned threadsCount) { _threadPool.setThreadsCount(threadsCount); }
 
   private:
-    /// @brief Calculate flow between two cells.
-    /// @param cell1 first cell (potential source)
-    /// @param cell2 second cell (potential target)
-    [[nodiscard]] double calculateFlow(const GasCell &cell1, const GasCell &cell2) const;
-    /// @brief Calculate flow between two cells and save it in cells.
-    /// @param cell1, cell2 cells
-    /// @param x, y - position
-    void calculateAndSaveFlow(GasCell &cell1, GasCell &cell2, int x, int y, bool isHorizontal);
+    /// @brief returns index of cell in fields, rows and columns start from 0 without ghost cells
+    [[nodiscard]] size_t index(int row, int column) const { return (row + 1) * _stride + column + 1; }
+
+    /// @brief calls body(first cell of the row, row) for every row of the grid, rows are split between threads
+    template<typename Body>
+    void forEachRow(Body &&body);
+
+    /// @brief runs the four phases of pairs of neighbouring cells: across(first cell of a row) pairs every cell
+    /// of the row with the one below it, along(first cell of a row) pairs cells of the row with their right
+    /// neighbours, from even columns and then from odd ones
+    /// @details A tile sweeps its rows once: a row takes its pairs across rows as soon as the rows next to it
+    /// have taken theirs of the previous phase, and then its pairs along the row. Pairs across borders of tiles
+    /// and the rows next to them are finished afterwards. Every cell still sees its pairs in the order of phases.
+    template<typename Across, typename Along>
+    void sweepPairPhases(Across &&across, Along &&along);
+
+    /// @brief replaces gas in cell
+    void setGas(int row, int column, double amount, vec3f color, double temperature = 300);
+
+    /* row kernels, implemented in GasContainer2D.Kernels.cxx */
+
+    /// @brief adds differences of pressure between cells of a row and their right and lower neighbours to flows
+    /// @param first first cell of the row
+    /// @param lastRow true if the row has no lower neighbours inside the grid
+    void calculateFlowsRow(size_t first, bool lastRow);
+
+    /// @brief fills _inverseAmount of a row, empty cells get 0
+    void invertAmountsRow(size_t first);
+
+    /// @brief moves gas of pairs of cells (first + k * step, first + k * step + offset), k < count,
+    /// positive flows of first cells of pairs go to second cells, targets mix colour and temperature
+    /// @param flows flows of pairs, indexed by first cells
+    /// @param step 1 or 2
+    void flowPairs(const std::vector<double> &flows, size_t first, size_t offset, size_t step, size_t count);
+
+    /// @brief exchanges dt * the smaller amount of gas of two cells between cells of pairs as flowPairs() does,
+    /// amounts stay the same and colour and temperature mix, reads _inverseAmount
+    void diffusePairs(size_t first, size_t offset, size_t step, size_t count, double dt);
+
     /// @brief Calculate all flows in container.
     /// @param dt time step
     void calculateFlows(double dt);
 
-    /// @brief Apply flow between two cells.
-    /// @param cell1 first cell
-    /// @param cell2 second cell
-    void applyFlow(GasCell &cell1, GasCell &cell2, double targetFlow) const;
     /// @brief Move flows in container.
     /// @param dt time step
     void applyFlows(double dt);
 
-    /// @brief Diffuse gas between two cells.
-    /// @param cell1 first cell
-    /// @param cell2 second cell
-    void diffuseTwoCells(GasCell &cell1, GasCell &cell2, double dt);
     /// @brief Diffuse gas in container.
     void diffuseCells(double dt);
 
-    /// @brief Dissolve gas in cell.
-    /// @param cell cell to dissolve
-    /// @param dt time step
-    void dissolveCell(GasCell &cell, double dt);
     /// @brief Dissolve gas in container.
     /// @param dt time step
     void dissolveCells(double dt);
 
     void advect(double dt);
 
+    /// @brief Step of STABLE_FLUIDS mode.
+    /// @param dt time step
+    void simulateStableFluids(double dt);
+
+    /// @brief Accelerates hot gas up and dense gas down.
+    /// @param dt time step
+    void addBuoyancy(double dt);
+
+    /// @brief Makes velocities divergence free.
+    void project();
+
+    /// @brief returns velocity at a point, x goes along columns and y along rows, cells are 1x1
+    [[nodiscard]] vec2 velocityAt(double x, double y) const;
+
+    /// @brief returns bilinear interpolation of a field given at points (column + offsetX, row + offsetY)
+    /// @details points outside the field take values of its nearest border
+    /// @param low, high if given, receive the smallest and the largest of the interpolated values
+    template<typename T>
+    [[nodiscard]] T sample(const std::vector<T> &field, double x, double y, double offsetX, double offsetY,
+                           T *low = nullptr, T *high = nullptr) const;
+
+    /// @brief returns point a particle at (x, y) came from dt ago
+    [[nodiscard]] vec2 traceBack(double x, double y, double dt) const;
+
+    /// @brief fills advected with values of a field given at points (column + offsetX, row + offsetY)
+    /// carried along velocities for dt
+    /// @param traced scratch field for MacCormack correction
+    template<typename T>
+    void advectField(const std::vector<T> &field, std::vector<T> &advected, std::vector<T> &traced,
+                     double offsetX, double offsetY, double dt);
+
   public:
     /* abstract class implementation */
 
     [[nodiscard]] Type getType() override;
-    [[nodiscard]] void *getData() override;
+
+    [[nodiscard]] int getHeight() const { return _height; }
+    [[nodiscard]] int getWidth() const { return _width; }
+
+    /// @brief returns amount of gas in cell
+    [[nodiscard]] double getAmount(int row, int column) const { return _amount[index(row, column)]; }
+
+    /// @brief returns velocity at the centre of cell
+    [[nodiscard]] vec2 getVelocity(int row, int column) const { return velocityAt(column + 0.5, row + 0.5); }
+
+    /// @brief returns solver of the pressure equation, it keeps statistics of solves
+    /// @attention FLOWS mode has no solver
+    [[nodiscard]] IPoissonSolver &getPressureSolver() const {
+      assert(_pressureSolver != nullptr);
+      return *_pressureSolver;
+    }
+
+    /// @brief replaces solver of the pressure equation, FLOWS mode ignores it
+    void setPressureSolver(std::unique_ptr<IPoissonSolver> solver) {
+      if (_mode == Mode::STABLE_FLUIDS) _pressureSolver = std::move(solver);
+    }
+
+    /// @brief returns colour of gas in cell
+    [[nodiscard]] vec3f getColor(int row, int column) const {
+      size_t cell = index(row, column);
+      return {_red[cell], _green[cell], _blue[cell]};
+    }
 
   private:
     /// @brief Simulate gas container.
@@ -85,4 +246,4 @@ namespace unreal_fluid::physics::gas {
   };
 } // namespace unreal_fluid::physics::gas
 
-// end of GasContainer2D.h
\ No newline at end of file
+// end of GasContainer2D.h
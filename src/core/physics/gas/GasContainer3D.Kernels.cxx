@@ -0,0 +1,366 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : GasContainer3D.Kernels.cxx
+ * PURPOSE   : row kernels of advection and projection of 3-dimensional gas
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "GasContainer3D.h"
+#include "../../../utils/cpu/CpuFeatures.h"
+
+#ifdef UNREAL_FLUID_X86_64
+#include <immintrin.h>
+#endif
+
+using namespace unreal_fluid::physics::gas;
+
+namespace {
+  using unreal_fluid::utils::CpuFeatures;
+
+  /// @brief faces whose mean is a component of velocity at points of a row, offsets are from the cell of a point
+  struct Faces {
+    const float *field;
+    ptrdiff_t first;
+    ptrdiff_t step;   // 0 if the component is given at the points
+    ptrdiff_t across; // 0 if the component is the mean of two faces
+  };
+
+  /// @brief where points of a field lie in cells, see GasContainer3d::locate()
+  struct Bounds {
+    float offsetX, offsetY, offsetZ;
+    float maxX, maxY, maxZ;
+    int lastColumn, lastRow, lastLayer;
+    int stride, layerStride;
+  };
+
+#ifdef UNREAL_FLUID_X86_64
+  /* A vector holds eight points of a row. Stencils are four floats each, the cell is stored by its bits,
+   * so eight stencils are four vectors transposed into vectors of cells and of fractions along each axis.
+   * Corners are gathered as pairs of neighbours along x. Kernels return the amount of points they did,
+   * the members finish rows with their scalar loops. */
+
+  UNREAL_FLUID_TARGET_AVX2
+  inline void storeStencils(float *stencils, __m256i cells, __m256 fractionX, __m256 fractionY, __m256 fractionZ) {
+    __m256 cell = _mm256_castsi256_ps(cells);
+    __m256 low1 = _mm256_unpacklo_ps(cell, fractionX), high1 = _mm256_unpackhi_ps(cell, fractionX);
+    __m256 low2 = _mm256_unpacklo_ps(fractionY, fractionZ), high2 = _mm256_unpackhi_ps(fractionY, fractionZ);
+
+    /* stencils 0 and 4, 1 and 5, 2 and 6, 3 and 7 */
+    __m256 stencil04 = _mm256_shuffle_ps(low1, low2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 stencil15 = _mm256_shuffle_ps(low1, low2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 stencil26 = _mm256_shuffle_ps(high1, high2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 stencil37 = _mm256_shuffle_ps(high1, high2, _MM_SHUFFLE(3, 2, 3, 2));
+
+    _mm256_storeu_ps(stencils, _mm256_permute2f128_ps(stencil04, stencil15, 0x20));
+    _mm256_storeu_ps(stencils + 8, _mm256_permute2f128_ps(stencil26, stencil37, 0x20));
+    _mm256_storeu_ps(stencils + 16, _mm256_permute2f128_ps(stencil04, stencil15, 0x31));
+    _mm256_storeu_ps(stencils + 24, _mm256_permute2f128_ps(stencil26, stencil37, 0x31));
+  }
+
+  UNREAL_FLUID_TARGET_AVX2
+  inline void loadStencils(const float *stencils, __m256i &cells, __m256 &fractionX, __m256 &fractionY, __m256 &fractionZ) {
+    __m256 stencils01 = _mm256_loadu_ps(stencils), stencils23 = _mm256_loadu_ps(stencils + 8);
+    __m256 stencils45 = _mm256_loadu_ps(stencils + 16), stencils67 = _mm256_loadu_ps(stencils + 24);
+
+    __m256 stencil04 = _mm256_permute2f128_ps(stencils01, stencils45, 0x20);
+    __m256 stencil15 = _mm256_permute2f128_ps(stencils01, stencils45, 0x31);
+    __m256 stencil26 = _mm256_permute2f128_ps(stencils23, stencils67, 0x20);
+    __m256 stencil37 = _mm256_permute2f128_ps(stencils23, stencils67, 0x31);
+
+    /* cells and fractions along x of points 0, 1, 4, 5 and 2, 3, 6, 7, then the same along y and z */
+    __m256 low1 = _mm256_unpacklo_ps(stencil04, stencil15), high1 = _mm256_unpackhi_ps(stencil04, stencil15);
+    __m256 low2 = _mm256_unpacklo_ps(stencil26, stencil37), high2 = _mm256_unpackhi_ps(stencil26, stencil37);
+
+    cells = _mm256_castps_si256(_mm256_shuffle_ps(low1, low2, _MM_SHUFFLE(1, 0, 1, 0)));
+    fractionX = _mm256_shuffle_ps(low1, low2, _MM_SHUFFLE(3, 2, 3, 2));
+    fractionY = _mm256_shuffle_ps(high1, high2, _MM_SHUFFLE(1, 0, 1, 0));
+    fractionZ = _mm256_shuffle_ps(high1, high2, _MM_SHUFFLE(3, 2, 3, 2));
+  }
+
+  /// @brief returns component of velocity at eight points from the first cell
+  UNREAL_FLUID_TARGET_AVX2
+  inline __m256 meanOfFaces(const Faces &faces, size_t cell) {
+    const float *face = faces.field + cell + faces.first;
+    if (faces.step == 0)
+      return _mm256_loadu_ps(face);
+
+    __m256 sum = _mm256_add_ps(_mm256_loadu_ps(face), _mm256_loadu_ps(face + faces.step));
+    if (faces.across == 0)
+      return _mm256_mul_ps(sum, _mm256_set1_ps(0.5f));
+
+    sum = _mm256_add_ps(sum, _mm256_loadu_ps(face + faces.across));
+    sum = _mm256_add_ps(sum, _mm256_loadu_ps(face + faces.step + faces.across));
+    return _mm256_mul_ps(sum, _mm256_set1_ps(0.25f));
+  }
+
+  /// @brief returns cells of eight points along one axis and their fractions, as GasContainer3d::locate() does
+  UNREAL_FLUID_TARGET_AVX2
+  inline __m256i locateAxis(__m256 point, float offset, float max, int last, __m256 &fraction) {
+    /* points which are not numbers go to the lowest border */
+    __m256 grid = _mm256_max_ps(_mm256_sub_ps(point, _mm256_set1_ps(offset)), _mm256_setzero_ps());
+    grid = _mm256_min_ps(grid, _mm256_set1_ps(max));
+
+    __m256i cell = _mm256_min_epi32(_mm256_cvttps_epi32(grid), _mm256_set1_epi32(last));
+    fraction = _mm256_sub_ps(grid, _mm256_cvtepi32_ps(cell));
+    return cell;
+  }
+
+  UNREAL_FLUID_TARGET_AVX2
+  inline void locate(const Bounds &bounds, __m256 x, __m256 y, __m256 z, float *stencils) {
+    __m256 fractionX, fractionY, fractionZ;
+    __m256i column = locateAxis(x, bounds.offsetX, bounds.maxX, bounds.lastColumn, fractionX);
+    __m256i row = locateAxis(y, bounds.offsetY, bounds.maxY, bounds.lastRow, fractionY);
+    __m256i layer = locateAxis(z, bounds.offsetZ, bounds.maxZ, bounds.lastLayer, fractionZ);
+
+    __m256i cells = _mm256_add_epi32(column, _mm256_set1_epi32(bounds.layerStride + bounds.stride + 1));
+    cells = _mm256_add_epi32(cells, _mm256_mullo_epi32(row, _mm256_set1_epi32(bounds.stride)));
+    cells = _mm256_add_epi32(cells, _mm256_mullo_epi32(layer, _mm256_set1_epi32(bounds.layerStride)));
+    storeStencils(stencils, cells, fractionX, fractionY, fractionZ);
+  }
+
+  /// @brief gathers values of eight cells and of their right neighbours
+  UNREAL_FLUID_TARGET_AVX2
+  inline void gatherPairs(const float *field, __m256i cells, __m256 &left, __m256 &right) {
+    /* pairs of points 0, 1, 4, 5 and 2, 3, 6, 7, so that shuffles leave points in order */
+    cells = _mm256_permutevar8x32_epi32(cells, _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7));
+    auto pairs = reinterpret_cast<const long long *>(field);
+    __m256 low = _mm256_castsi256_ps(_mm256_i32gather_epi64(pairs, _mm256_castsi256_si128(cells), 4));
+    __m256 high = _mm256_castsi256_ps(_mm256_i32gather_epi64(pairs, _mm256_extracti128_si256(cells, 1), 4));
+    left = _mm256_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+    right = _mm256_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+  }
+
+  UNREAL_FLUID_TARGET_AVX2
+  inline __m256 mix(__m256 value, __m256 other, __m256 fraction) {
+    return _mm256_fmadd_ps(_mm256_sub_ps(other, value), fraction, value);
+  }
+
+  /// @brief returns trilinear interpolation of a field at eight stencils, as GasContainer3d::interpolate() does
+  UNREAL_FLUID_TARGET_AVX2
+  inline __m256 interpolate(const float *field, const float *stencils, int stride, int layerStride,
+                            __m256 *low = nullptr, __m256 *high = nullptr) {
+    __m256i back;
+    __m256 fractionX, fractionY, fractionZ;
+    loadStencils(stencils, back, fractionX, fractionY, fractionZ);
+    __m256i front = _mm256_add_epi32(back, _mm256_set1_epi32(layerStride));
+
+    __m256 a, b, c, d, e, f, g, h;
+    gatherPairs(field, back, a, b);
+    gatherPairs(field, _mm256_add_epi32(back, _mm256_set1_epi32(stride)), c, d);
+    gatherPairs(field, front, e, f);
+    gatherPairs(field, _mm256_add_epi32(front, _mm256_set1_epi32(stride)), g, h);
+
+    if (low != nullptr)
+      *low = _mm256_min_ps(_mm256_min_ps(_mm256_min_ps(a, b), _mm256_min_ps(c, d)), _mm256_min_ps(_mm256_min_ps(e, f), _mm256_min_ps(g, h)));
+    if (high != nullptr)
+      *high = _mm256_max_ps(_mm256_max_ps(_mm256_max_ps(a, b), _mm256_max_ps(c, d)), _mm256_max_ps(_mm256_max_ps(e, f), _mm256_max_ps(g, h)));
+
+    __m256 backValue = mix(mix(a, b, fractionX), mix(c, d, fractionX), fractionY);
+    __m256 frontValue = mix(mix(e, f, fractionX), mix(g, h, fractionX), fractionY);
+    return mix(backValue, frontValue, fractionZ);
+  }
+
+  UNREAL_FLUID_TARGET_AVX2
+  int traceRowAvx2(const Faces (&faces)[3], const Bounds &bounds, size_t first, float y, float z, int columns, float dt,
+                   float *from, float *to) {
+    const __m256 time = _mm256_set1_ps(dt), pointY = _mm256_set1_ps(y), pointZ = _mm256_set1_ps(z);
+    const __m256 columnsOfVector = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+
+    int column = 0;
+    for (; column + 8 <= columns; column += 8) {
+      size_t cell = first + column;
+      __m256 x = _mm256_add_ps(_mm256_add_ps(_mm256_set1_ps(float(column)), columnsOfVector), _mm256_set1_ps(bounds.offsetX));
+      __m256 pathX = _mm256_mul_ps(meanOfFaces(faces[0], cell), time);
+      __m256 pathY = _mm256_mul_ps(meanOfFaces(faces[1], cell), time);
+      __m256 pathZ = _mm256_mul_ps(meanOfFaces(faces[2], cell), time);
+
+      locate(bounds, _mm256_sub_ps(x, pathX), _mm256_sub_ps(pointY, pathY), _mm256_sub_ps(pointZ, pathZ), from + cell * 4);
+      if (to != nullptr)
+        locate(bounds, _mm256_add_ps(x, pathX), _mm256_add_ps(pointY, pathY), _mm256_add_ps(pointZ, pathZ), to + cell * 4);
+    }
+    return column;
+  }
+
+  UNREAL_FLUID_TARGET_AVX2
+  int interpolateRowAvx2(const float *field, const float *stencils, float *values, size_t first, int columns,
+                         int stride, int layerStride) {
+    int column = 0;
+    for (; column + 8 <= columns; column += 8) {
+      size_t cell = first + column;
+      _mm256_storeu_ps(values + cell, interpolate(field, stencils + cell * 4, stride, layerStride));
+    }
+    return column;
+  }
+
+  UNREAL_FLUID_TARGET_AVX2
+  int correctRowAvx2(const float *field, const float *uncorrected, const float *from, const float *to, float *advected,
+                     size_t first, int columns, int stride, int layerStride) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+
+    int column = 0;
+    for (; column + 8 <= columns; column += 8) {
+      size_t cell = first + column;
+      __m256 low, high;
+      (void)interpolate(field, from + cell * 4, stride, layerStride, &low, &high);
+      __m256 traced = interpolate(uncorrected, to + cell * 4, stride, layerStride);
+
+      __m256 value = _mm256_loadu_ps(uncorrected + cell);
+      __m256 corrected = _mm256_fmadd_ps(_mm256_sub_ps(_mm256_loadu_ps(field + cell), traced), half, value);
+      __m256 inside = _mm256_and_ps(_mm256_cmp_ps(corrected, low, _CMP_GE_OQ), _mm256_cmp_ps(corrected, high, _CMP_LE_OQ));
+      _mm256_storeu_ps(advected + cell, _mm256_blendv_ps(value, corrected, inside));
+    }
+    return column;
+  }
+
+  /// @brief returns differences of pressure between four cells and the ones offset before them
+  UNREAL_FLUID_TARGET_AVX2
+  inline __m128 pressureDifference(const double *pressure, size_t cell, size_t offset) {
+    return _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(pressure + cell), _mm256_loadu_pd(pressure + cell - offset)));
+  }
+
+  UNREAL_FLUID_TARGET_AVX2
+  int divergenceRowAvx2(const float *velocityX, const float *velocityY, const float *velocityZ, double *divergence,
+                        size_t first, int columns, size_t stride, size_t layerStride) {
+    int column = 0;
+    for (; column + 8 <= columns; column += 8) {
+      size_t cell = first + column;
+      __m256 sum = _mm256_sub_ps(_mm256_loadu_ps(velocityX + cell + 1), _mm256_loadu_ps(velocityX + cell));
+      sum = _mm256_add_ps(sum, _mm256_loadu_ps(velocityY + cell + stride));
+      sum = _mm256_sub_ps(sum, _mm256_loadu_ps(velocityY + cell));
+      sum = _mm256_add_ps(sum, _mm256_loadu_ps(velocityZ + cell + layerStride));
+      sum = _mm256_sub_ps(sum, _mm256_loadu_ps(velocityZ + cell));
+
+      _mm256_storeu_pd(divergence + cell, _mm256_cvtps_pd(_mm256_castps256_ps128(sum)));
+      _mm256_storeu_pd(divergence + cell + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(sum, 1)));
+    }
+    return column;
+  }
+
+  /// @brief subtracts differences of pressure from faces of cells until fewer than four are left, returns the first one left
+  UNREAL_FLUID_TARGET_AVX2
+  size_t subtractGradientAvx2(const double *pressure, float *velocity, size_t cell, size_t end, size_t offset) {
+    for (; cell + 4 <= end; cell += 4)
+      _mm_storeu_ps(velocity + cell, _mm_sub_ps(_mm_loadu_ps(velocity + cell), pressureDifference(pressure, cell, offset)));
+    return cell;
+  }
+#endif
+
+  bool useAvx2() {
+    return CpuFeatures::getInstructionSet() >= CpuFeatures::InstructionSet::AVX2;
+  }
+} // namespace
+
+void GasContainer3d::traceRow(size_t first, int row, int layer, int columns, float offsetX, float offsetY, float offsetZ,
+                              float dt) {
+  float y = float(row) + offsetY, z = float(layer) + offsetZ;
+  int column = 0;
+
+#ifdef UNREAL_FLUID_X86_64
+  if (useAvx2()) {
+    /* the same faces as velocityAtPoint() reads */
+    auto stride = ptrdiff_t(_stride), layerStride = ptrdiff_t(_layerStride);
+    Faces faces[3] = {{_velocityX.data(), 0, 1, 0}, {_velocityY.data(), 0, stride, 0}, {_velocityZ.data(), 0, layerStride, 0}};
+    if (offsetX == 0) {
+      faces[0] = {_velocityX.data(), 0, 0, 0};
+      faces[1] = {_velocityY.data(), -1, 1, stride};
+      faces[2] = {_velocityZ.data(), -1, 1, layerStride};
+    } else if (offsetY == 0) {
+      faces[0] = {_velocityX.data(), -stride, 1, stride};
+      faces[1] = {_velocityY.data(), 0, 0, 0};
+      faces[2] = {_velocityZ.data(), -stride, stride, layerStride};
+    } else if (offsetZ == 0) {
+      faces[0] = {_velocityX.data(), -layerStride, 1, layerStride};
+      faces[1] = {_velocityY.data(), -layerStride, stride, layerStride};
+      faces[2] = {_velocityZ.data(), 0, 0, 0};
+    }
+
+    float maxX = float(_width) - 2 * offsetX, maxY = float(_height) - 2 * offsetY, maxZ = float(_depth) - 2 * offsetZ;
+    Bounds bounds{offsetX, offsetY, offsetZ, maxX, maxY, maxZ,
+                  std::max(int(maxX) - 1, 0), std::max(int(maxY) - 1, 0), std::max(int(maxZ) - 1, 0), int(_stride), int(_layerStride)};
+    column = traceRowAvx2(faces, bounds, first, y, z, columns, dt, reinterpret_cast<float *>(_from.data()),
+                          _parameters.maccormack ? reinterpret_cast<float *>(_to.data()) : nullptr);
+  }
+#endif
+
+  for (size_t cell = first + column; column < columns; ++column, ++cell) {
+    float x = float(column) + offsetX;
+    vec3f path = velocityAtPoint(cell, offsetX, offsetY, offsetZ) * dt;
+    _from[cell] = locate(x - path.x, y - path.y, z - path.z, offsetX, offsetY, offsetZ);
+    if (_parameters.maccormack)
+      _to[cell] = locate(x + path.x, y + path.y, z + path.z, offsetX, offsetY, offsetZ);
+  }
+}
+
+void GasContainer3d::interpolateRow(const std::vector<float> &field, std::vector<float> &values, size_t first, int columns) {
+  int column = 0;
+
+#ifdef UNREAL_FLUID_X86_64
+  if (useAvx2())
+    column = interpolateRowAvx2(field.data(), reinterpret_cast<const float *>(_from.data()), values.data(), first, columns,
+                                int(_stride), int(_layerStride));
+#endif
+
+  for (size_t cell = first + column; column < columns; ++column, ++cell)
+    values[cell] = interpolate(field, _from[cell]);
+}
+
+void GasContainer3d::correctRow(const std::vector<float> &field, std::vector<float> &advected, size_t first, int columns) {
+  int column = 0;
+
+#ifdef UNREAL_FLUID_X86_64
+  if (useAvx2())
+    column = correctRowAvx2(field.data(), _uncorrected.data(), reinterpret_cast<const float *>(_from.data()),
+                            reinterpret_cast<const float *>(_to.data()), advected.data(), first, columns, int(_stride), int(_layerStride));
+#endif
+
+  for (size_t cell = first + column; column < columns; ++column, ++cell) {
+    float low, high;
+    (void)interpolate(field, _from[cell], &low, &high);
+    float corrected = _uncorrected[cell] + (field[cell] - interpolate(_uncorrected, _to[cell])) * 0.5f;
+    advected[cell] = corrected >= low && corrected <= high ? corrected : _uncorrected[cell];
+  }
+}
+
+void GasContainer3d::divergenceRow(size_t first) {
+  int column = 0;
+
+#ifdef UNREAL_FLUID_X86_64
+  if (useAvx2())
+    column = divergenceRowAvx2(_velocityX.data(), _velocityY.data(), _velocityZ.data(), _divergence.data(), first, _width,
+                               _stride, _layerStride);
+#endif
+
+  for (size_t cell = first + column; column < _width; ++column, ++cell)
+    _divergence[cell] = double(_velocityX[cell + 1] - _velocityX[cell] + _velocityY[cell + _stride] - _velocityY[cell] +
+                               _velocityZ[cell + _layerStride] - _velocityZ[cell]);
+}
+
+void GasContainer3d::subtractGradientRow(size_t first, int row, int layer) {
+  auto subtract = [&](std::vector<float> &velocity, size_t cell, size_t offset) {
+    size_t end = first + _width;
+#ifdef UNREAL_FLUID_X86_64
+    if (useAvx2())
+      cell = subtractGradientAvx2(_pressure.data(), velocity.data(), cell, end, offset);
+#endif
+    for (; cell < end; ++cell)
+      velocity[cell] -= float(_pressure[cell] - _pressure[cell - offset]);
+  };
+
+  /* the first face along x is a wall, faces along y and z are walls in the first row and layer */
+  subtract(_velocityX, first + 1, 1);
+  if (row > 0) subtract(_velocityY, first, _stride);
+  if (layer > 0) subtract(_velocityZ, first, _layerStride);
+}
+
+// end of GasContainer3D.Kernels.cxx
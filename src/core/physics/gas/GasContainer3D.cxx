@@ -0,0 +1,230 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : GasContainer3D.cxx
+ * PURPOSE   : 3-dimensional gas moved by stable fluids steps
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "GasContainer3D.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#include "solver/MultigridSolver.h"
+
+using namespace unreal_fluid::physics::gas;
+
+GasContainer3d::GasContainer3d(int height, int width, int depth, StableFluidParameters parameters) : _parameters(parameters),
+                                                                                                     _height(height),
+                                                                                                     _width(width),
+                                                                                                     _depth(depth),
+                                                                                                     _stride(width + 2),
+                                                                                                     _layerStride((width + 2) * size_t(height + 2)),
+                                                                                                     _pressureGrid(width, height, depth),
+                                                                                                     _pressureSolver(std::make_unique<MultigridSolver>()) {
+  assert(depth > 1);
+  /* row kernels gather corners of stencils by signed 32-bit cells */
+  assert(_pressureGrid.size() <= INT32_MAX);
+
+  size_t size = _pressureGrid.size();
+  _amount.resize(size, 0);
+  _temperature.resize(size, float(parameters.ambientTemperature));
+  _red.resize(size, 1);
+  _green.resize(size, 1);
+  _blue.resize(size, 1);
+  _velocityX.resize(size, 0);
+  _velocityY.resize(size, 0);
+  _velocityZ.resize(size, 0);
+  _pressure.resize(size, 0);
+  _divergence.resize(size, 0);
+}
+
+void GasContainer3d::setGas(int row, int column, int layer, double amount, vec3f color, double temperature) {
+  size_t cell = index(row, column, layer);
+  _amount[cell] = float(amount);
+  _temperature[cell] = float(temperature);
+  _red[cell] = color.x;
+  _green[cell] = color.y;
+  _blue[cell] = color.z;
+}
+
+unreal_fluid::physics::IPhysicalObject::Type GasContainer3d::getType() {
+  return Type::GAS_CONTAINER_3D;
+}
+
+template<typename Body>
+void GasContainer3d::forEachRow(int rows, int layers, Body &&body) {
+  _threadPool.parallelFor(size_t(rows) * layers, [&](size_t begin, size_t end, unsigned) {
+    for (size_t line = begin; line < end; ++line) {
+      int layer = int(line / rows), row = int(line % rows);
+      body(index(row, 0, layer), row, layer);
+    }
+  });
+}
+
+void GasContainer3d::simulate(double dt) {
+  auto step = float(dt);
+
+  /* all components are traced back through the old velocities */
+  trace(0, 0.5f, 0.5f, step);
+  advectField(_velocityX, _newVelocityX, 0, 0.5f, 0.5f);
+  trace(0.5f, 0, 0.5f, step);
+  advectField(_velocityY, _newVelocityY, 0.5f, 0, 0.5f);
+  trace(0.5f, 0.5f, 0, step);
+  advectField(_velocityZ, _newVelocityZ, 0.5f, 0.5f, 0);
+  _velocityX.swap(_newVelocityX);
+  _velocityY.swap(_newVelocityY);
+  _velocityZ.swap(_newVelocityZ);
+
+  /* forces go after advection, so a jet faster than its own width still carries gas in the step it is pushed */
+  addBuoyancy(step);
+  project();
+
+  /* quantities of gas are given at centres of cells and share their paths */
+  trace(0.5f, 0.5f, 0.5f, step);
+  advectField(_amount, _advected, 0.5f, 0.5f, 0.5f);
+  _amount.swap(_advected);
+  advectField(_temperature, _advected, 0.5f, 0.5f, 0.5f);
+  _temperature.swap(_advected);
+  advectField(_red, _advected, 0.5f, 0.5f, 0.5f);
+  _red.swap(_advected);
+  advectField(_green, _advected, 0.5f, 0.5f, 0.5f);
+  _green.swap(_advected);
+  advectField(_blue, _advected, 0.5f, 0.5f, 0.5f);
+  _blue.swap(_advected);
+
+  dissolveCells(step);
+}
+
+void GasContainer3d::addBuoyancy(float dt) {
+  auto lift = float(_parameters.lift), weight = float(_parameters.weight);
+  auto ambient = float(_parameters.ambientTemperature);
+
+  /* lower faces of cells above the bottom row, between the cell and the one under it */
+  forEachRow(_height, _depth, [&](size_t cell, int row, int) {
+    if (row == 0)
+      return;
+    for (int column = 0; column < _width; ++column, ++cell) {
+      float temperature = (_temperature[cell] + _temperature[cell - _stride]) * 0.5f;
+      float amount = (_amount[cell] + _amount[cell - _stride]) * 0.5f;
+      _velocityY[cell] += dt * (lift * (temperature - ambient) - weight * amount);
+    }
+  });
+}
+
+void GasContainer3d::project() {
+  /* nothing passes through the walls */
+  forEachRow(_height, _depth, [&](size_t cell, int row, int layer) {
+    _velocityX[cell] = 0;
+    _velocityX[cell + _width] = 0;
+    if (row == 0) std::fill_n(_velocityY.begin() + cell, _width, 0.0f);
+    if (row == _height - 1) std::fill_n(_velocityY.begin() + cell + _stride, _width, 0.0f);
+    if (layer == 0) std::fill_n(_velocityZ.begin() + cell, _width, 0.0f);
+    if (layer == _depth - 1) std::fill_n(_velocityZ.begin() + cell + _layerStride, _width, 0.0f);
+  });
+
+  forEachRow(_height, _depth, [&](size_t cell, int, int) { divergenceRow(cell); });
+
+  /* pressure times dt, the last one is the first guess */
+  _pressureSolver->solve(_pressureGrid, _pressure, _divergence, _threadPool);
+
+  /* a face belongs to the row of the cell above or in front of it, so every face is written once */
+  forEachRow(_height, _depth, [&](size_t cell, int row, int layer) { subtractGradientRow(cell, row, layer); });
+}
+
+void GasContainer3d::dissolveCells(float dt) {
+  int edgeSize = 3;
+
+  forEachRow(_height, _depth, [&](size_t first, int row, int layer) {
+    bool edge = row < edgeSize || row >= _height - edgeSize || layer < edgeSize || layer >= _depth - edgeSize;
+    for (int column = 0; column < _width; ++column) {
+      /* inner rows skip from the left edge straight to the right one */
+      if (!edge && column == edgeSize) column = std::max(column, _width - edgeSize);
+      float &amount = _amount[first + column];
+      amount = std::max(amount - dt * amount, 0.0f);
+    }
+  });
+}
+
+vec3f GasContainer3d::velocityAt(float x, float y, float z) const {
+  return {sample(_velocityX, x, y, z, 0, 0.5f, 0.5f),
+          sample(_velocityY, x, y, z, 0.5f, 0, 0.5f),
+          sample(_velocityZ, x, y, z, 0.5f, 0.5f, 0)};
+}
+
+vec3f GasContainer3d::velocityAtPoint(size_t cell, float offsetX, float offsetY, float offsetZ) const {
+  /* components given at the point are read as they are, the others are means of the nearest faces,
+   * ghost faces next to walls are zero */
+  auto mean = [](const std::vector<float> &field, size_t first, size_t step, size_t across) {
+    return (field[first] + field[first + step] + field[first + across] + field[first + step + across]) * 0.25f;
+  };
+
+  if (offsetX == 0)
+    return {_velocityX[cell], mean(_velocityY, cell - 1, 1, _stride), mean(_velocityZ, cell - 1, 1, _layerStride)};
+  if (offsetY == 0)
+    return {mean(_velocityX, cell - _stride, 1, _stride), _velocityY[cell], mean(_velocityZ, cell - _stride, _stride, _layerStride)};
+  if (offsetZ == 0)
+    return {mean(_velocityX, cell - _layerStride, 1, _layerStride), mean(_velocityY, cell - _layerStride, _stride, _layerStride), _velocityZ[cell]};
+  return {(_velocityX[cell] + _velocityX[cell + 1]) * 0.5f,
+          (_velocityY[cell] + _velocityY[cell + _stride]) * 0.5f,
+          (_velocityZ[cell] + _velocityZ[cell + _layerStride]) * 0.5f};
+}
+
+void GasContainer3d::trace(float offsetX, float offsetY, float offsetZ, float dt) {
+  int columns = int(float(_width) - 2 * offsetX) + 1;
+  int rows = int(float(_height) - 2 * offsetY) + 1;
+  int layers = int(float(_depth) - 2 * offsetZ) + 1;
+
+  _from.resize(_pressureGrid.size());
+  if (_parameters.maccormack) _to.resize(_pressureGrid.size());
+
+  forEachRow(rows, layers, [&](size_t cell, int row, int layer) {
+    traceRow(cell, row, layer, columns, offsetX, offsetY, offsetZ, dt);
+  });
+}
+
+void GasContainer3d::advectField(const std::vector<float> &field, std::vector<float> &advected,
+                                 float offsetX, float offsetY, float offsetZ) {
+  int columns = int(float(_width) - 2 * offsetX) + 1;
+  int rows = int(float(_height) - 2 * offsetY) + 1;
+  int layers = int(float(_depth) - 2 * offsetZ) + 1;
+
+  /* ghost cells and faces outside of the points are never read, they are left as they are */
+  advected.resize(field.size(), 0);
+  if (!_parameters.maccormack) {
+    forEachRow(rows, layers, [&](size_t cell, int, int) { interpolateRow(field, advected, cell, columns); });
+    return;
+  }
+
+  /* carrying the result forward again should give the field, half of the difference is the error of advection,
+   * corrected values outside of the values they came from would grow into oscillations */
+  _uncorrected.resize(field.size(), 0);
+  forEachRow(rows, layers, [&](size_t cell, int, int) { interpolateRow(field, _uncorrected, cell, columns); });
+  forEachRow(rows, layers, [&](size_t cell, int, int) { correctRow(field, advected, cell, columns); });
+}
+
+void GasContainer3d::copyVolume(std::vector<float> &colors, std::vector<float> &amounts, float amountScale) {
+  size_t cells = size_t(_width) * _height * _depth;
+  colors.resize(cells * 3);
+  amounts.resize(cells);
+
+  forEachRow(_height, _depth, [&](size_t cell, int row, int layer) {
+    size_t pixel = (size_t(layer) * _height + row) * _width;
+    for (int column = 0; column < _width; ++column, ++cell, ++pixel) {
+      colors[pixel * 3 + 0] = _red[cell];
+      colors[pixel * 3 + 1] = _green[cell];
+      colors[pixel * 3 + 2] = _blue[cell];
+      amounts[pixel] = _amount[cell] * amountScale;
+    }
+  });
+}
+
+// end of GasContainer3D.cxx
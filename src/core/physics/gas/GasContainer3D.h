@@ -0,0 +1,233 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : GasContainer3D.h
+ * PURPOSE   : 3-dimensional gas moved by stable fluids steps
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../Simulator.h"
+#include "GasContainer2D.h"
+#include "solver/IPoissonSolver.h"
+
+namespace unreal_fluid::physics::gas {
+  /// @brief Gas in a 3D box of cells.
+  /// @details The STABLE_FLUIDS mode of GasContainer2d with one more dimension. Velocities live on the left,
+  /// lower and back faces of cells, every step advects velocities, adds buoyancy, projects them to zero
+  /// divergence and advects gas along them. Rows grow upwards, layers grow to the front.
+  /// Points are traced with one Euler step of the velocity at the point, which needs no interpolation,
+  /// and MacCormack correction makes advection second order again, as real-time smoke solvers do.
+  ///
+  /// Fields are laid out as PoissonGrid fields of the box: row-major layers with one ring of ghost cells
+  /// and one ghost layer below and above the box, so stencils read neighbours without bounds checks.
+  /// Quantities of gas and velocities are floats, it halves the memory a 128^3 box streams through
+  /// and lets inner loops vectorise. Rows of every stage are split between threads of a pool and every
+  /// cell is written by one thread from fields of the previous stage, so results do not depend on
+  /// the amount of threads. Cell centres are traced once per step for all quantities of gas.
+  ///
+  /// Tracing, interpolation, MacCormack correction, divergence and gradient are row kernels, see
+  /// GasContainer3D.Kernels.cxx. AVX2 kernels take eight points of a row at once and gather corners of
+  /// their stencils, they fuse multiply-adds, so they round differently from the scalar ones.
+  class GasContainer3d : public IPhysicalObject {
+  private:
+    /// @brief where a field is interpolated at a point: the first of the eight cells around it and fractions
+    /// of the way to the others, all fields given at the same points share it
+    struct Stencil {
+      uint32_t cell;
+      float fractionX;
+      float fractionY;
+      float fractionZ;
+    };
+
+    StableFluidParameters _parameters;
+
+    int _height;
+    int _width;
+    int _depth;
+    size_t _stride;      // width with ghost cells
+    size_t _layerStride; // layer with ghost rows
+
+    /* fields of cells, including ghost ones */
+    std::vector<float> _amount;
+    std::vector<float> _temperature;
+    std::vector<float> _red;
+    std::vector<float> _green;
+    std::vector<float> _blue;
+
+    /* velocities are stored at the left, the lower and the back face of a cell */
+    std::vector<float> _velocityX;
+    std::vector<float> _velocityY;
+    std::vector<float> _velocityZ;
+    std::vector<float> _newVelocityX;
+    std::vector<float> _newVelocityY;
+    std::vector<float> _newVelocityZ;
+
+    std::vector<double> _pressure;
+    std::vector<double> _divergence;
+    PoissonGrid _pressureGrid;
+    std::unique_ptr<IPoissonSolver> _pressureSolver;
+    utils::ThreadPool _threadPool;
+
+    /* paths of the points a field is given at, filled by trace() */
+    std::vector<Stencil> _from; // where a point came from dt ago
+    std::vector<Stencil> _to;   // where a point goes in dt, for MacCormack correction only
+    std::vector<float> _advected;    // new values of a field while it is advected
+    std::vector<float> _uncorrected; // values carried along paths before MacCormack correction
+
+  public:
+    /// @brief Constructor.
+    /// @param height, width, depth size of container in cells, depth is at least 2, flat gas is GasContainer2d
+    /// @param parameters parameters of stable fluids steps
+    GasContainer3d(int height, int width, int depth, StableFluidParameters parameters = {});
+
+    /// @brief sets amount of threads, 0 means all hardware threads
+    void setThreadsCount(unsigned threadsCount) { _threadPool.setThreadsCount(threadsCount); }
+
+    /// @brief replaces gas in cell
+    void setGas(int row, int column, int layer, double amount, vec3f color, double temperature = 300);
+
+    /* abstract class implementation */
+
+    [[nodiscard]] Type getType() override;
+
+    [[nodiscard]] int getHeight() const { return _height; }
+    [[nodiscard]] int getWidth() const { return _width; }
+    [[nodiscard]] int getDepth() const { return _depth; }
+
+    /// @brief returns amount of gas in cell
+    [[nodiscard]] double getAmount(int row, int column, int layer) const { return _amount[index(row, column, layer)]; }
+
+    /// @brief returns colour of gas in cell
+    [[nodiscard]] vec3f getColor(int row, int column, int layer) const {
+      size_t cell = index(row, column, layer);
+      return {_red[cell], _green[cell], _blue[cell]};
+    }
+
+    /// @brief returns velocity at the centre of cell
+    [[nodiscard]] vec3f getVelocity(int row, int column, int layer) const {
+      return velocityAt(float(column) + 0.5f, float(row) + 0.5f, float(layer) + 0.5f);
+    }
+
+    /// @brief returns solver of the pressure equation, it keeps statistics of solves
+    [[nodiscard]] IPoissonSolver &getPressureSolver() const { return *_pressureSolver; }
+
+    /// @brief replaces solver of the pressure equation
+    void setPressureSolver(std::unique_ptr<IPoissonSolver> solver) { _pressureSolver = std::move(solver); }
+
+    /// @brief copies cells without ghost ones to buffers of 3D textures: layers of rows of columns
+    /// @param colors receives red, green and blue of every cell
+    /// @param amounts receives amount of gas of every cell times amountScale
+    void copyVolume(std::vector<float> &colors, std::vector<float> &amounts, float amountScale);
+
+  private:
+    /// @brief returns index of cell in fields, rows, columns and layers start from 0 without ghost cells
+    [[nodiscard]] size_t index(int row, int column, int layer) const {
+      return (layer + 1) * _layerStride + (row + 1) * _stride + column + 1;
+    }
+
+    /// @brief calls body(first cell of the row, row, layer) for rows of layers, rows are split between threads
+    template<typename Body>
+    void forEachRow(int rows, int layers, Body &&body);
+
+    /// @brief Simulate gas container.
+    /// @param dt time step
+    void simulate(double dt) override;
+
+    /// @brief Accelerates hot gas up and dense gas down.
+    /// @param dt time step
+    void addBuoyancy(float dt);
+
+    /// @brief Makes velocities divergence free.
+    void project();
+
+    /// @brief Dissolve gas near the walls.
+    /// @param dt time step
+    void dissolveCells(float dt);
+
+    /// @brief returns velocity at a point, x goes along columns, y along rows and z along layers, cells are 1x1x1
+    [[nodiscard]] vec3f velocityAt(float x, float y, float z) const;
+
+    /// @brief returns stencil of a point in fields given at points (column + offsetX, row + offsetY, layer + offsetZ)
+    /// @details points outside the field take values of its nearest border
+    [[nodiscard]] Stencil locate(float x, float y, float z, float offsetX, float offsetY, float offsetZ) const {
+      float maxX = float(_width) - 2 * offsetX, maxY = float(_height) - 2 * offsetY, maxZ = float(_depth) - 2 * offsetZ;
+      float gridX = std::clamp(x - offsetX, 0.0f, maxX);
+      float gridY = std::clamp(y - offsetY, 0.0f, maxY);
+      float gridZ = std::clamp(z - offsetZ, 0.0f, maxZ);
+
+      int column = std::min(int(gridX), std::max(int(maxX) - 1, 0));
+      int row = std::min(int(gridY), std::max(int(maxY) - 1, 0));
+      int layer = std::min(int(gridZ), std::max(int(maxZ) - 1, 0));
+      return {uint32_t(index(row, column, layer)), gridX - float(column), gridY - float(row), gridZ - float(layer)};
+    }
+
+    /// @brief returns trilinear interpolation of a field at a stencil
+    /// @param low, high if given, receive the smallest and the largest of the interpolated values
+    [[nodiscard]] float interpolate(const std::vector<float> &field, const Stencil &stencil,
+                                    float *low = nullptr, float *high = nullptr) const {
+      const float *back = field.data() + stencil.cell, *front = back + _layerStride;
+      float a = back[0], b = back[1], c = back[_stride], d = back[_stride + 1];
+      float e = front[0], f = front[1], g = front[_stride], h = front[_stride + 1];
+
+      if (low != nullptr) *low = std::min(std::min(std::min(a, b), std::min(c, d)), std::min(std::min(e, f), std::min(g, h)));
+      if (high != nullptr) *high = std::max(std::max(std::max(a, b), std::max(c, d)), std::max(std::max(e, f), std::max(g, h)));
+
+      float lower = a + (b - a) * stencil.fractionX, upper = c + (d - c) * stencil.fractionX;
+      float backValue = lower + (upper - lower) * stencil.fractionY;
+      lower = e + (f - e) * stencil.fractionX, upper = g + (h - g) * stencil.fractionX;
+      float frontValue = lower + (upper - lower) * stencil.fractionY;
+      return backValue + (frontValue - backValue) * stencil.fractionZ;
+    }
+
+    /// @brief returns trilinear interpolation of a field given at points (column + offsetX, row + offsetY, layer + offsetZ)
+    [[nodiscard]] float sample(const std::vector<float> &field, float x, float y, float z,
+                               float offsetX, float offsetY, float offsetZ) const {
+      return interpolate(field, locate(x, y, z, offsetX, offsetY, offsetZ));
+    }
+
+    /// @brief returns velocity at point (column + offsetX, row + offsetY, layer + offsetZ) of cell,
+    /// offsets are 0 or 0.5 and at most one of them is 0
+    [[nodiscard]] vec3f velocityAtPoint(size_t cell, float offsetX, float offsetY, float offsetZ) const;
+
+    /// @brief fills stencils of paths of points (column + offsetX, row + offsetY, layer + offsetZ) through current velocities
+    void trace(float offsetX, float offsetY, float offsetZ, float dt);
+
+    /// @brief fills advected with values of a field carried along the last traced paths
+    void advectField(const std::vector<float> &field, std::vector<float> &advected,
+                     float offsetX, float offsetY, float offsetZ);
+
+    /* row kernels, implemented in GasContainer3D.Kernels.cxx */
+
+    /// @brief fills stencils of paths of the first columns points of a row, see trace()
+    /// @param first cell of the first point of the row
+    void traceRow(size_t first, int row, int layer, int columns, float offsetX, float offsetY, float offsetZ, float dt);
+
+    /// @brief fills values of the first columns points of a row with a field interpolated where they came from
+    void interpolateRow(const std::vector<float> &field, std::vector<float> &values, size_t first, int columns);
+
+    /// @brief fills advected of points of a row with _uncorrected ones corrected by MacCormack's step,
+    /// corrected values outside of the values they came from are left uncorrected
+    void correctRow(const std::vector<float> &field, std::vector<float> &advected, size_t first, int columns);
+
+    /// @brief fills _divergence of cells of a row
+    void divergenceRow(size_t first);
+
+    /// @brief subtracts differences of _pressure from faces of cells of a row, walls are left as they are
+    void subtractGradientRow(size_t first, int row, int layer);
+  };
+} // namespace unreal_fluid::physics::gas
+
+// end of GasContainer3D.h
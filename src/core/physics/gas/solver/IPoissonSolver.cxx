@@ -0,0 +1,40 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : IPoissonSolver.cxx
+ * PURPOSE   : interface of linear solvers of the pressure equation
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "IPoissonSolver.h"
+
+#include "../../../../utils/timer/Timer.h"
+
+using namespace unreal_fluid::physics::gas;
+
+void IPoissonSolver::solve(const PoissonGrid &grid, std::vector<double> &pressure, const std::vector<double> &rhs, utils::ThreadPool &pool) {
+  utils::Timer timer;
+
+  pressure.resize(grid.size(), 0);
+  grid.clearGhosts(pressure);
+
+  /* rhs of zero is solved by any constant, the first guess is kept then */
+  double target = parameters.tolerance * grid.norm(rhs, pool);
+  double residual = 0;
+  int iterations = target > 0 ? iterate(grid, pressure, rhs, target, residual, pool) : 0;
+
+  statistics.solves++;
+  statistics.iterations += iterations;
+  statistics.lastIterations = iterations;
+  statistics.lastResidual = residual;
+  statistics.lastTime = timer.getElapsedTime();
+  statistics.time += statistics.lastTime;
+}
+
+// end of IPoissonSolver.cxx
@@ -0,0 +1,72 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : IPoissonSolver.h
+ * PURPOSE   : interface of linear solvers of the pressure equation
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "PoissonGrid.h"
+
+namespace unreal_fluid::physics::gas {
+  struct PoissonSolverParameters {
+    int maxIterations = 200;
+    double tolerance = 1e-4; // stops once the largest residual is this part of the largest rhs
+  };
+
+  /// @brief Iterative solver of PoissonGrid equations.
+  /// @details solve() measures time and keeps statistics, iterations are done by implementations.
+  /// An iteration is whatever the method repeats: a sweep, a step of conjugate gradients or a V-cycle.
+  class IPoissonSolver {
+  public:
+    struct Statistics {
+      size_t solves = 0;
+      size_t iterations = 0;    // over all solves
+      double time = 0;          // seconds over all solves
+      int lastIterations = 0;
+      double lastResidual = 0;  // largest residual left by the last solve
+      double lastTime = 0;
+    };
+
+  protected:
+    PoissonSolverParameters parameters;
+    Statistics statistics;
+
+  public:
+    explicit IPoissonSolver(PoissonSolverParameters parameters) : parameters(parameters) {}
+    virtual ~IPoissonSolver() = default;
+
+    /// @brief solves the equation, stops once the residual is small enough or after maxIterations
+    /// @param pressure the first guess, receives the solution; ghost cells are set to zero
+    /// @param rhs right side of the equation, ghost cells are not read
+    /// @param pool threads grid kernels run on
+    void solve(const PoissonGrid &grid, std::vector<double> &pressure, const std::vector<double> &rhs, utils::ThreadPool &pool);
+
+    [[nodiscard]] virtual std::string getName() const = 0;
+
+    [[nodiscard]] const PoissonSolverParameters &getParameters() const { return parameters; }
+    void setParameters(const PoissonSolverParameters &newParameters) { parameters = newParameters; }
+
+    [[nodiscard]] const Statistics &getStatistics() const { return statistics; }
+    void resetStatistics() { statistics = {}; }
+
+  protected:
+    /// @brief iterates until the largest residual is at most target
+    /// @param residual receives the largest residual left
+    /// @return amount of iterations done
+    virtual int iterate(const PoissonGrid &grid, std::vector<double> &pressure, const std::vector<double> &rhs,
+                        double target, double &residual, utils::ThreadPool &pool) = 0;
+  };
+} // namespace unreal_fluid::physics::gas
+
+// end of IPoissonSolver.h
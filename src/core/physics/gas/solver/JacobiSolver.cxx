@@ -0,0 +1,44 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : JacobiSolver.cxx
+ * PURPOSE   : weighted Jacobi solver of the pressure equation
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "JacobiSolver.h"
+
+using namespace unreal_fluid::physics::gas;
+
+JacobiSolver::JacobiSolver(PoissonSolverParameters parameters, double weight) : IPoissonSolver(parameters), weight(weight) {}
+
+int JacobiSolver::iterate(const PoissonGrid &grid, std::vector<double> &pressure, const std::vector<double> &rhs,
+                          double target, double &residual, utils::ThreadPool &pool) {
+  next.assign(grid.size(), 0);
+
+  for (int iteration = 1; iteration <= parameters.maxIterations; ++iteration) {
+    grid.dispatch([&](auto volume) {
+      grid.forEachRow(pool, [&](size_t cell, int, int) {
+        for (int column = 0; column < grid.getWidth(); ++column, ++cell) {
+          double jacobi = (grid.sumNeighbours(pressure, cell, volume) - rhs[cell]) * grid.getInverseNeighbours(cell);
+          next[cell] = pressure[cell] + weight * (jacobi - pressure[cell]);
+        }
+      });
+    });
+    pressure.swap(next);
+
+    if (iteration % residualInterval == 0 || iteration == parameters.maxIterations) {
+      residual = grid.residual(pressure, rhs, residualField, pool);
+      if (residual <= target) return iteration;
+    }
+  }
+  return parameters.maxIterations;
+}
+
+// end of JacobiSolver.cxx
@@ -0,0 +1,43 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : JacobiSolver.h
+ * PURPOSE   : weighted Jacobi solver of the pressure equation
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include "IPoissonSolver.h"
+
+namespace unreal_fluid::physics::gas {
+  /// @brief Weighted Jacobi iterations.
+  /// @details Every sweep computes all cells from the previous sweep, so cells are independent of each other.
+  /// Plain Jacobi never damps the checkerboard mode of a grid closed by walls, the weight below 1 does.
+  /// Errors of wavelength l decay in about l^2 sweeps, so large grids need thousands of them.
+  class JacobiSolver : public IPoissonSolver {
+  private:
+    double weight;
+    std::vector<double> next;
+    std::vector<double> residualField;
+
+    static constexpr int residualInterval = 8; // sweeps between residual checks
+
+  public:
+    explicit JacobiSolver(PoissonSolverParameters parameters = {}, double weight = 2.0 / 3);
+
+    [[nodiscard]] std::string getName() const override { return "Jacobi"; }
+
+  protected:
+    int iterate(const PoissonGrid &grid, std::vector<double> &pressure, const std::vector<double> &rhs,
+                double target, double &residual, utils::ThreadPool &pool) override;
+  };
+} // namespace unreal_fluid::physics::gas
+
+// end of JacobiSolver.h
@@ -0,0 +1,145 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : MultigridSolver.cxx
+ * PURPOSE   : geometric multigrid solver of the pressure equation
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "MultigridSolver.h"
+
+#include <algorithm>
+
+using namespace unreal_fluid::physics::gas;
+
+MultigridSolver::MultigridSolver(PoissonSolverParameters parameters, int smoothingSweeps) : IPoissonSolver(parameters),
+                                                                                            smoothingSweeps(smoothingSweeps) {}
+
+void MultigridSolver::buildLevels(const PoissonGrid &grid) {
+  if (!levels.empty() && levels[0].grid.getWidth() == grid.getWidth() && levels[0].grid.getHeight() == grid.getHeight() &&
+      levels[0].grid.getDepth() == grid.getDepth())
+    return;
+
+  /* flat grids keep depth 1 on every level */
+  levels.clear();
+  int width = grid.getWidth(), height = grid.getHeight(), depth = grid.getDepth();
+  while (true) {
+    PoissonGrid levelGrid(width, height, depth);
+    size_t size = levelGrid.size();
+    levels.push_back({std::move(levelGrid), std::vector<double>(size, 0), std::vector<double>(size, 0), std::vector<double>(size, 0)});
+    if (std::max({width, height, depth}) <= coarsestSize) break;
+    width = (width + 1) / 2;
+    height = (height + 1) / 2;
+    depth = (depth + 1) / 2;
+  }
+}
+
+int MultigridSolver::iterate(const PoissonGrid &grid, std::vector<double> &pressure, const std::vector<double> &rhs,
+                             double target, double &residual, utils::ThreadPool &pool) {
+  buildLevels(grid);
+  Level &finest = levels[0];
+  finest.pressure.swap(pressure);
+  std::copy(rhs.begin(), rhs.end(), finest.rhs.begin());
+
+  int iterations = parameters.maxIterations;
+  for (int iteration = 1; iteration <= parameters.maxIterations; ++iteration) {
+    cycle(0, pool);
+    residual = finest.grid.residual(finest.pressure, finest.rhs, finest.residual, pool);
+    if (residual <= target) {
+      iterations = iteration;
+      break;
+    }
+  }
+
+  finest.pressure.swap(pressure);
+  return iterations;
+}
+
+void MultigridSolver::cycle(size_t level, utils::ThreadPool &pool) {
+  Level &current = levels[level];
+  if (level + 1 == levels.size()) {
+    for (int sweep = 0; sweep < coarsestSweeps; ++sweep)
+      current.grid.relax(current.pressure, current.rhs, pool);
+    return;
+  }
+
+  for (int sweep = 0; sweep < smoothingSweeps; ++sweep)
+    current.grid.relax(current.pressure, current.rhs, pool);
+
+  current.grid.residual(current.pressure, current.rhs, current.residual, pool);
+  restrict(level, pool);
+  Level &coarse = levels[level + 1];
+  coarse.grid.forEachRow(pool, [&](size_t cell, int, int) {
+    std::fill_n(coarse.pressure.begin() + cell, coarse.grid.getWidth(), 0);
+  });
+  cycle(level + 1, pool);
+  prolongate(level, pool);
+
+  for (int sweep = 0; sweep < smoothingSweeps; ++sweep)
+    current.grid.relax(current.pressure, current.rhs, pool);
+}
+
+void MultigridSolver::restrict(size_t level, utils::ThreadPool &pool) {
+  const PoissonGrid &fine = levels[level].grid, &coarse = levels[level + 1].grid;
+  const std::vector<double> &residual = levels[level].residual;
+  std::vector<double> &rhs = levels[level + 1].rhs;
+  size_t stride = fine.getStride(), layerStride = fine.getLayerStride();
+  double scale = fine.getDepth() > 1 ? 0.5 : 1; // four over the amount of children
+
+  /* the residual here is rhs - L p, the correction e solves L e = residual */
+  coarse.forEachRow(pool, [&](size_t coarseCell, int row, int layer) {
+    bool up = 2 * row + 1 < fine.getHeight(), front = 2 * layer + 1 < fine.getDepth();
+    for (int column = 0; column < coarse.getWidth(); ++column, ++coarseCell) {
+      bool right = 2 * column + 1 < fine.getWidth();
+      size_t cell = fine.index(2 * row, 2 * column, 2 * layer);
+      double sum = 0;
+      for (int z = 0; z <= front; ++z, cell += layerStride) {
+        sum += residual[cell];
+        if (right) sum += residual[cell + 1];
+        if (up) sum += residual[cell + stride];
+        if (right && up) sum += residual[cell + stride + 1];
+      }
+      rhs[coarseCell] = scale * sum;
+    }
+  });
+
+  /* rounding leaves the sum of the residual a little off zero, which has no solution on a closed grid */
+  coarse.removeMean(rhs, pool);
+}
+
+void MultigridSolver::prolongate(size_t level, utils::ThreadPool &pool) {
+  const PoissonGrid &fine = levels[level].grid, &coarse = levels[level + 1].grid;
+  std::vector<double> &pressure = levels[level].pressure;
+  const std::vector<double> &correction = levels[level + 1].pressure;
+
+  /* a fine cell lies a quarter of a coarse cell away from the centre of its parent towards one of the
+   * neighbours along every axis, neighbours outside the grid are replaced by the parent, as walls mirror
+   * the field; weights along an axis are 3/4 and 1/4 */
+  fine.dispatch([&](auto volume) {
+    fine.forEachRow(pool, [&](size_t cell, int row, int layer) {
+      int parentRow = row / 2, parentLayer = layer / 2;
+      int nearRow = std::clamp(row % 2 ? parentRow + 1 : parentRow - 1, 0, coarse.getHeight() - 1);
+      int nearLayer = std::clamp(layer % 2 ? parentLayer + 1 : parentLayer - 1, 0, coarse.getDepth() - 1);
+      for (int column = 0; column < fine.getWidth(); ++column, ++cell) {
+        int parentColumn = column / 2;
+        int nearColumn = std::clamp(column % 2 ? parentColumn + 1 : parentColumn - 1, 0, coarse.getWidth() - 1);
+        auto plane = [&](int coarseLayer) {
+          return 9 * correction[coarse.index(parentRow, parentColumn, coarseLayer)] + 3 * correction[coarse.index(nearRow, parentColumn, coarseLayer)] +
+                 3 * correction[coarse.index(parentRow, nearColumn, coarseLayer)] + correction[coarse.index(nearRow, nearColumn, coarseLayer)];
+        };
+        if constexpr (volume)
+          pressure[cell] += (3 * plane(parentLayer) + plane(nearLayer)) / 64;
+        else
+          pressure[cell] += plane(parentLayer) / 16;
+      }
+    });
+  });
+}
+
+// end of MultigridSolver.cxx
@@ -0,0 +1,66 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : MultigridSolver.h
+ * PURPOSE   : geometric multigrid solver of the pressure equation
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include "IPoissonSolver.h"
+
+namespace unreal_fluid::physics::gas {
+  /// @brief Geometric multigrid, an iteration is one V-cycle.
+  /// @details Smoothing with red-black Gauss-Seidel removes short waves of the error quickly, long waves are
+  /// corrected on a grid twice coarser, recursively down to a few cells. Every coarse cell covers 2x2 fine
+  /// cells, 2x2x2 in a volume. The stencil of a cell twice as large needs four times the rhs per cell, so
+  /// the residual is restricted as four times the mean of the children, which is their sum in 2D.
+  /// Corrections come back bilinearly, trilinearly in a volume. A cycle costs
+  /// about as much as ten sweeps and reduces the residual by a factor that does not depend on the size of
+  /// the grid, so a solve is O(n).
+  class MultigridSolver : public IPoissonSolver {
+  private:
+    struct Level {
+      PoissonGrid grid;
+      std::vector<double> pressure; // the solution on the finest level, corrections on coarser ones
+      std::vector<double> rhs;
+      std::vector<double> residual;
+    };
+
+    int smoothingSweeps;       // before and after the coarse correction
+    std::vector<Level> levels; // from the finest
+
+    static constexpr int coarsestSize = 4;    // grids with no side larger are solved by sweeps alone
+    static constexpr int coarsestSweeps = 40;
+
+  public:
+    explicit MultigridSolver(PoissonSolverParameters parameters = {}, int smoothingSweeps = 2);
+
+    [[nodiscard]] std::string getName() const override { return "multigrid"; }
+
+  protected:
+    int iterate(const PoissonGrid &grid, std::vector<double> &pressure, const std::vector<double> &rhs,
+                double target, double &residual, utils::ThreadPool &pool) override;
+
+  private:
+    /// @brief builds levels unless they are built for a grid of the same size
+    void buildLevels(const PoissonGrid &grid);
+
+    void cycle(size_t level, utils::ThreadPool &pool);
+
+    /// @brief sums the residual of a level over 2x2x2 cells into rhs of the next one
+    void restrict(size_t level, utils::ThreadPool &pool);
+
+    /// @brief adds trilinear interpolation of the next level correction to pressure of a level
+    void prolongate(size_t level, utils::ThreadPool &pool);
+  };
+} // namespace unreal_fluid::physics::gas
+
+// end of MultigridSolver.h
@@ -0,0 +1,123 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : PcgSolver.cxx
+ * PURPOSE   : conjugate gradient solver of the pressure equation with MIC(0) preconditioner
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "PcgSolver.h"
+
+#include <cmath>
+
+using namespace unreal_fluid::physics::gas;
+
+PcgSolver::PcgSolver(PoissonSolverParameters parameters, double tuning) : IPoissonSolver(parameters), tuning(tuning) {}
+
+void PcgSolver::factorize(const PoissonGrid &grid) {
+  if (factorWidth == grid.getWidth() && factorHeight == grid.getHeight() && factorDepth == grid.getDepth()) return;
+  factorWidth = grid.getWidth();
+  factorHeight = grid.getHeight();
+  factorDepth = grid.getDepth();
+
+  /* off-diagonal elements are -1 between neighbours inside the grid, ghost cells of the factor are zero,
+   * so terms of missing neighbours vanish by themselves; safety keeps the diagonal away from zero */
+  const double safety = 0.25;
+  size_t stride = grid.getStride(), layerStride = grid.getLayerStride();
+  factor.assign(grid.size(), 0);
+  for (int layer = 0; layer < factorDepth; ++layer)
+    for (int row = 0; row < factorHeight; ++row) {
+      size_t cell = grid.index(row, 0, layer);
+      for (int column = 0; column < factorWidth; ++column, ++cell) {
+        double diagonal = grid.getNeighbours(cell);
+        if (diagonal == 0) continue;
+
+        /* fill-in comes from pairs of later neighbours of an earlier neighbour, flat grids have no layers behind */
+        bool right = column < factorWidth - 1, up = row < factorHeight - 1, front = layer < factorDepth - 1;
+        double left = factor[cell - 1] * factor[cell - 1];
+        double down = factor[cell - stride] * factor[cell - stride];
+        double back = layer > 0 ? factor[cell - layerStride] * factor[cell - layerStride] : 0;
+        double fill = left * (up + front) + down * (right + front) + back * (right + up);
+        double e = diagonal - left - down - back - tuning * fill;
+        if (e < safety * diagonal) e = diagonal;
+        factor[cell] = 1 / std::sqrt(e);
+      }
+    }
+}
+
+void PcgSolver::precondition(const PoissonGrid &grid, const std::vector<double> &source, std::vector<double> &result) const {
+  size_t stride = grid.getStride(), layerStride = grid.getLayerStride();
+
+  /* forward L q = source, then backward L^T result = q in place, ghost cells stay zero */
+  grid.dispatch([&](auto volume) {
+    for (int layer = 0; layer < factorDepth; ++layer)
+      for (int row = 0; row < factorHeight; ++row) {
+        size_t cell = grid.index(row, 0, layer);
+        for (int column = 0; column < factorWidth; ++column, ++cell) {
+          double sum = source[cell] + factor[cell - 1] * result[cell - 1] + factor[cell - stride] * result[cell - stride];
+          if constexpr (volume) sum += factor[cell - layerStride] * result[cell - layerStride];
+          result[cell] = sum * factor[cell];
+        }
+      }
+    for (int layer = factorDepth - 1; layer >= 0; --layer)
+      for (int row = factorHeight - 1; row >= 0; --row) {
+        size_t cell = grid.index(row, factorWidth - 1, layer);
+        for (int column = factorWidth - 1; column >= 0; --column, --cell) {
+          double sum = result[cell + 1] + result[cell + stride];
+          if constexpr (volume) sum += result[cell + layerStride];
+          result[cell] = (result[cell] + factor[cell] * sum) * factor[cell];
+        }
+      }
+  });
+}
+
+int PcgSolver::iterate(const PoissonGrid &grid, std::vector<double> &pressure, const std::vector<double> &rhs,
+                       double target, double &residual, utils::ThreadPool &pool) {
+  factorize(grid);
+  auxiliary.assign(grid.size(), 0);
+  search.assign(grid.size(), 0);
+  product.assign(grid.size(), 0);
+
+  /* the matrix is the positive form, -rhs is its right side and the residual flips its sign,
+   * which changes nothing below; the mean is removed so the residual stays in the range of the matrix */
+  residual = grid.residual(pressure, rhs, residualField, pool);
+  if (residual <= target) return 0;
+  grid.removeMean(residualField, pool);
+
+  precondition(grid, residualField, auxiliary);
+  search = auxiliary;
+  double sigma = grid.dot(auxiliary, residualField, pool);
+
+  for (int iteration = 1; iteration <= parameters.maxIterations; ++iteration) {
+    grid.multiply(search, product, pool);
+    double alpha = sigma / grid.dot(search, product, pool);
+
+    /* the residual is -(rhs - L p), so the step along search is taken with the opposite sign */
+    grid.forEachRow(pool, [&](size_t cell, int, int) {
+      for (int column = 0; column < grid.getWidth(); ++column, ++cell) {
+        pressure[cell] -= alpha * search[cell];
+        residualField[cell] -= alpha * product[cell];
+      }
+    });
+    residual = grid.norm(residualField, pool);
+    if (residual <= target) return iteration;
+
+    precondition(grid, residualField, auxiliary);
+    double newSigma = grid.dot(auxiliary, residualField, pool);
+    double beta = newSigma / sigma;
+    sigma = newSigma;
+    grid.forEachRow(pool, [&](size_t cell, int, int) {
+      for (int column = 0; column < grid.getWidth(); ++column, ++cell)
+        search[cell] = auxiliary[cell] + beta * search[cell];
+    });
+  }
+  return parameters.maxIterations;
+}
+
+// end of PcgSolver.cxx
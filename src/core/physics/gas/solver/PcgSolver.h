@@ -0,0 +1,57 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : PcgSolver.h
+ * PURPOSE   : conjugate gradient solver of the pressure equation with MIC(0) preconditioner
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include "IPoissonSolver.h"
+
+namespace unreal_fluid::physics::gas {
+  /// @brief Conjugate gradients preconditioned with modified incomplete Cholesky factorisation, MIC(0).
+  /// @details The factor keeps the sparsity of the matrix, modification moves dropped fill-in to the
+  /// diagonal, which keeps the factor exact on smooth errors. Iterations grow as the square root of
+  /// the grid side instead of its square for Jacobi. The factor depends only on the size of the grid
+  /// and is built once for it. Applying it is a forward and a backward sweep, which are sequential,
+  /// other kernels run on threads.
+  class PcgSolver : public IPoissonSolver {
+  private:
+    double tuning;                // part of the dropped fill-in moved to the diagonal
+    int factorWidth = 0;
+    int factorHeight = 0;
+    int factorDepth = 0;
+    std::vector<double> factor;   // inverse diagonal of the factor, zero in ghost cells
+
+    std::vector<double> residualField;
+    std::vector<double> auxiliary; // preconditioned residual
+    std::vector<double> search;
+    std::vector<double> product;   // matrix times search direction
+
+  public:
+    explicit PcgSolver(PoissonSolverParameters parameters = {}, double tuning = 0.97);
+
+    [[nodiscard]] std::string getName() const override { return "MIC(0) conjugate gradient"; }
+
+  protected:
+    int iterate(const PoissonGrid &grid, std::vector<double> &pressure, const std::vector<double> &rhs,
+                double target, double &residual, utils::ThreadPool &pool) override;
+
+  private:
+    /// @brief builds the factor unless it is built for a grid of the same size
+    void factorize(const PoissonGrid &grid);
+
+    /// @brief solves L L^T result = source with the factor
+    void precondition(const PoissonGrid &grid, const std::vector<double> &source, std::vector<double> &result) const;
+  };
+} // namespace unreal_fluid::physics::gas
+
+// end of PcgSolver.h
@@ -0,0 +1,137 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : PoissonGrid.cxx
+ * PURPOSE   : Poisson equation on a padded grid of gas cells
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "PoissonGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace unreal_fluid::physics::gas;
+
+PoissonGrid::PoissonGrid(int width, int height, int depth) : width(width),
+                                                             height(height),
+                                                             depth(depth),
+                                                             stride(width + 2),
+                                                             layerStride((width + 2) * size_t(height + 2)),
+                                                             ghostLayers(depth > 1) {
+  neighbours.resize(size(), 0);
+  inverseNeighbours.resize(size(), 0);
+  rowSums.resize(size_t(height) * depth, 0);
+  for (int layer = 0; layer < depth; ++layer)
+    for (int row = 0; row < height; ++row)
+      for (int column = 0; column < width; ++column) {
+        size_t cell = index(row, column, layer);
+        neighbours[cell] = (column > 0) + (column < width - 1) + (row > 0) + (row < height - 1) + (layer > 0) + (layer < depth - 1);
+        /* a single cell has no equation at all, relaxing it keeps its pressure zero */
+        inverseNeighbours[cell] = neighbours[cell] > 0 ? 1 / neighbours[cell] : 0;
+      }
+}
+
+void PoissonGrid::multiply(const std::vector<double> &x, std::vector<double> &result, utils::ThreadPool &pool) const {
+  result.resize(size(), 0);
+  dispatch([&](auto volume) {
+    forEachRow(pool, [&](size_t cell, int, int) {
+      for (int column = 0; column < width; ++column, ++cell)
+        result[cell] = neighbours[cell] * x[cell] - sumNeighbours(x, cell, volume);
+    });
+  });
+}
+
+double PoissonGrid::residual(const std::vector<double> &pressure, const std::vector<double> &rhs, std::vector<double> &result,
+                             utils::ThreadPool &pool) const {
+  result.resize(size(), 0);
+  dispatch([&](auto volume) {
+    forEachRow(pool, [&](size_t cell, int row, int layer) {
+      double largest = 0;
+      for (int column = 0; column < width; ++column, ++cell) {
+        result[cell] = rhs[cell] + neighbours[cell] * pressure[cell] - sumNeighbours(pressure, cell, volume);
+        largest = std::max(largest, std::abs(result[cell]));
+      }
+      rowSums[size_t(layer) * height + row] = largest;
+    });
+  });
+  return *std::max_element(rowSums.begin(), rowSums.end());
+}
+
+double PoissonGrid::norm(const std::vector<double> &field, utils::ThreadPool &pool) const {
+  forEachRow(pool, [&](size_t cell, int row, int layer) {
+    double largest = 0;
+    for (int column = 0; column < width; ++column, ++cell)
+      largest = std::max(largest, std::abs(field[cell]));
+    rowSums[size_t(layer) * height + row] = largest;
+  });
+  return *std::max_element(rowSums.begin(), rowSums.end());
+}
+
+double PoissonGrid::dot(const std::vector<double> &a, const std::vector<double> &b, utils::ThreadPool &pool) const {
+  forEachRow(pool, [&](size_t cell, int row, int layer) {
+    double sum = 0;
+    for (int column = 0; column < width; ++column, ++cell)
+      sum += a[cell] * b[cell];
+    rowSums[size_t(layer) * height + row] = sum;
+  });
+  return sumRows();
+}
+
+void PoissonGrid::removeMean(std::vector<double> &field, utils::ThreadPool &pool) const {
+  forEachRow(pool, [&](size_t cell, int row, int layer) {
+    double sum = 0;
+    for (int column = 0; column < width; ++column, ++cell)
+      sum += field[cell];
+    rowSums[size_t(layer) * height + row] = sum;
+  });
+
+  double mean = sumRows() / (double(width) * height * depth);
+  forEachRow(pool, [&](size_t cell, int, int) {
+    for (int column = 0; column < width; ++column, ++cell)
+      field[cell] -= mean;
+  });
+}
+
+void PoissonGrid::clearGhosts(std::vector<double> &field) const {
+  std::fill(field.begin(), field.begin() + ghostLayers * layerStride, 0);
+  std::fill(field.end() - ghostLayers * layerStride, field.end(), 0);
+  for (int layer = 0; layer < depth; ++layer) {
+    auto first = field.begin() + (layer + ghostLayers) * layerStride;
+    std::fill(first, first + stride, 0);
+    std::fill(first + layerStride - stride, first + layerStride, 0);
+    for (int row = 0; row < height; ++row) {
+      field[index(row, -1, layer)] = 0;
+      field[index(row, width, layer)] = 0;
+    }
+  }
+}
+
+void PoissonGrid::relax(std::vector<double> &pressure, const std::vector<double> &rhs, utils::ThreadPool &pool, double weight) const {
+  dispatch([&](auto volume) {
+    for (int color = 0; color < 2; ++color)
+      forEachRow(pool, [&](size_t cell, int row, int layer) {
+        int first = (row + layer + color) % 2;
+        cell += first;
+        for (int column = first; column < width; column += 2, cell += 2) {
+          double target = (sumNeighbours(pressure, cell, volume) - rhs[cell]) * inverseNeighbours[cell];
+          pressure[cell] += weight * (target - pressure[cell]);
+        }
+      });
+  });
+}
+
+double PoissonGrid::sumRows() const {
+  double sum = 0;
+  for (double rowSum : rowSums)
+    sum += rowSum;
+  return sum;
+}
+
+// end of PoissonGrid.cxx
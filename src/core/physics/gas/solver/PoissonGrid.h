@@ -0,0 +1,131 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : PoissonGrid.h
+ * PURPOSE   : Poisson equation on a padded grid of gas cells
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "../../../../utils/thread_pool/ThreadPool.h"
+
+namespace unreal_fluid::physics::gas {
+  /// @brief Discrete Poisson equation on a box of cells closed by walls.
+  /// @details Fields are laid out as gas fields are: row-major layers with one ring of ghost cells, and one
+  /// ghost layer below and above the box, so a cell reads its six neighbours without bounds checks.
+  /// A flat grid has depth 1 and no ghost layers, it is laid out as GasContainer2d fields, and kernels
+  /// skip layer neighbours for it at compile time, see dispatch().
+  /// The equation of a cell is
+  ///     sum over neighbours j inside the box of (p_j - p_i) = rhs_i,
+  /// walls add nothing. Ghost cells of the solution must stay zero, then every stencil is
+  /// the sum of neighbours minus neighbours_i * p_i with no branches at the border.
+  ///
+  /// The solution is defined up to a constant and exists only if rhs sums to zero, which holds
+  /// for divergence of velocities with no flow through the walls.
+  ///
+  /// Kernels split rows between threads of a pool. Sums are taken per row and added in the order of rows,
+  /// so results do not depend on the amount of threads.
+  class PoissonGrid {
+  private:
+    int width;
+    int height;
+    int depth;
+    size_t stride;                         // row with ghost cells
+    size_t layerStride;                    // layer with ghost rows
+    int ghostLayers;                       // below and above the box, none for flat grids
+    std::vector<double> neighbours;        // amount of neighbours inside the box, zero in ghost cells
+    std::vector<double> inverseNeighbours; // 1 / neighbours, zero in ghost cells
+    mutable std::vector<double> rowSums;
+
+  public:
+    PoissonGrid(int width, int height, int depth = 1);
+
+    [[nodiscard]] int getWidth() const { return width; }
+    [[nodiscard]] int getHeight() const { return height; }
+    [[nodiscard]] int getDepth() const { return depth; }
+    [[nodiscard]] size_t getStride() const { return stride; }
+    [[nodiscard]] size_t getLayerStride() const { return layerStride; }
+
+    /// @brief returns size of fields, including ghost cells
+    [[nodiscard]] size_t size() const { return layerStride * (depth + 2 * ghostLayers); }
+
+    /// @brief returns index of cell in fields, rows, columns and layers start from 0 without ghost cells
+    [[nodiscard]] size_t index(int row, int column, int layer = 0) const {
+      return (layer + ghostLayers) * layerStride + (row + 1) * stride + column + 1;
+    }
+
+    [[nodiscard]] double getNeighbours(size_t cell) const { return neighbours[cell]; }
+    [[nodiscard]] double getInverseNeighbours(size_t cell) const { return inverseNeighbours[cell]; }
+
+    /// @brief calls body(std::true_type) for volumes and body(std::false_type) for flat grids,
+    /// so kernels drop reads of ghost layers of flat grids at compile time
+    template<typename Body>
+    void dispatch(Body &&body) const {
+      if (depth > 1)
+        body(std::true_type{});
+      else
+        body(std::false_type{});
+    }
+
+    /// @brief returns sum of neighbours of a cell, ghost cells included
+    /// @param volume std::true_type to add neighbours in the next and the previous layers
+    template<bool volume>
+    [[nodiscard]] double sumNeighbours(const std::vector<double> &field, size_t cell, std::bool_constant<volume>) const {
+      double sum = field[cell - 1] + field[cell + 1] + field[cell - stride] + field[cell + stride];
+      if constexpr (volume) sum += field[cell - layerStride] + field[cell + layerStride];
+      return sum;
+    }
+
+    /// @brief calls body(first cell of the row, row, layer) for every row of every layer, rows are split between threads
+    template<typename Body>
+    void forEachRow(utils::ThreadPool &pool, Body &&body) const {
+      pool.parallelFor(size_t(height) * depth, [&](size_t begin, size_t end, unsigned) {
+        for (size_t line = begin; line < end; ++line) {
+          int layer = int(line / height), row = int(line % height);
+          body(index(row, 0, layer), row, layer);
+        }
+      });
+    }
+
+    /// @brief result = neighbours * x - sum of neighbours of x, the positive semi-definite form of the equation
+    void multiply(const std::vector<double> &x, std::vector<double> &result, utils::ThreadPool &pool) const;
+
+    /// @brief fills result with rhs minus the left side of the equation at pressure
+    /// @return largest absolute value of the residual
+    double residual(const std::vector<double> &pressure, const std::vector<double> &rhs, std::vector<double> &result,
+                    utils::ThreadPool &pool) const;
+
+    /// @brief returns largest absolute value of a field over cells of the grid
+    [[nodiscard]] double norm(const std::vector<double> &field, utils::ThreadPool &pool) const;
+
+    /// @brief returns sum of products of two fields over cells of the grid
+    [[nodiscard]] double dot(const std::vector<double> &a, const std::vector<double> &b, utils::ThreadPool &pool) const;
+
+    /// @brief subtracts the mean value from cells of the grid
+    void removeMean(std::vector<double> &field, utils::ThreadPool &pool) const;
+
+    /// @brief sets ghost cells of a field to zero
+    void clearGhosts(std::vector<double> &field) const;
+
+    /// @brief one red-black Gauss-Seidel sweep, cells of one colour depend only on the other colour
+    /// @param weight over-relaxation, 1 for plain Gauss-Seidel
+    void relax(std::vector<double> &pressure, const std::vector<double> &rhs, utils::ThreadPool &pool, double weight = 1) const;
+
+  private:
+    /// @brief returns sum of rowSums in the order of rows
+    [[nodiscard]] double sumRows() const;
+  };
+} // namespace unreal_fluid::physics::gas
+
+// end of PoissonGrid.h
@@ -0,0 +1,35 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : RedBlackGaussSeidelSolver.cxx
+ * PURPOSE   : red-black Gauss-Seidel solver of the pressure equation
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "RedBlackGaussSeidelSolver.h"
+
+using namespace unreal_fluid::physics::gas;
+
+RedBlackGaussSeidelSolver::RedBlackGaussSeidelSolver(PoissonSolverParameters parameters, double overRelaxation) : IPoissonSolver(parameters),
+                                                                                                                  overRelaxation(overRelaxation) {}
+
+int RedBlackGaussSeidelSolver::iterate(const PoissonGrid &grid, std::vector<double> &pressure, const std::vector<double> &rhs,
+                                       double target, double &residual, utils::ThreadPool &pool) {
+  for (int iteration = 1; iteration <= parameters.maxIterations; ++iteration) {
+    grid.relax(pressure, rhs, pool, overRelaxation);
+
+    if (iteration % residualInterval == 0 || iteration == parameters.maxIterations) {
+      residual = grid.residual(pressure, rhs, residualField, pool);
+      if (residual <= target) return iteration;
+    }
+  }
+  return parameters.maxIterations;
+}
+
+// end of RedBlackGaussSeidelSolver.cxx
@@ -0,0 +1,42 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : RedBlackGaussSeidelSolver.h
+ * PURPOSE   : red-black Gauss-Seidel solver of the pressure equation
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include "IPoissonSolver.h"
+
+namespace unreal_fluid::physics::gas {
+  /// @brief Red-black Gauss-Seidel iterations with optional over-relaxation.
+  /// @details Cells are coloured as a chessboard and a sweep updates red cells from black ones and then
+  /// black cells from red ones, so cells of one colour are independent of each other. Converges about
+  /// twice as fast as Jacobi, over-relaxation close to 2 speeds it up much more on large grids.
+  class RedBlackGaussSeidelSolver : public IPoissonSolver {
+  private:
+    double overRelaxation;
+    std::vector<double> residualField;
+
+    static constexpr int residualInterval = 4; // sweeps between residual checks
+
+  public:
+    explicit RedBlackGaussSeidelSolver(PoissonSolverParameters parameters = {}, double overRelaxation = 1);
+
+    [[nodiscard]] std::string getName() const override { return "red-black Gauss-Seidel"; }
+
+  protected:
+    int iterate(const PoissonGrid &grid, std::vector<double> &pressure, const std::vector<double> &rhs,
+                double target, double &residual, utils::ThreadPool &pool) override;
+  };
+} // namespace unreal_fluid::physics::gas
+
+// end of RedBlackGaussSeidelSolver.h
@@ -0,0 +1,50 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : RigidBody.cxx
+ * PURPOSE   : rigid sphere or box simulated by RigidBodyWorld
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "RigidBody.h"
+
+#include <cmath>
+
+using namespace unreal_fluid::physics::rigid;
+
+RigidBody::RigidBody(vec3 position, double radius, double mass) : PhysicsBody(position, mass),
+                                                                  shape(Shape::SPHERE),
+                                                                  radius(radius) {
+  double inertia = 0.4 * mass * radius * radius;
+  setInertiaTensor(mat3::diagonal({inertia, inertia, inertia}));
+}
+
+RigidBody::RigidBody(vec3 position, vec3 halfExtents, double mass) : PhysicsBody(position, mass),
+                                                                     shape(Shape::BOX),
+                                                                     halfExtents(halfExtents),
+                                                                     radius(std::sqrt(halfExtents.len2())) {
+  vec3 squares(halfExtents.x * halfExtents.x, halfExtents.y * halfExtents.y, halfExtents.z * halfExtents.z);
+  setInertiaTensor(mat3::diagonal(vec3(squares.y + squares.z, squares.x + squares.z, squares.x + squares.y) * (mass / 3)));
+}
+
+unreal_fluid::physics::solid::Aabb RigidBody::getBounds() const {
+  vec3 extent = vec3(radius, radius, radius);
+  if (shape == Shape::BOX) {
+    /* extent of a rotated box along an axis is the sum of its half sizes projected on the axis */
+    for (int axis = 0; axis < 3; ++axis) {
+      double value = 0;
+      for (int side = 0; side < 3; ++side)
+        value += std::abs(orientation(axis, side)) * (side == 0 ? halfExtents.x : side == 1 ? halfExtents.y : halfExtents.z);
+      (axis == 0 ? extent.x : axis == 1 ? extent.y : extent.z) = value;
+    }
+  }
+  return {position - extent, position + extent};
+}
+
+// end of RigidBody.cxx
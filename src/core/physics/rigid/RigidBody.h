@@ -0,0 +1,77 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : RigidBody.h
+ * PURPOSE   : rigid sphere or box simulated by RigidBodyWorld
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include "../../../../addons/flag_addon/physics_body/PhysicsBody.h"
+#include "../solid/Aabb.h"
+
+namespace unreal_fluid::physics::rigid {
+  /// @brief Sphere or box with mass, inertia tensor and contact material.
+  /// @details State and integration come from the PhysicsBody addon, this class adds a shape,
+  /// inertia of the shape and sleeping. Mass -1 makes the body static.
+  class RigidBody : public addons::physics::PhysicsBody {
+  public:
+    enum class Shape {
+      SPHERE,
+      BOX,
+    };
+
+    /// @brief impulses given to the body from outside during a step
+    struct Impulse {
+      vec3 linear;
+      vec3 angular;     // around the centre
+      double mass = 0;  // summed mass of particles which gave them
+    };
+
+    Shape shape;
+    vec3 halfExtents{}; // half sizes of a box along its axes
+    double radius;      // radius of a sphere, radius of the bounding sphere of a box
+
+    double friction = 0.5;
+    double rollingFriction = 0.005; // arm of the torque resisting rolling and spinning on a contact
+    double restitution = 0.2;
+
+    bool asleep = false;
+    double sleepTime = 0; // how long the body has been slow enough to sleep
+
+    /// @brief creates sphere
+    /// @param mass mass of the body, -1 for a static body
+    RigidBody(vec3 position, double radius, double mass);
+
+    /// @brief creates box
+    /// @param mass mass of the body, -1 for a static body
+    RigidBody(vec3 position, vec3 halfExtents, double mass);
+
+    /// @brief returns box around the body in world space
+    [[nodiscard]] solid::Aabb getBounds() const;
+
+    /// @brief returns point given in body space in world space
+    [[nodiscard]] vec3 toWorld(const vec3 &local) const { return position + orientation * local; }
+
+    /// @brief returns point given in world space in body space
+    [[nodiscard]] vec3 toLocal(const vec3 &point) const { return orientation.transposed() * (point - position); }
+
+    /// @brief returns velocity of the body point at the given world position
+    [[nodiscard]] vec3 getPointVelocity(const vec3 &point) const { return velocity + angularVelocity.cross(point - position); }
+
+    /// @brief wakes the body, call it after changing state of a sleeping body
+    void wake() {
+      asleep = false;
+      sleepTime = 0;
+    }
+  };
+} // namespace unreal_fluid::physics::rigid
+
+// end of RigidBody.h
@@ -0,0 +1,545 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : RigidBodyWorld.cxx
+ * PURPOSE   : rigid bodies with contacts solved by sequential impulses
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "RigidBodyWorld.h"
+#include "../CollisionSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace unreal_fluid::physics::rigid;
+
+namespace {
+  /// @brief orders contacts by their bodies and feature
+  template<typename Contact>
+  bool precedes(const Contact &first, const Contact &second) {
+    if (first.a != second.a) return first.a < second.a;
+    if (first.b != second.b) return first.b < second.b;
+    return first.feature < second.feature;
+  }
+
+  /// @brief returns component of vector by axis index
+  double component(const vec3 &v, int axis) {
+    return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+  }
+
+  /// @brief returns unit vector along axis with given sign
+  vec3 axisVector(int axis, double sign) {
+    return vec3(axis == 0 ? sign : 0, axis == 1 ? sign : 0, axis == 2 ? sign : 0);
+  }
+} // namespace
+
+RigidBodyWorld::RigidBodyWorld(RigidParameters parameters) : parameters(parameters) {}
+
+unreal_fluid::physics::IPhysicalObject::Type RigidBodyWorld::getType() {
+  return Type::RIGID_BODY_WORLD;
+}
+
+size_t RigidBodyWorld::addBody(const RigidBody &body) {
+  bodies.push_back(body);
+  impulses.emplace_back();
+  return bodies.size() - 1;
+}
+
+void RigidBodyWorld::setThreadsCount(unsigned threadsCount) {
+  threadPool.setThreadsCount(threadsCount);
+}
+
+size_t RigidBodyWorld::collideParticles(size_t body, fluid::ParticleStorage &particles, const uint32_t *indices, size_t count, double k) {
+  if (count < minParallelParticles)
+    return CollisionSolver::particlesWithRigidBodyCollision(particles, indices, count, bodies[body], k, impulses[body]);
+
+  threadImpulses.assign(threadPool.getThreadsCount(), RigidBody::Impulse{});
+  threadContacts.assign(threadPool.getThreadsCount(), 0);
+  threadPool.parallelFor(count, [&](size_t begin, size_t end, unsigned thread) {
+    threadContacts[thread] = CollisionSolver::particlesWithRigidBodyCollision(particles, indices + begin, end - begin, bodies[body], k,
+                                                                        threadImpulses[thread]);
+  });
+
+  size_t touched = 0;
+  for (unsigned thread = 0; thread < threadImpulses.size(); ++thread) {
+    impulses[body].linear += threadImpulses[thread].linear;
+    impulses[body].angular += threadImpulses[thread].angular;
+    impulses[body].mass += threadImpulses[thread].mass;
+    touched += threadContacts[thread];
+  }
+  return touched;
+}
+
+void RigidBodyWorld::applyImpulses() {
+  double limit2 = parameters.sleepSpeed * parameters.sleepSpeed;
+
+  for (uint32_t index = 0; index < bodies.size(); ++index) {
+    RigidBody &body = bodies[index];
+    RigidBody::Impulse impulse = impulses[index];
+    impulses[index] = {};
+    if (body.isStatic || impulse.mass == 0) continue;
+
+    /* the particles and the body share the velocity change as one lump would */
+    double share = body.mass / (body.mass + impulse.mass);
+    vec3 velocityChange = impulse.linear * (body.inverseMass * share);
+    vec3 angularVelocityChange = body.getWorldInverseInertia() * impulse.angular * share;
+    if (body.asleep) {
+      if (velocityChange.len2() < limit2 && angularVelocityChange.len2() < limit2) continue;
+      body.wake();
+    }
+
+    body.velocity += velocityChange;
+    body.angularVelocity += angularVelocityChange;
+  }
+}
+
+void RigidBodyWorld::simulate(double dt) {
+  statistics = {};
+  applyImpulses();
+
+  bool anyAwake = false;
+  for (uint32_t body = 0; body < bodies.size(); ++body)
+    anyAwake |= isAwake(body);
+  if (!anyAwake || dt <= 0) return;
+
+  /* velocities of the last step tell which bodies are fast enough to wake others */
+  findPairs();
+  if (wakeTouched()) findPairs();
+
+  for (auto &body: bodies) {
+    if (body.isStatic || body.asleep) continue;
+    body.velocity += G * dt;
+    body.integrateVelocity(dt);
+  }
+
+  /* sleeping bodies hold awake ones like static bodies do */
+  inverseMasses.resize(bodies.size());
+  inverseInertias.resize(bodies.size());
+  for (uint32_t body = 0; body < bodies.size(); ++body) {
+    inverseMasses[body] = isAwake(body) ? bodies[body].inverseMass : 0;
+    inverseInertias[body] = isAwake(body) ? bodies[body].getWorldInverseInertia() : mat3::zero();
+  }
+
+  findContacts();
+  buildIslands();
+  prepareContacts(dt);
+
+  size_t islandsCount = islandStarts.size() - 1;
+  threadPool.parallelFor(islandsCount, [&](size_t begin, size_t end, unsigned) {
+    for (size_t island = begin; island < end; ++island)
+      solveIsland(island);
+  });
+
+  storeContacts();
+
+  for (uint32_t body: islandBodies)
+    bodies[body].integratePosition(dt);
+
+  updateSleeping(dt);
+
+  statistics.contacts = contacts.size();
+  statistics.islands = islandsCount;
+  for (uint32_t body = 0; body < bodies.size(); ++body)
+    statistics.awakeBodies += isAwake(body);
+}
+
+void RigidBodyWorld::findPairs() {
+  bounds.resize(bodies.size());
+  for (size_t body = 0; body < bodies.size(); ++body)
+    bounds[body] = bodies[body].getBounds();
+
+  order.resize(bodies.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return bounds[a].min.x < bounds[b].min.x; });
+
+  pairs.clear();
+  for (size_t i = 0; i < order.size(); ++i) {
+    uint32_t a = order[i];
+    for (size_t j = i + 1; j < order.size() && bounds[order[j]].min.x <= bounds[a].max.x; ++j) {
+      uint32_t b = order[j];
+      if ((isAwake(a) || isAwake(b)) && bounds[a].overlaps(bounds[b])) pairs.emplace_back(a, b);
+    }
+  }
+}
+
+bool RigidBodyWorld::wakeTouched() {
+  double limit2 = parameters.sleepSpeed * parameters.sleepSpeed;
+  auto isFast = [&](uint32_t body) {
+    return isAwake(body) && (bodies[body].velocity.len2() >= limit2 || bodies[body].angularVelocity.len2() >= limit2);
+  };
+
+  bool woken = false;
+  for (auto [a, b]: pairs) {
+    uint32_t sleeping = bodies[a].asleep ? a : b, other = sleeping == a ? b : a;
+    if (!bodies[sleeping].asleep || !isFast(other)) continue;
+
+    bodies[sleeping].wake();
+    woken = true;
+  }
+  return woken;
+}
+
+void RigidBodyWorld::findContacts() {
+  contacts.clear();
+
+  for (auto [a, b]: pairs)
+    collide(a, b);
+
+  if (walls.empty()) return;
+  for (uint32_t body = 0; body < bodies.size(); ++body)
+    if (isAwake(body)) collideWithWalls(body);
+}
+
+void RigidBodyWorld::collide(uint32_t a, uint32_t b) {
+  const RigidBody &first = bodies[a], &second = bodies[b];
+
+  if (first.shape == RigidBody::Shape::SPHERE && second.shape == RigidBody::Shape::SPHERE) {
+    vec3 diff = first.position - second.position;
+    double reach = first.radius + second.radius;
+
+    double distance2 = diff.len2();
+    if (distance2 >= (reach + parameters.margin) * (reach + parameters.margin)) return;
+
+    double distance = std::sqrt(distance2);
+    vec3 normal = distance > 0 ? diff / distance : vec3(0, 1, 0);
+    double depth = reach - distance;
+    addContact(a, b, 0, second.position + normal * (second.radius - depth / 2), normal, depth);
+  } else if (first.shape == RigidBody::Shape::SPHERE) {
+    collideSphereWithBox(a, b);
+  } else if (second.shape == RigidBody::Shape::SPHERE) {
+    collideSphereWithBox(b, a);
+  } else {
+    collideCorners(a, b);
+    collideCorners(b, a);
+  }
+}
+
+void RigidBodyWorld::collideSphereWithBox(uint32_t sphere, uint32_t box) {
+  const RigidBody &ball = bodies[sphere], &cuboid = bodies[box];
+  const vec3 &h = cuboid.halfExtents;
+
+  vec3 local = cuboid.toLocal(ball.position);
+  vec3 closest(std::clamp(local.x, -h.x, h.x), std::clamp(local.y, -h.y, h.y), std::clamp(local.z, -h.z, h.z));
+  vec3 diff = local - closest;
+
+  double distance2 = diff.len2();
+  if (distance2 > (ball.radius + parameters.margin) * (ball.radius + parameters.margin)) return;
+
+  vec3 normal;
+  double depth;
+  if (distance2 > 0) {
+    double distance = std::sqrt(distance2);
+    normal = diff / distance;
+    depth = ball.radius - distance;
+  } else {
+    /* centre inside the box leaves through the closest face */
+    int axis = 0;
+    for (int i = 1; i < 3; ++i)
+      if (component(h, i) - std::abs(component(local, i)) < component(h, axis) - std::abs(component(local, axis))) axis = i;
+
+    double sign = component(local, axis) < 0 ? -1 : 1;
+    normal = axisVector(axis, sign);
+    depth = ball.radius + component(h, axis) - std::abs(component(local, axis));
+    closest = local + normal * (component(h, axis) - std::abs(component(local, axis)));
+  }
+
+  addContact(sphere, box, 0, cuboid.toWorld(closest), cuboid.orientation * normal, depth);
+}
+
+void RigidBodyWorld::collideCorners(uint32_t a, uint32_t b) {
+  const RigidBody &corners = bodies[a], &box = bodies[b];
+  const vec3 &h = box.halfExtents;
+
+  for (int corner = 0; corner < 8; ++corner) {
+    vec3 offset((corner & 1 ? 1 : -1) * corners.halfExtents.x,
+                (corner & 2 ? 1 : -1) * corners.halfExtents.y,
+                (corner & 4 ? 1 : -1) * corners.halfExtents.z);
+    vec3 point = corners.toWorld(offset);
+    vec3 local = box.toLocal(point);
+
+    int axis = -1;
+    double depth = 0;
+    for (int i = 0; i < 3; ++i) {
+      double penetration = component(h, i) - std::abs(component(local, i));
+      if (penetration < -parameters.margin) {
+        axis = -1;
+        break;
+      }
+      if (axis < 0 || penetration < depth) axis = i, depth = penetration;
+    }
+    if (axis < 0) continue;
+
+    vec3 normal = box.orientation * axisVector(axis, component(local, axis) < 0 ? -1 : 1);
+    addContact(a, b, uint32_t(corner), point, normal, depth);
+  }
+}
+
+void RigidBodyWorld::collideWithWalls(uint32_t a) {
+  const RigidBody &body = bodies[a];
+
+  if (body.shape == RigidBody::Shape::SPHERE) {
+    collideWithWalls(a, body.position, body.radius, 0);
+    return;
+  }
+
+  for (int corner = 0; corner < 8; ++corner) {
+    vec3 point = body.toWorld(vec3((corner & 1 ? 1 : -1) * body.halfExtents.x,
+                                   (corner & 2 ? 1 : -1) * body.halfExtents.y,
+                                   (corner & 4 ? 1 : -1) * body.halfExtents.z));
+    collideWithWalls(a, point, 0, uint32_t(corner));
+  }
+}
+
+void RigidBodyWorld::collideWithWalls(uint32_t a, const vec3 &point, double radius, uint32_t feature) {
+  double reach = radius + parameters.margin;
+
+  /* a wall reports only its face closest to the point, so in a corner of a container the point
+   * is moved out of reach of the faces found and the walls are asked again */
+  vec3 probe = point;
+  for (int pass = 0; pass < 3; ++pass) {
+    vec3 shift(0, 0, 0);
+    walls.forEachShapeNear(probe, reach, [&](size_t shape, double distance, const vec3 &normal) {
+      double length2 = normal.len2();
+      if (length2 == 0) return;
+      vec3 n = normal / std::sqrt(length2);
+
+      /* the side the face looks to keeps the contact the same between steps */
+      int axis = 0;
+      for (int i = 1; i < 3; ++i)
+        if (std::abs(component(n, i)) > std::abs(component(n, axis))) axis = i;
+      uint32_t side = uint32_t(axis * 2 + (component(n, axis) < 0 ? 1 : 0));
+
+      distance -= (probe - point).dot(n);
+      addContact(a, noBody, (uint32_t(shape) * 8 + feature) * 6 + side, point - n * distance, n, radius - distance);
+      shift += n * (reach - distance - (probe - point).dot(n) + parameters.margin * 1e-3);
+    });
+
+    if (shift.len2() == 0) return;
+    probe += shift;
+  }
+}
+
+void RigidBodyWorld::addContact(uint32_t a, uint32_t b, uint32_t feature, const vec3 &point, const vec3 &normal, double depth) {
+  double length2 = normal.len2();
+  if (length2 == 0) return;
+
+  Contact contact{};
+  contact.a = a;
+  contact.b = b;
+  contact.feature = feature;
+  contact.point = point;
+  contact.normal = normal / std::sqrt(length2);
+  contact.depth = depth;
+  contacts.push_back(contact);
+}
+
+uint32_t RigidBodyWorld::findRoot(uint32_t body) {
+  while (parents[body] != body) {
+    parents[body] = parents[parents[body]];
+    body = parents[body];
+  }
+  return body;
+}
+
+void RigidBodyWorld::buildIslands() {
+  parents.resize(bodies.size());
+  std::iota(parents.begin(), parents.end(), 0);
+
+  for (const Contact &contact: contacts)
+    if (contact.b != noBody && isAwake(contact.a) && isAwake(contact.b))
+      parents[findRoot(contact.a)] = findRoot(contact.b);
+
+  /* islands are numbered in order of their first bodies */
+  islandOf.assign(bodies.size(), noBody);
+  islandStarts.assign(1, 0);
+  for (uint32_t body = 0; body < bodies.size(); ++body) {
+    if (!isAwake(body)) continue;
+
+    uint32_t root = findRoot(body);
+    if (islandOf[root] == noBody) {
+      islandOf[root] = uint32_t(islandStarts.size() - 1);
+      islandStarts.push_back(0);
+    }
+    ++islandStarts[islandOf[root] + 1];
+  }
+
+  size_t islandsCount = islandStarts.size() - 1;
+  contactStarts.assign(islandsCount + 1, 0);
+  auto islandOfContact = [&](const Contact &contact) {
+    return islandOf[findRoot(isAwake(contact.a) ? contact.a : contact.b)];
+  };
+  for (const Contact &contact: contacts)
+    ++contactStarts[islandOfContact(contact) + 1];
+
+  for (size_t island = 0; island < islandsCount; ++island) {
+    islandStarts[island + 1] += islandStarts[island];
+    contactStarts[island + 1] += contactStarts[island];
+  }
+
+  islandBodies.resize(islandStarts.back());
+  islandContacts.resize(contactStarts.back());
+  std::vector<uint32_t> filled(islandStarts.begin(), islandStarts.end() - 1);
+  for (uint32_t body = 0; body < bodies.size(); ++body)
+    if (isAwake(body)) islandBodies[filled[islandOf[findRoot(body)]]++] = body;
+
+  filled.assign(contactStarts.begin(), contactStarts.end() - 1);
+  for (uint32_t contact = 0; contact < contacts.size(); ++contact)
+    islandContacts[filled[islandOfContact(contacts[contact])]++] = contact;
+}
+
+void RigidBodyWorld::prepareContacts(double dt) {
+  for (Contact &contact: contacts) {
+    const RigidBody &first = bodies[contact.a];
+    const RigidBody *second = contact.b == noBody ? nullptr : &bodies[contact.b];
+    const vec3 &n = contact.normal;
+
+    contact.ra = contact.point - first.position;
+    contact.rb = second ? contact.point - second->position : vec3(0, 0, 0);
+
+    contact.tangents[0] = std::abs(n.x) > 0.57 ? vec3(n.y, -n.x, 0) : vec3(0, n.z, -n.y);
+    contact.tangents[0] /= std::sqrt(contact.tangents[0].len2());
+    contact.tangents[1] = n.cross(contact.tangents[0]);
+
+    /* inverse of mass the contact feels along a direction */
+    auto inverseMass = [&](const vec3 &direction) {
+      double result = inverseMasses[contact.a] + direction.dot((inverseInertias[contact.a] * contact.ra.cross(direction)).cross(contact.ra));
+      if (second)
+        result += inverseMasses[contact.b] + direction.dot((inverseInertias[contact.b] * contact.rb.cross(direction)).cross(contact.rb));
+      return result;
+    };
+
+    contact.normalMass = 1 / inverseMass(n);
+    contact.rollingMass = (second ? inverseInertias[contact.a] + inverseInertias[contact.b] : inverseInertias[contact.a]).inversed();
+    for (int i = 0; i < 2; ++i)
+      contact.tangentMass[i] = 1 / inverseMass(contact.tangents[i]);
+
+    vec3 relativeVelocity = first.getPointVelocity(contact.point) - (second ? second->getPointVelocity(contact.point) : vec3(0, 0, 0));
+    double normalSpeed = relativeVelocity.dot(n);
+    double restitution = second ? std::max(first.restitution, second->restitution) : first.restitution;
+
+    /* a contact not touching yet lets the bodies close the gap in this step, but not more */
+    contact.bias = contact.depth < 0 ? contact.depth / dt : parameters.baumgarte / dt * std::max(contact.depth - parameters.slop, 0.0);
+    if (normalSpeed < -parameters.bounceSpeed)
+      contact.bias = std::max(contact.bias, -restitution * normalSpeed);
+  }
+
+  /* the same contact in the last step gives the starting impulses */
+  for (Contact &contact: contacts) {
+    const RigidBody *second = contact.b == noBody ? nullptr : &bodies[contact.b];
+    const vec3 &n = contact.normal;
+
+    auto previous = std::lower_bound(previousContacts.begin(), previousContacts.end(), contact, precedes<Contact>);
+    if (previous == previousContacts.end() || precedes(contact, *previous) || previous->normal.dot(n) < 0.95) continue;
+
+    contact.normalImpulse = previous->normalImpulse;
+    contact.tangentImpulse[0] = previous->tangentImpulse[0];
+    contact.tangentImpulse[1] = previous->tangentImpulse[1];
+    contact.rollingImpulse = previous->rollingImpulse;
+
+    vec3 impulse = n * contact.normalImpulse + contact.tangents[0] * contact.tangentImpulse[0] + contact.tangents[1] * contact.tangentImpulse[1];
+    if (isAwake(contact.a)) {
+      bodies[contact.a].velocity += impulse * inverseMasses[contact.a];
+      bodies[contact.a].angularVelocity += inverseInertias[contact.a] * (contact.ra.cross(impulse) + contact.rollingImpulse);
+    }
+    if (second && isAwake(contact.b)) {
+      bodies[contact.b].velocity -= impulse * inverseMasses[contact.b];
+      bodies[contact.b].angularVelocity -= inverseInertias[contact.b] * (contact.rb.cross(impulse) + contact.rollingImpulse);
+    }
+  }
+}
+
+void RigidBodyWorld::storeContacts() {
+  previousContacts = contacts;
+  std::sort(previousContacts.begin(), previousContacts.end(), precedes<Contact>);
+}
+
+void RigidBodyWorld::solveIsland(size_t island) {
+  for (int iteration = 0; iteration < parameters.iterations; ++iteration) {
+    for (uint32_t i = contactStarts[island]; i < contactStarts[island + 1]; ++i) {
+      Contact &contact = contacts[islandContacts[i]];
+      RigidBody &first = bodies[contact.a];
+      RigidBody *second = contact.b == noBody ? nullptr : &bodies[contact.b];
+
+      /* static and sleeping bodies are shared by islands and must not be written */
+      bool firstAwake = isAwake(contact.a), secondAwake = second && isAwake(contact.b);
+      auto apply = [&](const vec3 &impulse) {
+        if (firstAwake) {
+          first.velocity += impulse * inverseMasses[contact.a];
+          first.angularVelocity += inverseInertias[contact.a] * contact.ra.cross(impulse);
+        }
+        if (secondAwake) {
+          second->velocity -= impulse * inverseMasses[contact.b];
+          second->angularVelocity -= inverseInertias[contact.b] * contact.rb.cross(impulse);
+        }
+      };
+      auto relativeVelocity = [&]() {
+        vec3 result = first.velocity + first.angularVelocity.cross(contact.ra);
+        if (second) result -= second->velocity + second->angularVelocity.cross(contact.rb);
+        return result;
+      };
+
+      /* friction is bounded by the normal impulse of the previous iteration */
+      double friction = second ? std::sqrt(first.friction * second->friction) : first.friction;
+      for (int t = 0; t < 2; ++t) {
+        double lambda = -relativeVelocity().dot(contact.tangents[t]) * contact.tangentMass[t];
+        double limit = friction * contact.normalImpulse;
+        double accumulated = std::clamp(contact.tangentImpulse[t] + lambda, -limit, limit);
+        lambda = accumulated - contact.tangentImpulse[t];
+        contact.tangentImpulse[t] = accumulated;
+        apply(contact.tangents[t] * lambda);
+      }
+
+      double lambda = (contact.bias - relativeVelocity().dot(contact.normal)) * contact.normalMass;
+      double accumulated = std::max(contact.normalImpulse + lambda, 0.0);
+      lambda = accumulated - contact.normalImpulse;
+      contact.normalImpulse = accumulated;
+      apply(contact.normal * lambda);
+
+      /* rolling resistance is an angular impulse, bounded the same way as friction */
+      double rollingFriction = second ? std::max(first.rollingFriction, second->rollingFriction) : first.rollingFriction;
+      vec3 relativeSpin = first.angularVelocity - (second ? second->angularVelocity : vec3(0, 0, 0));
+      vec3 rolling = contact.rollingImpulse - contact.rollingMass * relativeSpin;
+      double limit = rollingFriction * contact.normalImpulse;
+      if (rolling.len2() > limit * limit) rolling *= limit / std::sqrt(rolling.len2());
+
+      vec3 angularImpulse = rolling - contact.rollingImpulse;
+      contact.rollingImpulse = rolling;
+      if (firstAwake) first.angularVelocity += inverseInertias[contact.a] * angularImpulse;
+      if (secondAwake) second->angularVelocity -= inverseInertias[contact.b] * angularImpulse;
+    }
+  }
+}
+
+void RigidBodyWorld::updateSleeping(double dt) {
+  double limit2 = parameters.sleepSpeed * parameters.sleepSpeed;
+
+  for (size_t island = 0; island + 1 < islandStarts.size(); ++island) {
+    double islandSleepTime = parameters.sleepDelay;
+
+    for (uint32_t i = islandStarts[island]; i < islandStarts[island + 1]; ++i) {
+      RigidBody &body = bodies[islandBodies[i]];
+      bool slow = body.velocity.len2() < limit2 && body.angularVelocity.len2() < limit2;
+      body.sleepTime = slow ? body.sleepTime + dt : 0;
+      islandSleepTime = std::min(islandSleepTime, body.sleepTime);
+    }
+
+    if (islandSleepTime < parameters.sleepDelay) continue;
+
+    for (uint32_t i = islandStarts[island]; i < islandStarts[island + 1]; ++i) {
+      RigidBody &body = bodies[islandBodies[i]];
+      body.asleep = true;
+      body.velocity = {0, 0, 0};
+      body.angularVelocity = {0, 0, 0};
+    }
+  }
+}
+
+// end of RigidBodyWorld.cxx
@@ -0,0 +1,204 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : RigidBodyWorld.h
+ * PURPOSE   : rigid bodies with contacts solved by sequential impulses
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../../../utils/thread_pool/ThreadPool.h"
+#include "../IPhysicalObject.h"
+#include "../PhysicsDefinitions.h"
+#include "../boundary/Boundary.h"
+#include "../fluid/ParticleStorage.h"
+#include "RigidBody.h"
+
+namespace unreal_fluid::physics::rigid {
+  struct RigidParameters {
+    int iterations = 10;           // velocity iterations of the contact solver
+    double baumgarte = 0.2;        // part of penetration removed per step
+    double slop = 0.005;           // penetration left alone, keeps resting contacts from jittering
+    double margin = 0.01;          // gap at which contacts appear, keeps resting contacts alive between steps
+    double bounceSpeed = 1;        // slower hits do not bounce
+    double sleepSpeed = 0.05;      // linear and angular speed below which bodies may sleep
+    double sleepDelay = 0.5;       // time a whole island has to stay slow before it sleeps
+  };
+
+  /// @brief Rigid spheres and boxes colliding with each other and with static walls.
+  /// @details A step integrates velocities, finds contacts, splits awake bodies into islands
+  /// of bodies touching each other, solves contacts of every island with sequential impulses
+  /// and integrates positions. Islands do not share dynamic bodies, so they are solved by
+  /// different threads; static bodies are shared but never written.
+  ///
+  /// Contacts appear a little before bodies touch and only stop the part of the approach that
+  /// would close the gap, so a resting body does not lose its contact every few steps.
+  ///
+  /// Contacts found again in the next step start from their last impulses (warm starting), so stacks
+  /// come to rest in a few iterations instead of jittering.
+  ///
+  /// Contacts also resist rolling and spinning with a torque bounded by rolling friction times
+  /// normal impulse, otherwise balls would never stop rolling and could not sleep.
+  ///
+  /// Candidate pairs come from sweep and prune over boxes of bodies. Spheres collide exactly,
+  /// boxes collide through their corners, so an edge crossing another edge is missed.
+  ///
+  /// Fluids push bodies through collideParticles(): impulses of particles are summed per thread and
+  /// per body and applied at the start of the next step, they wake a sleeping body when they would move it.
+  /// Every particle bounces as if it hit the body alone, so the sum is scaled as if all particles of
+  /// the step hit it as one lump, otherwise a light body would take many times their momentum.
+  ///
+  /// An island sleeps when all its bodies stayed slow for sleepDelay: sleeping bodies are not
+  /// integrated, pairs of sleeping bodies are not tested and awake bodies lean on sleeping ones as
+  /// on static bodies. A sleeping body wakes when a body faster than sleepSpeed comes close, so slow
+  /// settling of one island does not keep waking its neighbours. When nothing is awake a step returns at once.
+  class RigidBodyWorld : public IPhysicalObject {
+  public:
+    struct Statistics {
+      size_t awakeBodies = 0;
+      size_t contacts = 0;
+      size_t islands = 0;
+    };
+
+    static constexpr uint32_t noBody = std::numeric_limits<uint32_t>::max();
+
+  private:
+    /// @brief contact point of two bodies or a body and a wall, normal points from b to a
+    struct Contact {
+      uint32_t a, b;   // b is noBody for walls
+      uint32_t feature; // tells contacts of the same pair apart, the same contact keeps it between steps
+      vec3 point;
+      vec3 normal;
+      double depth;
+
+      vec3 ra, rb;     // from centres of bodies to the point
+      vec3 tangents[2];
+      double normalMass, tangentMass[2];
+      mat3 rollingMass; // inverse of summed inverse inertias
+      double bias;
+      double normalImpulse, tangentImpulse[2];
+      vec3 rollingImpulse;
+    };
+
+    std::vector<RigidBody> bodies;
+    RigidParameters parameters;
+    boundary::Boundary walls;
+    utils::ThreadPool threadPool;
+    Statistics statistics;
+
+    std::vector<double> inverseMasses; // zero for static and sleeping bodies
+    std::vector<mat3> inverseInertias; // world space, zero for static and sleeping bodies
+    std::vector<solid::Aabb> bounds;
+    std::vector<uint32_t> order;       // bodies sorted by bounds.min.x
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    std::vector<Contact> contacts;
+    std::vector<Contact> previousContacts; // sorted by bodies and feature, impulses warm start the next step
+
+    std::vector<RigidBody::Impulse> impulses;       // from outside the world, applied at the start of the next step
+    std::vector<RigidBody::Impulse> threadImpulses; // one slot per thread while particles are collided
+    std::vector<size_t> threadContacts;
+    static constexpr size_t minParallelParticles = 256; // fewer particles are collided by the calling thread
+
+    std::vector<uint32_t> parents;       // union-find forest of islands
+    std::vector<uint32_t> islandOf;      // island of a root body
+    std::vector<uint32_t> islandStarts;  // islandBodies and islandContacts of island i start at starts[i]
+    std::vector<uint32_t> contactStarts;
+    std::vector<uint32_t> islandBodies;
+    std::vector<uint32_t> islandContacts;
+
+  public:
+    explicit RigidBodyWorld(RigidParameters parameters = {});
+    ~RigidBodyWorld() override = default;
+
+    IPhysicalObject::Type getType() override;
+
+    /// @brief adds body and returns its index, indices do not change
+    size_t addBody(const RigidBody &body);
+
+    [[nodiscard]] RigidBody &getBody(size_t index) { return bodies[index]; }
+    [[nodiscard]] const std::vector<RigidBody> &getBodies() const { return bodies; }
+
+    /// @brief returns static walls bodies collide with
+    boundary::Boundary &getWalls() { return walls; }
+
+    /// @brief sets amount of threads, 0 means all hardware threads
+    void setThreadsCount(unsigned threadsCount);
+
+    /// @brief collides particles with a body and keeps the impulses they give to it for the next step
+    /// @details Particles are split between threads, every thread sums impulses into its own slot and
+    /// the slots are added up once per call, so a contact takes no lock. A few hundred particles take
+    /// less time than waking threads, so smaller calls run on the calling thread. Indices must not repeat,
+    /// as in the result of a broad phase query.
+    /// @param k coefficient of restitution
+    /// @return amount of particles which touched the body
+    size_t collideParticles(size_t body, fluid::ParticleStorage &particles, const uint32_t *indices, size_t count, double k);
+
+    /// @brief returns counters of the last step
+    [[nodiscard]] const Statistics &getStatistics() const { return statistics; }
+
+  private:
+    void simulate(double dt) override;
+
+    /// @brief adds impulses given from outside to velocities, wakes sleeping bodies they move
+    void applyImpulses();
+
+    /// @brief fills pairs of bodies whose boxes overlap and one of which is awake
+    void findPairs();
+
+    /// @brief wakes sleeping bodies paired with fast ones
+    /// @return true if any body woke
+    bool wakeTouched();
+
+    /// @brief fills contacts of pairs and of awake bodies with walls
+    void findContacts();
+
+    /// @brief groups awake bodies and their contacts into islands
+    void buildIslands();
+
+    /// @brief computes masses and biases of contacts and applies impulses of the same contacts in the last step
+    void prepareContacts(double dt);
+
+    /// @brief keeps impulses of contacts for the next step
+    void storeContacts();
+
+    /// @brief runs sequential impulses over contacts of one island
+    void solveIsland(size_t island);
+
+    /// @brief puts islands which stayed slow to sleep
+    void updateSleeping(double dt);
+
+    /// @brief adds contacts of two bodies
+    void collide(uint32_t a, uint32_t b);
+
+    /// @brief adds contacts of a body with walls
+    void collideWithWalls(uint32_t a);
+
+    /// @brief adds contacts of a point or a sphere around it with walls
+    void collideWithWalls(uint32_t a, const vec3 &point, double radius, uint32_t feature);
+
+    /// @brief adds contacts of corners of box a inside box b
+    void collideCorners(uint32_t a, uint32_t b);
+
+    /// @brief adds contact of sphere a with box b
+    void collideSphereWithBox(uint32_t sphere, uint32_t box);
+
+    void addContact(uint32_t a, uint32_t b, uint32_t feature, const vec3 &point, const vec3 &normal, double depth);
+
+    uint32_t findRoot(uint32_t body);
+
+    [[nodiscard]] bool isAwake(uint32_t body) const { return !bodies[body].isStatic && !bodies[body].asleep; }
+  };
+} // namespace unreal_fluid::physics::rigid
+
+// end of RigidBodyWorld.h
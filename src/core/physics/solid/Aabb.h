@@ -0,0 +1,59 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : Aabb.h
+ * PURPOSE   : axis aligned bounding box
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <limits>
+
+#include "../../../Definitions.h"
+
+namespace unreal_fluid::physics::solid {
+  /// @brief Axis aligned box in world coordinates.
+  /// @details Default box is empty: it contains no points and grows to the first added one.
+  struct Aabb {
+    vec3 min = vec3(1, 1, 1) * std::numeric_limits<double>::infinity();
+    vec3 max = vec3(1, 1, 1) * -std::numeric_limits<double>::infinity();
+
+    Aabb() = default;
+    Aabb(vec3 min, vec3 max) : min(min), max(max) {}
+
+    /// @brief grows box to contain the point
+    void add(const vec3 &point) {
+      min = vec3::min(min, point);
+      max = vec3::max(max, point);
+    }
+
+    /// @brief grows box to contain another box
+    void add(const Aabb &box) {
+      min = vec3::min(min, box.min);
+      max = vec3::max(max, box.max);
+    }
+
+    /// @brief moves every face of the box outwards by margin
+    void inflate(double margin) {
+      min -= vec3(margin, margin, margin);
+      max += vec3(margin, margin, margin);
+    }
+
+    [[nodiscard]] bool empty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+    [[nodiscard]] bool overlaps(const Aabb &box) const {
+      return min.x <= box.max.x && box.min.x <= max.x &&
+             min.y <= box.max.y && box.min.y <= max.y &&
+             min.z <= box.max.z && box.min.z <= max.z;
+    }
+  };
+} // namespace unreal_fluid::physics::solid
+
+// end of Aabb.h
@@ -0,0 +1,32 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : ISolid.cxx
+ * PURPOSE   : kinematic solid
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "ISolid.h"
+
+using namespace unreal_fluid::physics::solid;
+
+void ISolid::simulate(double dt) {
+  previousPosition = position;
+  time += dt;
+
+  if (!trajectory) {
+    position += velocity * dt;
+    return;
+  }
+
+  position = trajectory(time);
+  if (dt > 0) velocity = (position - previousPosition) / dt;
+}
+
+// end of ISolid.cxx
@@ -15,15 +15,50 @@
 
 #pragma once
 
+#include <functional>
+
 #include "../IPhysicalObject.h"
+#include "Aabb.h"
 
 namespace unreal_fluid::physics::solid {
+  /// @brief Kinematic solid.
+  /// @details Solids are not pushed by fluids, they are moved by their velocity or follow a
+  /// trajectory given as position over time. Every step remembers where the solid started,
+  /// so collisions may sweep it along the path it went through instead of testing only the end
+  /// of the step, fast solids do not pass through particles then.
   class ISolid : public IPhysicalObject {
   public:
+    using Trajectory = std::function<vec3(double time)>;
+
     vec3 position{};
+    vec3 velocity{}; // moves the solid if there is no trajectory, set from the trajectory otherwise
+
+  protected:
+    vec3 previousPosition{}; // position at the start of the last step
+    double time = 0;
+    Trajectory trajectory;
 
+  public:
     ISolid() = default;
-    explicit ISolid(vec3 position) : position(position) {}
+    explicit ISolid(vec3 position) : position(position), previousPosition(position) {}
+
+    /// @brief returns box around the solid and the path it went through during the last step,
+    /// used to find particles which may touch it
+    [[nodiscard]] virtual Aabb getBounds() const = 0;
+
+    /// @brief makes solid follow trajectory(time), time counts from zero with simulated steps
+    /// @details empty trajectory leaves the solid moving with its velocity
+    void setTrajectory(Trajectory path) { trajectory = std::move(path); }
+
+    /// @brief returns position at the start of the last step
+    [[nodiscard]] const vec3 &getPreviousPosition() const { return previousPosition; }
+
+    /// @brief returns time the solid was simulated for
+    [[nodiscard]] double getTime() const { return time; }
+
+  private:
+    /// @brief moves solid to the end of the step
+    void simulate(double dt) override;
   };
 } // namespace unreal_fluid::physics::solid
 
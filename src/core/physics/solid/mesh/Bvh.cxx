@@ -0,0 +1,132 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : Bvh.cxx
+ * PURPOSE   : bounding volume hierarchy over triangles of a static mesh
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "Bvh.h"
+
+#include <algorithm>
+
+using namespace unreal_fluid::physics::solid;
+
+namespace {
+  /// @brief returns half of surface area of the box, zero for empty boxes
+  double halfArea(const Aabb &box) {
+    if (box.empty()) return 0;
+    vec3 size = box.max - box.min;
+    return size.x * size.y + size.y * size.z + size.z * size.x;
+  }
+} // namespace
+
+void Bvh::build(const std::vector<Triangle> &triangles) {
+  nodes.clear();
+  boxes.clear();
+  indices.resize(triangles.size());
+  if (triangles.empty()) return;
+
+  std::vector<Aabb> triangleBoxes(triangles.size());
+  std::vector<vec3> centroids(triangles.size());
+  for (uint32_t index = 0; index < triangles.size(); ++index) {
+    const Triangle &triangle = triangles[index];
+    triangleBoxes[index].add(vec3(triangle.v1));
+    triangleBoxes[index].add(vec3(triangle.v2));
+    triangleBoxes[index].add(vec3(triangle.v3));
+    centroids[index] = (triangleBoxes[index].min + triangleBoxes[index].max) / 2.0;
+    indices[index] = index;
+  }
+
+  /* a binary tree with leaves of at least one triangle has less than 2n nodes */
+  nodes.reserve(2 * triangles.size());
+  nodes.push_back({});
+  split(0, 0, static_cast<uint32_t>(triangles.size()), 1, triangleBoxes, centroids);
+
+  boxes.resize(triangles.size());
+  for (size_t index = 0; index < indices.size(); ++index)
+    boxes[index] = triangleBoxes[indices[index]];
+}
+
+void Bvh::split(uint32_t node, uint32_t begin, uint32_t end, int depth,
+                const std::vector<Aabb> &triangleBoxes, const std::vector<vec3> &centroids) {
+  Aabb bounds, centroidBounds;
+  for (uint32_t index = begin; index < end; ++index) {
+    bounds.add(triangleBoxes[indices[index]]);
+    centroidBounds.add(centroids[indices[index]]);
+  }
+
+  nodes[node] = {bounds, begin, end - begin};
+  if (end - begin <= maxLeafSize || depth >= maxDepth - 1) return;
+
+  vec3 extent = centroidBounds.max - centroidBounds.min;
+  int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+  double low = axis == 0 ? centroidBounds.min.x : axis == 1 ? centroidBounds.min.y : centroidBounds.min.z;
+  double size = axis == 0 ? extent.x : axis == 1 ? extent.y : extent.z;
+  if (size <= 0) return; // all centroids coincide, no split separates them
+
+  auto binOf = [&](uint32_t triangle) {
+    const vec3 &centroid = centroids[triangle];
+    double coordinate = axis == 0 ? centroid.x : axis == 1 ? centroid.y : centroid.z;
+    return std::min(binsCount - 1, int((coordinate - low) / size * binsCount));
+  };
+
+  Aabb binBounds[binsCount];
+  uint32_t binCounts[binsCount] = {};
+  for (uint32_t index = begin; index < end; ++index) {
+    int bin = binOf(indices[index]);
+    binBounds[bin].add(triangleBoxes[indices[index]]);
+    binCounts[bin]++;
+  }
+
+  /* costs of left sides are swept forwards, right sides backwards */
+  double rightCosts[binsCount] = {};
+  Aabb right;
+  uint32_t rightCount = 0;
+  for (int bin = binsCount - 1; bin > 0; --bin) {
+    right.add(binBounds[bin]);
+    rightCount += binCounts[bin];
+    rightCosts[bin] = halfArea(right) * rightCount;
+  }
+
+  double bestCost = halfArea(bounds) * (end - begin); // cost of keeping the leaf
+  int bestSplit = -1;
+  Aabb left;
+  uint32_t leftCount = 0;
+  for (int bin = 1; bin < binsCount; ++bin) {
+    left.add(binBounds[bin - 1]);
+    leftCount += binCounts[bin - 1];
+    if (leftCount == 0 || leftCount == end - begin) continue;
+
+    double cost = halfArea(bounds) + halfArea(left) * leftCount + rightCosts[bin];
+    if (cost < bestCost) bestCost = cost, bestSplit = bin;
+  }
+
+  if (bestSplit < 0) return;
+
+  uint32_t *middle = std::partition(indices.data() + begin, indices.data() + end,
+                                    [&](uint32_t triangle) { return binOf(triangle) < bestSplit; });
+  auto half = static_cast<uint32_t>(middle - indices.data());
+
+  auto children = static_cast<uint32_t>(nodes.size());
+  nodes.push_back({});
+  nodes.push_back({});
+  nodes[node].first = children;
+  nodes[node].count = 0;
+
+  split(children, begin, half, depth + 1, triangleBoxes, centroids);
+  split(children + 1, half, end, depth + 1, triangleBoxes, centroids);
+}
+
+void Bvh::query(const Aabb &box, std::vector<uint32_t> &result) const {
+  result.clear();
+  forEachTriangleInBox(box, [&](uint32_t triangle) { result.push_back(triangle); });
+}
+
+// end of Bvh.cxx
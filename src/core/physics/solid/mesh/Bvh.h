@@ -0,0 +1,89 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : Bvh.h
+ * PURPOSE   : bounding volume hierarchy over triangles of a static mesh
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../Aabb.h"
+#include "Triangle.h"
+
+namespace unreal_fluid::physics::solid {
+  /// @brief Binary tree of boxes over triangles.
+  /// @details Built once, as meshes are static. Every node is split where the surface area
+  /// heuristic is the smallest: triangles are binned by centroids along the longest axis and
+  /// the split between bins with the lowest sum of area times triangles count is taken,
+  /// unless keeping the node as a leaf is cheaper. Nodes are stored in one array, children
+  /// of a node are next to each other, triangles of leaves are contiguous runs of indices.
+  class Bvh {
+  public:
+    struct Node {
+      Aabb bounds;
+      uint32_t first; // first child for inner nodes, first index for leaves
+      uint32_t count; // amount of triangles, zero for inner nodes
+    };
+
+    static constexpr uint32_t maxLeafSize = 4;
+    static constexpr int binsCount = 16;
+    static constexpr int maxDepth = 64;
+
+  private:
+    std::vector<Node> nodes;
+    std::vector<uint32_t> indices; // triangle indices in leaf order
+    std::vector<Aabb> boxes;       // boxes of triangles in leaf order
+
+  public:
+    Bvh() = default;
+    ~Bvh() = default;
+
+    /// @brief builds tree over the triangles, previous tree is dropped
+    void build(const std::vector<Triangle> &triangles);
+
+    /// @brief calls callback(triangle) for every triangle whose box overlaps the given one
+    template<typename Callback>
+    void forEachTriangleInBox(const Aabb &box, Callback &&callback) const {
+      if (nodes.empty()) return;
+
+      uint32_t stack[maxDepth];
+      int size = 0;
+      stack[size++] = 0;
+
+      while (size > 0) {
+        const Node &node = nodes[stack[--size]];
+        if (!node.bounds.overlaps(box)) continue;
+
+        if (node.count > 0) {
+          for (uint32_t index = node.first; index < node.first + node.count; ++index)
+            if (boxes[index].overlaps(box)) callback(indices[index]);
+        } else {
+          stack[size++] = node.first;
+          stack[size++] = node.first + 1;
+        }
+      }
+    }
+
+    /// @brief replaces result with triangles whose box overlaps the given one
+    void query(const Aabb &box, std::vector<uint32_t> &result) const;
+
+    [[nodiscard]] const std::vector<Node> &getNodes() const { return nodes; }
+
+  private:
+    /// @brief splits node over indices[begin, end) and builds its subtree
+    void split(uint32_t node, uint32_t begin, uint32_t end, int depth,
+               const std::vector<Aabb> &triangleBoxes, const std::vector<vec3> &centroids);
+  };
+} // namespace unreal_fluid::physics::solid
+
+// end of Bvh.h
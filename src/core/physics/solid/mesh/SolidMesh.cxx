@@ -14,16 +14,85 @@
 
 #include "SolidMesh.h"
 
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
 using namespace unreal_fluid::physics::solid;
 
-SolidMesh::SolidMesh(const std::vector<Triangle> &triangles) : triangles(triangles) {}
+SolidMesh::SolidMesh(const std::vector<Triangle> &triangles) : triangles(triangles) {
+  build();
+}
 
-unreal_fluid::physics::IPhysicalObject::Type SolidMesh::getType() {
-  return Type::SOLID_MESH;
+SolidMesh::SolidMesh(std::string_view path, vec3 position, double scale) : ISolid(position) {
+  std::ifstream file(std::string(path).c_str());
+  if (!file.is_open()) {
+    Logger::logError("Can't open file", path);
+    return;
+  }
+
+  std::vector<vec3f> vertices;
+  std::vector<int> face;
+  std::string line;
+  int lineNumber = 0, firstBrokenLine = 0, brokenFaces = 0;
+
+  while (std::getline(file, line)) {
+    lineNumber++;
+    std::stringstream lineStream(line);
+    std::string lineType;
+    lineStream >> lineType;
+
+    if (lineType == "v") {
+      double x = 0, y = 0, z = 0;
+      lineStream >> x >> y >> z;
+      vertices.emplace_back(vec3(x, y, z) * scale + position);
+    } else if (lineType == "f") {
+      /* only position index of "v/vt/vn" is needed, negative indices count from the end,
+       * faces with indices which are not numbers or point past the vertices read so far are skipped */
+      face.clear();
+      bool broken = false;
+      std::string vertex;
+      while (lineStream >> vertex) {
+        char *end = nullptr;
+        long index = std::strtol(vertex.c_str(), &end, 10);
+        long resolved = index < 0 ? long(vertices.size()) + index : index - 1;
+        if (end == vertex.c_str() || (*end != '\0' && *end != '/') || resolved < 0 || resolved >= long(vertices.size())) {
+          broken = true;
+          break;
+        }
+        face.push_back(int(resolved));
+      }
+
+      if (broken) {
+        if (brokenFaces++ == 0) firstBrokenLine = lineNumber;
+        continue;
+      }
+
+      for (size_t corner = 2; corner < face.size(); ++corner)
+        triangles.emplace_back(vertices[face[0]], vertices[face[corner - 1]], vertices[face[corner]]);
+    }
+  }
+
+  if (brokenFaces > 0)
+    Logger::logError("Skipped", brokenFaces, "faces with broken vertex indices in file", path, "first at line", firstBrokenLine);
+
+  build();
+}
+
+void SolidMesh::build() {
+  bounds = {};
+  for (const auto &triangle: triangles) {
+    bounds.add(vec3(triangle.v1));
+    bounds.add(vec3(triangle.v2));
+    bounds.add(vec3(triangle.v3));
+  }
+
+  bvh.build(triangles);
 }
 
-void *SolidMesh::getData() {
-  return &triangles;
+unreal_fluid::physics::IPhysicalObject::Type SolidMesh::getType() {
+  return Type::SOLID_MESH;
 }
 
 // end of SolidMesh.cxx
@@ -14,8 +14,12 @@
 
 #pragma once
 
+#include <memory>
+#include <string_view>
 #include <vector>
+#include "../../boundary/SdfGrid.h"
 #include "../ISolid.h"
+#include "Bvh.h"
 #include "Triangle.h"
 
 namespace unreal_fluid::physics::solid {
@@ -23,15 +27,42 @@ namespace unreal_fluid::physics::solid {
 
   private:
     std::vector<Triangle> triangles;
+    Aabb bounds;
+    Bvh bvh; // built once, the mesh never moves
+    std::unique_ptr<boundary::SdfGrid> sdf;
 
   public:
     explicit SolidMesh(const std::vector<Triangle> &triangles);
 
+    /// Load mesh from file.
+    /// @param path path to file
+    /// @param position offset added to every vertex
+    /// @param scale factor every vertex is multiplied by before the offset
+    /// @attention Only .obj files are supported, polygons are split into triangle fans.
+    explicit SolidMesh(std::string_view path, vec3 position = {0, 0, 0}, double scale = 1);
+
+    [[nodiscard]] const std::vector<Triangle> &getTriangles() const { return triangles; }
+
+    [[nodiscard]] const Bvh &getBvh() const { return bvh; }
+
+    /// @brief sets distance grid baked from this mesh, particles collide with it instead of triangles
+    /// @details see boundary::MeshSdfBaker, nullptr returns to triangles
+    void setSdf(std::unique_ptr<boundary::SdfGrid> grid) { sdf = std::move(grid); }
+
+    /// @brief returns baked distance grid, nullptr if there is none
+    [[nodiscard]] const boundary::SdfGrid *getSdf() const { return sdf.get(); }
+
+    [[nodiscard]] Aabb getBounds() const override { return bounds; }
+
+    /// @brief meshes stay where they were built, their tree and distance grid are in world coordinates
     void simulate(double dt) override {
             // There is no need to simulate static objects
     }; // static class
     Type getType() override;
-    void *getData() override;
+
+  private:
+    /// @brief computes bounds and builds the tree over triangles
+    void build();
   };
 } // namespace unreal_fluid::physics::solid
 
@@ -26,6 +26,37 @@ namespace unreal_fluid::physics::solid {
                                              v3(v3) {}
 
     ~Triangle() = default;
+
+    /// @brief returns point of the triangle closest to the given one
+    /// @details picks the Voronoi region of the point: a vertex, an edge or the face
+    [[nodiscard]] vec3 closestPoint(const vec3 &point) const {
+      vec3 a = vec3(v1), b = vec3(v2), c = vec3(v3);
+      vec3 ab = b - a, ac = c - a, ap = point - a;
+
+      double d1 = ab.dot(ap), d2 = ac.dot(ap);
+      if (d1 <= 0 && d2 <= 0) return a;
+
+      vec3 bp = point - b;
+      double d3 = ab.dot(bp), d4 = ac.dot(bp);
+      if (d3 >= 0 && d4 <= d3) return b;
+
+      double vc = d1 * d4 - d3 * d2;
+      if (vc <= 0 && d1 >= 0 && d3 <= 0) return a + ab * (d1 / (d1 - d3));
+
+      vec3 cp = point - c;
+      double d5 = ab.dot(cp), d6 = ac.dot(cp);
+      if (d6 >= 0 && d5 <= d6) return c;
+
+      double vb = d5 * d2 - d1 * d6;
+      if (vb <= 0 && d2 >= 0 && d6 <= 0) return a + ac * (d2 / (d2 - d6));
+
+      double va = d3 * d6 - d5 * d4;
+      if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+      double denominator = va + vb + vc;
+      if (denominator == 0) return a; // degenerate triangle
+      return a + ab * (vb / denominator) + ac * (vc / denominator);
+    }
   };
 } // namespace unreal_fluid::physics::solid
 
@@ -19,12 +19,15 @@ using namespace unreal_fluid::physics::solid;
 SolidSphere::SolidSphere(vec3 position, double radius) : ISolid(position),
                                                          radius(radius) {}
 
-unreal_fluid::physics::IPhysicalObject::Type SolidSphere::getType() {
-  return Type::SOLID_SPHERE;
+Aabb SolidSphere::getBounds() const {
+  vec3 extent = vec3(1, 1, 1) * radius;
+  Aabb bounds(position - extent, position + extent);
+  bounds.add(Aabb(previousPosition - extent, previousPosition + extent));
+  return bounds;
 }
 
-void *SolidSphere::getData() {
-  return this;
+unreal_fluid::physics::IPhysicalObject::Type SolidSphere::getType() {
+  return Type::SOLID_SPHERE;
 }
 
 // end of SolidSphere.cxx
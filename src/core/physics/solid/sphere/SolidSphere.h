@@ -18,23 +18,16 @@
 
 namespace unreal_fluid::physics::solid {
   class SolidSphere : public ISolid {
-
-  private:
-    void simulate(double dt) override{
-      // Static object, no simulation needed
-    };
-
   public:
     double radius;
 
     SolidSphere(vec3 position, double radius);
 
+    [[nodiscard]] Aabb getBounds() const override;
+
     /// Get type of object
     /// @return type of object
     Type getType() override;
-    /// Get data stored in a physical container
-    /// @return data stored in a physical container
-    void *getData() override;
   };
 } // namespace unreal_fluid::physics::solid
 
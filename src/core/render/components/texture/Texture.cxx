@@ -76,6 +76,8 @@ void unreal_fluid::render::Texture::_initTexture(int width, int height, int dept
   glTexParameteri(_dimensions, GL_TEXTURE_MAG_FILTER, GL_LINEAR); /// TODO: add option to change this
   glTexParameteri(_dimensions, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(_dimensions, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  if (_dimensions == GL_TEXTURE_3D)
+    glTexParameteri(_dimensions, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 }
 
 unreal_fluid::render::Texture::Texture(std::size_t components, std::size_t componentSize) {
@@ -162,7 +164,10 @@ void unreal_fluid::render::Texture::write(const void *data, int xOffset, int yOf
                         _format, _type, data);
 //  else
 //    assert(false);
-  glGenerateMipmap(_dimensions);
+
+  /* volumes are rewritten every frame and sampled without mipmaps, rebuilding them would cost more than the upload */
+  if (_dimensions != GL_TEXTURE_3D)
+    glGenerateMipmap(_dimensions);
 }
 
 void unreal_fluid::render::Texture::setPixel(const void *data, int x, int y) {
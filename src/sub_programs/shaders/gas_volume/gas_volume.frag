@@ -0,0 +1,76 @@
+#version 330 core
+
+in vec3 vertexPosition;
+in vec3 realVertexPosition;
+in vec3 vertexNormal;
+in vec3 boxPosition;
+
+uniform mat4 modelMatrix;
+
+uniform struct Camera {
+    vec3 position;
+    vec3 direction;
+    vec3 up;
+} camera;
+
+uniform sampler3D tex0; // colour of gas
+uniform sampler3D tex1; // amount of gas
+
+layout(location = 0) out vec4 colorTexture;
+layout(location = 1) out vec4 positionTexture;
+layout(location = 2) out vec4 normalTexture;
+
+const float absorption = 60.0; // opacity of a unit of amount over the box
+const int maxSteps = 512;
+
+// box is the unit cube around the origin, its texture coordinates are positions + 0.5
+vec2 intersectBox(vec3 origin, vec3 direction)
+{
+    vec3 reciprocal = 1.0 / direction;
+    vec3 first = (vec3(-0.5) - origin) * reciprocal;
+    vec3 second = (vec3(0.5) - origin) * reciprocal;
+    vec3 entry = min(first, second);
+    vec3 exit = max(first, second);
+
+    return vec2(max(max(entry.x, entry.y), entry.z), min(min(exit.x, exit.y), exit.z));
+}
+
+void main()
+{
+    vec3 origin = (inverse(modelMatrix) * vec4(camera.position, 1.0)).xyz;
+    vec3 direction = normalize(boxPosition - origin);
+    vec2 range = intersectBox(origin, direction);
+
+    // every ray is marched once: from the front face, or from the camera if it is inside the box
+    float fragmentDistance = dot(boxPosition - origin, direction);
+    if (range.x > 0.0 && fragmentDistance > range.x + 1e-4)
+        discard;
+
+    float start = max(range.x, 0.0);
+    vec3 size = vec3(textureSize(tex1, 0));
+    float stepLength = 0.5 / max(max(size.x, size.y), size.z);
+    float stepOpacity = absorption * stepLength;
+
+    vec3 color = vec3(0.0);
+    float alpha = 0.0;
+    for (int i = 0; i < maxSteps; i++)
+    {
+        float travelled = start + (float(i) + 0.5) * stepLength;
+        if (travelled > range.y || alpha > 0.99)
+            break;
+
+        vec3 coordinates = origin + direction * travelled + 0.5;
+        float opacity = 1.0 - exp(-texture(tex1, coordinates).r * stepOpacity);
+
+        // front to back: what is already in front hides the rest
+        color += (1.0 - alpha) * opacity * texture(tex0, coordinates).rgb;
+        alpha += (1.0 - alpha) * opacity;
+    }
+
+    if (alpha < 0.001)
+        discard;
+
+    colorTexture = vec4(color / alpha, alpha);
+    positionTexture = vec4(vertexPosition, 1);
+    normalTexture = vec4(vertexNormal, 1);
+}
@@ -0,0 +1,78 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : CpuFeatures.cxx
+ * PURPOSE   : runtime detection of vector instruction sets
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "CpuFeatures.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(UNREAL_FLUID_X86_64) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+using namespace unreal_fluid::utils;
+
+namespace {
+  std::atomic<CpuFeatures::InstructionSet> limit{CpuFeatures::InstructionSet::AVX512};
+} // namespace
+
+CpuFeatures::InstructionSet CpuFeatures::getInstructionSet() {
+  static const InstructionSet detected = detect();
+  return std::min(detected, limit.load(std::memory_order_relaxed));
+}
+
+void CpuFeatures::limitInstructionSet(InstructionSet newLimit) {
+  limit.store(newLimit, std::memory_order_relaxed);
+}
+
+const char *CpuFeatures::getName(InstructionSet instructionSet) {
+  switch (instructionSet) {
+    case InstructionSet::SCALAR:
+      return "scalar";
+    case InstructionSet::AVX2:
+      return "AVX2";
+    case InstructionSet::AVX512:
+      return "AVX-512";
+  }
+  return "unknown";
+}
+
+CpuFeatures::InstructionSet CpuFeatures::detect() {
+#if defined(UNREAL_FLUID_X86_64) && defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+  bool fma = (info[2] & (1 << 12)) != 0;
+  if (!osSavesAvx) return InstructionSet::SCALAR;
+
+  __cpuidex(info, 7, 0);
+  bool avx2 = (info[1] & (1 << 5)) != 0 && fma;
+  bool avx512 = (info[1] & (1 << 16)) != 0 && (_xgetbv(0) & 0xe6) == 0xe6;
+
+  if (avx512) return InstructionSet::AVX512;
+  if (avx2) return InstructionSet::AVX2;
+  return InstructionSet::SCALAR;
+#elif defined(UNREAL_FLUID_X86_64)
+  /* GCC and Clang also check that OS saves extended registers */
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return InstructionSet::AVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return InstructionSet::AVX2;
+  return InstructionSet::SCALAR;
+#else
+  return InstructionSet::SCALAR;
+#endif
+}
+
+// end of CpuFeatures.cxx
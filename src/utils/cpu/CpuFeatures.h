@@ -0,0 +1,55 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : CpuFeatures.h
+ * PURPOSE   : runtime detection of vector instruction sets
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define UNREAL_FLUID_X86_64
+#endif
+
+/* functions using intrinsics of an extension must be compiled for it with GCC and Clang, MSVC allows them everywhere */
+#if defined(__GNUC__) || defined(__clang__)
+#define UNREAL_FLUID_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define UNREAL_FLUID_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define UNREAL_FLUID_TARGET_AVX2
+#define UNREAL_FLUID_TARGET_AVX512
+#endif
+
+namespace unreal_fluid::utils {
+  class CpuFeatures {
+  public:
+    enum class InstructionSet {
+      SCALAR,
+      AVX2,
+      AVX512,
+    };
+
+    /// @brief returns best instruction set supported by CPU and OS
+    /// @details result is limited by limitInstructionSet()
+    static InstructionSet getInstructionSet();
+
+    /// @brief forbids instruction sets better than given one
+    /// @details used to compare kernels or to work around broken hardware
+    static void limitInstructionSet(InstructionSet limit);
+
+    /// @brief returns name of instruction set
+    static const char *getName(InstructionSet instructionSet);
+
+  private:
+    static InstructionSet detect();
+  };
+} // namespace unreal_fluid::utils
+
+// end of CpuFeatures.h
@@ -0,0 +1,150 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : Matrix3x3.h
+ * PURPOSE   : matrix 3x3 for rotations and inertia tensors
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <cmath>
+
+#include "Vector3.h"
+
+namespace unreal_fluid::math {
+  /// @brief Row-major matrix 3x3 acting on column vectors: v' = M * v.
+  template<typename T>
+  class Matrix3x3 {
+  public:
+    T matrix[3][3];
+
+    Matrix3x3() : matrix{{1, 0, 0},
+                         {0, 1, 0},
+                         {0, 0, 1}} {}
+
+    Matrix3x3(T m00, T m01, T m02,
+              T m10, T m11, T m12,
+              T m20, T m21, T m22) : matrix{{m00, m01, m02},
+                                            {m10, m11, m12},
+                                            {m20, m21, m22}} {}
+
+    ~Matrix3x3() = default;
+
+    T operator()(int row, int column) const { return matrix[row][column]; }
+    T &operator()(int row, int column) { return matrix[row][column]; }
+
+    Matrix3x3 operator*(const Matrix3x3 &m) const {
+      Matrix3x3 result = zero();
+      for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+          for (int k = 0; k < 3; k++)
+            result.matrix[i][j] += matrix[i][k] * m.matrix[k][j];
+      return result;
+    }
+
+    Matrix3x3 operator+(const Matrix3x3 &m) const {
+      Matrix3x3 result = *this;
+      for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+          result.matrix[i][j] += m.matrix[i][j];
+      return result;
+    }
+
+    Vector3<T> operator*(const Vector3<T> &v) const {
+      return Vector3<T>(matrix[0][0] * v.x + matrix[0][1] * v.y + matrix[0][2] * v.z,
+                        matrix[1][0] * v.x + matrix[1][1] * v.y + matrix[1][2] * v.z,
+                        matrix[2][0] * v.x + matrix[2][1] * v.y + matrix[2][2] * v.z);
+    }
+
+    Matrix3x3 operator*(T value) const {
+      Matrix3x3 result = *this;
+      for (auto &row: result.matrix)
+        for (T &element: row) element *= value;
+      return result;
+    }
+
+    /// @return column with given index, columns of a rotation are the rotated axes
+    [[nodiscard]] Vector3<T> column(int index) const {
+      return Vector3<T>(matrix[0][index], matrix[1][index], matrix[2][index]);
+    }
+
+    [[nodiscard]] Matrix3x3 transposed() const {
+      return Matrix3x3(matrix[0][0], matrix[1][0], matrix[2][0],
+                       matrix[0][1], matrix[1][1], matrix[2][1],
+                       matrix[0][2], matrix[1][2], matrix[2][2]);
+    }
+
+    [[nodiscard]] T determinant() const {
+      return matrix[0][0] * (matrix[1][1] * matrix[2][2] - matrix[1][2] * matrix[2][1]) -
+             matrix[0][1] * (matrix[1][0] * matrix[2][2] - matrix[1][2] * matrix[2][0]) +
+             matrix[0][2] * (matrix[1][0] * matrix[2][1] - matrix[1][1] * matrix[2][0]);
+    }
+
+    /// @return inverse matrix, zero matrix if this one is singular
+    [[nodiscard]] Matrix3x3 inversed() const {
+      T det = determinant();
+      if (det == 0) return zero();
+
+      T inv = 1 / det;
+      return Matrix3x3((matrix[1][1] * matrix[2][2] - matrix[1][2] * matrix[2][1]) * inv,
+                       (matrix[0][2] * matrix[2][1] - matrix[0][1] * matrix[2][2]) * inv,
+                       (matrix[0][1] * matrix[1][2] - matrix[0][2] * matrix[1][1]) * inv,
+                       (matrix[1][2] * matrix[2][0] - matrix[1][0] * matrix[2][2]) * inv,
+                       (matrix[0][0] * matrix[2][2] - matrix[0][2] * matrix[2][0]) * inv,
+                       (matrix[0][2] * matrix[1][0] - matrix[0][0] * matrix[1][2]) * inv,
+                       (matrix[1][0] * matrix[2][1] - matrix[1][1] * matrix[2][0]) * inv,
+                       (matrix[0][1] * matrix[2][0] - matrix[0][0] * matrix[2][1]) * inv,
+                       (matrix[0][0] * matrix[1][1] - matrix[0][1] * matrix[1][0]) * inv);
+    }
+
+    /// @brief makes columns orthonormal again, used against drift of integrated rotations
+    [[nodiscard]] Matrix3x3 orthonormalized() const {
+      Vector3<T> x = column(0);
+      x /= std::sqrt(x.len2());
+      Vector3<T> y = column(1);
+      y -= x * x.dot(y);
+      y /= std::sqrt(y.len2());
+      Vector3<T> z = x.cross(y);
+
+      return Matrix3x3(x.x, y.x, z.x,
+                       x.y, y.y, z.y,
+                       x.z, y.z, z.z);
+    }
+
+    static Matrix3x3 identity() {
+      return Matrix3x3();
+    }
+
+    static Matrix3x3 zero() {
+      return Matrix3x3(0, 0, 0,
+                       0, 0, 0,
+                       0, 0, 0);
+    }
+
+    static Matrix3x3 diagonal(const Vector3<T> &v) {
+      return Matrix3x3(v.x, 0, 0,
+                       0, v.y, 0,
+                       0, 0, v.z);
+    }
+
+    /// @brief rotation by angle around unit axis, counter-clockwise when the axis looks at the viewer
+    static Matrix3x3 rotation(T angle, const Vector3<T> &axis) {
+      T c = std::cos(angle);
+      T s = std::sin(angle);
+      T t = 1 - c;
+
+      return Matrix3x3(t * axis.x * axis.x + c, t * axis.x * axis.y - s * axis.z, t * axis.x * axis.z + s * axis.y,
+                       t * axis.x * axis.y + s * axis.z, t * axis.y * axis.y + c, t * axis.y * axis.z - s * axis.x,
+                       t * axis.x * axis.z - s * axis.y, t * axis.y * axis.z + s * axis.x, t * axis.z * axis.z + c);
+    }
+  };
+} // namespace unreal_fluid::math
+
+// end of Matrix3x3.h
@@ -0,0 +1,104 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : ThreadPool.cxx
+ * PURPOSE   : pool of persistent worker threads
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include "ThreadPool.h"
+
+using namespace unreal_fluid::utils;
+
+ThreadPool::ThreadPool(unsigned threadsCount) {
+  start(threadsCount);
+}
+
+ThreadPool::~ThreadPool() {
+  stop();
+}
+
+void ThreadPool::setThreadsCount(unsigned threadsCount) {
+  if (threadsCount == 0) threadsCount = getHardwareThreadsCount();
+  if (threadsCount == getThreadsCount()) return;
+
+  stop();
+  start(threadsCount);
+}
+
+void ThreadPool::run(const std::function<void(unsigned)> &job) {
+  if (_workers.empty()) {
+    job(0);
+    return;
+  }
+
+  {
+    std::lock_guard lock(_mutex);
+    _job = &job;
+    _running = static_cast<unsigned>(_workers.size());
+    _generation++;
+  }
+  _wakeUp.notify_all();
+
+  job(0);
+
+  std::unique_lock lock(_mutex);
+  _finished.wait(lock, [this] { return _running == 0; });
+  _job = nullptr;
+}
+
+unsigned ThreadPool::getHardwareThreadsCount() {
+  unsigned count = std::thread::hardware_concurrency();
+  return count == 0 ? 1 : count;
+}
+
+void ThreadPool::start(unsigned threadsCount) {
+  if (threadsCount == 0) threadsCount = getHardwareThreadsCount();
+
+  _stop = false;
+  for (unsigned thread = 1; thread < threadsCount; ++thread)
+    _workers.emplace_back(&ThreadPool::work, this, thread, _generation);
+}
+
+void ThreadPool::stop() {
+  {
+    std::lock_guard lock(_mutex);
+    _stop = true;
+  }
+  _wakeUp.notify_all();
+
+  for (auto &worker: _workers)
+    worker.join();
+  _workers.clear();
+}
+
+void ThreadPool::work(unsigned thread, unsigned long long seenGeneration) {
+  while (true) {
+    const std::function<void(unsigned)> *job;
+
+    {
+      std::unique_lock lock(_mutex);
+      _wakeUp.wait(lock, [&] { return _stop || _generation != seenGeneration; });
+      if (_stop) return;
+
+      seenGeneration = _generation;
+      job = _job;
+    }
+
+    (*job)(thread);
+
+    {
+      std::lock_guard lock(_mutex);
+      _running--;
+    }
+    _finished.notify_one();
+  }
+}
+
+// end of ThreadPool.cxx
@@ -0,0 +1,86 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : ThreadPool.h
+ * PURPOSE   : pool of persistent worker threads
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace unreal_fluid::utils {
+  /// @brief Fixed set of worker threads running fork-join jobs.
+  /// @details The calling thread takes part in every job as thread 0. Work is split
+  /// statically, so the same thread always gets the same chunk for the same job size.
+  class ThreadPool {
+  private:
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    std::condition_variable _finished;
+    const std::function<void(unsigned)> *_job = nullptr;
+    unsigned long long _generation = 0;
+    unsigned _running = 0;
+    bool _stop = false;
+
+  public:
+    /// @param threadsCount amount of threads including the calling one, 0 means all hardware threads
+    explicit ThreadPool(unsigned threadsCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// @brief restarts pool with another amount of threads
+    /// @param threadsCount amount of threads including the calling one, 0 means all hardware threads
+    void setThreadsCount(unsigned threadsCount);
+
+    /// @brief returns amount of threads including the calling one
+    [[nodiscard]] unsigned getThreadsCount() const { return static_cast<unsigned>(_workers.size()) + 1; }
+
+    /// @brief runs job(threadIndex) on every thread and waits for all of them
+    void run(const std::function<void(unsigned)> &job);
+
+    /// @brief splits [0, count) into one contiguous chunk per thread
+    /// @param count amount of items
+    /// @param body function called as body(begin, end, threadIndex)
+    template<typename Body>
+    void parallelFor(size_t count, Body &&body) {
+      unsigned threads = getThreadsCount();
+
+      if (threads == 1 || count < 2) {
+        body(size_t(0), count, 0u);
+        return;
+      }
+
+      run([&](unsigned thread) {
+        size_t begin = count * thread / threads;
+        size_t end = count * (thread + 1) / threads;
+        if (begin < end) body(begin, end, thread);
+      });
+    }
+
+    /// @brief returns amount of hardware threads
+    static unsigned getHardwareThreadsCount();
+
+  private:
+    void start(unsigned threadsCount);
+    void stop();
+    void work(unsigned thread, unsigned long long seenGeneration);
+  };
+} // namespace unreal_fluid::utils
+
+// end of ThreadPool.h
@@ -0,0 +1,109 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : MeshSdfBakerTest.cxx
+ * PURPOSE   : checks sign and distance of a baked cube and reading it back from the cache
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+#include "../src/core/physics/boundary/MeshSdfBaker.h"
+
+using namespace unreal_fluid;
+using namespace unreal_fluid::physics;
+
+/// @brief returns closed cube from -half to half with faces pointing out
+static std::vector<solid::Triangle> makeCube(float half) {
+  std::vector<solid::Triangle> triangles;
+
+  /* every face is given by its normal axis and sign, corners go counterclockwise seen from outside */
+  for (int axis = 0; axis < 3; ++axis)
+    for (float sign: {-1.0f, 1.0f}) {
+      int u = (axis + 1) % 3, v = (axis + 2) % 3;
+      vec3f corners[4];
+      const float us[4] = {-1, 1, 1, -1}, vs[4] = {-1, -1, 1, 1};
+
+      for (int corner = 0; corner < 4; ++corner) {
+        float coordinates[3];
+        coordinates[axis] = sign * half;
+        coordinates[u] = us[corner] * half;
+        coordinates[v] = vs[corner] * half * sign;
+        corners[corner] = {coordinates[0], coordinates[1], coordinates[2]};
+      }
+
+      triangles.emplace_back(corners[0], corners[1], corners[2]);
+      triangles.emplace_back(corners[0], corners[2], corners[3]);
+    }
+
+  return triangles;
+}
+
+static bool check(bool condition, const char *what) {
+  if (!condition) Logger::logError("FAILED:", what);
+  return condition;
+}
+
+/// @brief checks distance at a point against the exact one
+/// @param tolerance allowed error in cells
+static bool checkDistance(const boundary::SdfGrid &grid, vec3 point, double expected, double tolerance, const char *what) {
+  double distance = grid.distance(point);
+  bool ok = std::abs(distance - expected) < tolerance * grid.getCellSize();
+  if (!ok) Logger::logError("distance at", point.x, point.y, point.z, "is", distance, "expected", expected);
+  return check(ok, what);
+}
+
+int main() {
+  const double cellSize = 0.05;
+  const int bandCells = 4;
+
+  solid::SolidMesh mesh(makeCube(0.5f));
+  utils::ThreadPool pool;
+  auto grid = boundary::MeshSdfBaker::bake(mesh, cellSize, bandCells, pool);
+
+  bool ok = check(grid->distance({0, 0, 0}) < 0, "centre is inside");
+  ok &= check(grid->distance({2, 0, 0}) > 0, "far point is outside");
+  ok &= checkDistance(*grid, {0.4, 0, 0}, -0.1, 0.1, "point inside near a face");
+  ok &= checkDistance(*grid, {0.1, -0.45, 0.2}, -0.05, 0.1, "point inside near another face");
+  ok &= checkDistance(*grid, {0.6, 0, 0}, 0.1, 0.1, "point outside near a face");
+  ok &= checkDistance(*grid, {0, 0.2, -0.55}, 0.05, 0.1, "point outside near another face");
+
+  /* sweeping is first order, around convex edges and corners it overestimates distances by up to a cell */
+  ok &= checkDistance(*grid, {0.6, 0.6, 0.1}, std::sqrt(2) * 0.1, 0.5, "point outside near an edge");
+  ok &= checkDistance(*grid, {0.6, 0.6, 0.6}, std::sqrt(3) * 0.1, 1, "point outside near a corner");
+  ok &= check(grid->gradient({0.6, 0, 0}).x > 0.9, "gradient points out of the face");
+
+  /* the first load bakes and stores the grid, the second one reads it back */
+  std::filesystem::path cache = std::filesystem::temp_directory_path() / "unreal_fluid_sdf_test";
+  std::filesystem::remove_all(cache);
+
+  auto baked = boundary::MeshSdfBaker::load(mesh, cellSize, bandCells, cache.string(), pool);
+  auto loaded = boundary::MeshSdfBaker::load(mesh, cellSize, bandCells, cache.string(), pool);
+  ok &= check(std::filesystem::exists(cache) && !std::filesystem::is_empty(cache), "grid is stored in the cache");
+
+  bool same = loaded->getSizeX() == grid->getSizeX() && loaded->getSizeY() == grid->getSizeY() && loaded->getSizeZ() == grid->getSizeZ();
+  for (int z = 0; same && z < grid->getSizeZ(); ++z)
+    for (int y = 0; y < grid->getSizeY(); ++y)
+      for (int x = 0; x < grid->getSizeX(); ++x)
+        same &= baked->getValue(x, y, z) == grid->getValue(x, y, z) && loaded->getValue(x, y, z) == grid->getValue(x, y, z);
+  ok &= check(same, "cached grid equals baked one");
+
+  /* grids set to the mesh are used for collisions */
+  mesh.setSdf(std::move(loaded));
+  ok &= check(mesh.getSdf() != nullptr && mesh.getSdf()->distance({0.4, 0, 0}) < 0, "mesh keeps its grid");
+
+  std::filesystem::remove_all(cache);
+
+  if (ok) Logger::logInfo("Mesh distance grid tests passed");
+  return ok ? 0 : 1;
+}
+
+// end of MeshSdfBakerTest.cxx
@@ -0,0 +1,176 @@
+/***************************************************************
+ * Copyright (C) 2023
+ *    HSE SPb (Higher school of economics in Saint-Petersburg).
+ ***************************************************************/
+
+/* PROJECT   : UnrealFluidPhysics
+ * AUTHORS   : Serkov Alexander, Daniil Vikulov, Daniil Martsenyuk, Vasily Lebedev
+ * FILE NAME : VerletListTest.cxx
+ * PURPOSE   : checks that Verlet lists keep every pair closer than sum of radii plus skin
+ *
+ * No part of this file may be changed and used without agreement of
+ * authors of this project.
+ */
+
+#include <random>
+#include <set>
+#include <utility>
+
+#include "../src/core/physics/fluid/VerletList.h"
+
+using namespace unreal_fluid;
+using namespace unreal_fluid::physics;
+using namespace unreal_fluid::physics::fluid;
+
+using PairSet = std::set<std::pair<uint32_t, uint32_t>>;
+
+/// @brief returns all pairs of the list, smaller index first
+static PairSet collectPairs(VerletList &list, utils::ThreadPool &pool) {
+  PairSet pairs;
+  auto add = [&](uint32_t a, uint32_t b) { pairs.insert({std::min(a, b), std::max(a, b)}); };
+
+  list.forEachCellPairsParallel(pool, [&](const uint32_t *first, const uint32_t *second, size_t count, unsigned) {
+    for (size_t pair = 0; pair < count; ++pair) add(first[pair], second[pair]);
+  });
+
+  const PairList &extra = list.getExtraPairs();
+  for (size_t pair = 0; pair < extra.size(); ++pair) add(extra.first[pair], extra.second[pair]);
+
+  return pairs;
+}
+
+/// @brief returns amount of pairs closer than sum of radii plus margin, which are not in the list
+static int countMissingPairs(VerletList &list, const ParticleStorage &particles, double margin, utils::ThreadPool &pool) {
+  PairSet pairs = collectPairs(list, pool);
+
+  int missing = 0;
+  for (uint32_t a = 0; a < particles.size(); ++a)
+    for (uint32_t b = a + 1; b < particles.size(); ++b) {
+      double reach = particles.radii[a] + particles.radii[b] + margin;
+      if ((particles.positions[a] - particles.positions[b]).len2() < reach * reach && pairs.count({a, b}) == 0) missing++;
+    }
+
+  return missing;
+}
+
+/// @brief returns skin of a list with default skin factor
+static double defaultSkin(const ParticleStorage &particles) {
+  double averageRadius = 0;
+  for (double radius: particles.radii) averageRadius += radius;
+  return 2 * averageRadius / double(particles.size());
+}
+
+static bool check(bool condition, const char *what) {
+  if (!condition) Logger::logError("FAILED:", what);
+  return condition;
+}
+
+/// @brief a small particle in the skin of a big one is listed and found when they touch later
+static bool testBigParticleReach(utils::ThreadPool &pool) {
+  ParticleStorage particles;
+  for (int x = 0; x < 10; ++x)
+    for (int y = 0; y < 10; ++y)
+      for (int z = 0; z < 10; ++z)
+        particles.add(vec3(x + 5, y, z) * 0.5, {0, 0, 0}, 0.1, 1);
+
+  size_t big = particles.add({0.12, 0, 0}, {0, 0, 0}, 1, 1);
+  size_t small = particles.add({1.4, 0, 0}, {0, 0, 0}, 0.1, 1);
+  double skin = defaultSkin(particles);
+
+  VerletList list;
+  list.update(particles, pool);
+  bool ok = check(countMissingPairs(list, particles, skin, pool) == 0, "pairs within skin of a big particle are listed");
+
+  /* both move less than half of skin towards each other, so the list is reused */
+  particles.positions[big].x += real(0.45 * skin);
+  particles.positions[small].x -= real(0.45 * skin);
+  ok &= check(!list.update(particles, pool), "list is reused");
+  ok &= check((particles.positions[big] - particles.positions[small]).len() < 1.1, "particles touch");
+  ok &= check(countMissingPairs(list, particles, 0, pool) == 0, "touching pairs are listed");
+  return ok;
+}
+
+/// @brief particles of very different radii, medium ones are farther apart than one cell of the default grid
+static bool testMixedRadii(utils::ThreadPool &pool) {
+  std::mt19937 random(7);
+  std::uniform_real_distribution<double> coordinate(0, 6);
+  const double radii[] = {0.05, 0.05, 0.05, 0.1, 0.2, 0.35, 0.8};
+
+  ParticleStorage particles;
+  for (int particle = 0; particle < 3000; ++particle)
+    particles.add({coordinate(random), coordinate(random), coordinate(random)}, {0, 0, 0}, radii[particle % 7], 1);
+
+  VerletList list;
+  list.update(particles, pool);
+  return check(countMissingPairs(list, particles, defaultSkin(particles), pool) == 0, "pairs of mixed radii are listed");
+}
+
+/// @brief particles appended after the build find their pairs in the grid of the build
+static bool testNewParticles(utils::ThreadPool &pool) {
+  std::mt19937 random(11);
+  std::uniform_real_distribution<double> coordinate(0, 6);
+  const double radii[] = {0.05, 0.1, 0.2, 0.6};
+
+  ParticleStorage particles;
+  for (int particle = 0; particle < 2000; ++particle)
+    particles.add({coordinate(random), coordinate(random), coordinate(random)}, {0, 0, 0}, radii[particle % 4], 1);
+  double skin = defaultSkin(particles);
+
+  VerletList list;
+  list.update(particles, pool);
+
+  /* new particles, some bigger than all particles of the grid */
+  const double newRadii[] = {0.05, 0.1, 0.3, 1.2};
+  for (int particle = 0; particle < 100; ++particle)
+    particles.add({coordinate(random), coordinate(random), coordinate(random)}, {0, 0, 0}, newRadii[particle % 4], 1);
+
+  /* old particles drift by less than half of skin */
+  std::uniform_real_distribution<double> drift(-0.28 * skin, 0.28 * skin);
+  for (size_t particle = 0; particle < 2000; ++particle)
+    particles.positions[particle] += vec3r(real(drift(random)), real(drift(random)), real(drift(random)));
+
+  bool ok = check(!list.update(particles, pool), "list is reused after spawning");
+  ok &= check(countMissingPairs(list, particles, 0, pool) == 0, "touching pairs with new particles are listed");
+  return ok;
+}
+
+/// @brief a particle spawned next to one which drifted away since the build is listed when they drift together
+static bool testSpawnThenDrift(utils::ThreadPool &pool) {
+  ParticleStorage particles;
+  for (int x = 0; x < 10; ++x)
+    for (int y = 0; y < 10; ++y)
+      for (int z = 0; z < 10; ++z)
+        particles.add(vec3(x + 5, y, z) * 0.5, {0, 0, 0}, 0.1, 1);
+  double skin = defaultSkin(particles);
+
+  VerletList list;
+  list.update(particles, pool);
+
+  /* the first particle drifts away from where the new one appears, farther than sum of radii plus skin from it */
+  size_t old = 0;
+  particles.positions[old].x += real(0.45 * skin);
+  size_t spawned = particles.add(vec3(particles.positions[old]) - vec3(0.2 + 1.2 * skin, 0, 0), {0, 0, 0}, 0.1, 1);
+  bool ok = check(!list.update(particles, pool), "list is reused after spawning");
+
+  /* both stay within half of skin of where the list saw them first, but close by 1.35 of skin */
+  particles.positions[old].x -= real(0.9 * skin);
+  particles.positions[spawned].x += real(0.45 * skin);
+  ok &= check(!list.update(particles, pool), "list is reused after drifting");
+  ok &= check((particles.positions[old] - particles.positions[spawned]).len() < 0.2, "particles touch");
+  ok &= check(countMissingPairs(list, particles, 0, pool) == 0, "spawned particle touching a drifted one is listed");
+  return ok;
+}
+
+int main() {
+  utils::ThreadPool pool;
+
+  bool ok = testBigParticleReach(pool);
+  ok &= testMixedRadii(pool);
+  ok &= testNewParticles(pool);
+  ok &= testSpawnThenDrift(pool);
+
+  if (ok) Logger::logInfo("Verlet list tests passed");
+  return ok ? 0 : 1;
+}
+
+// end of VerletListTest.cxx